@@ -0,0 +1,147 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+/**
+	\example flowRefined.cc
+	Example: Flow around a sphere with a refined block around it
+*/
+
+#include <utilities/aslParametersManager.h>
+#include <aslDataInc.h>
+#include <math/aslTemplates.h>
+#include <aslGeomInc.h>
+#include <acl/aclGenerators.h>
+#include <writers/aslVTKFormatWriters.h>
+#include <num/aslLBGK.h>
+#include <num/aslLBGKBC.h>
+#include <num/aslLBGKMultiBlock.h>
+#include <utilities/aslTimer.h>
+#include <acl/aclUtilities.h>
+
+
+
+typedef float FlT;
+//typedef double FlT;
+typedef asl::UValue<double> Param;
+
+using asl::AVec;
+using asl::makeAVec;
+
+
+int main(int argc, char* argv[])
+{
+	// Optionally add appParamsManager to be able to manipulate at least
+	// hardware parameters(platform/device) through command line/parameters file
+	asl::ApplicationParametersManager appParamsManager("flowRefined",
+	                                                   "1.0");
+	appParamsManager.load(argc, argv);
+
+	Param dx(2.);
+	Param dt(2.);
+	Param nu(.025);
+
+	Param nuNum(nu.v()*dt.v()/dx.v()/dx.v());
+	AVec<int> size(asl::makeAVec(150, 25, 25));
+
+	auto gSize(dx.v()*AVec<>(size));
+
+	
+	std::cout << "Data initialization... ";
+
+	asl::Block block(size,dx.v());
+
+	// the refined block stays clear of the channel walls: its ghost nodes 
+	// are interpolated from the fluid nodes of the coarse block
+	auto ball(generateDFSphere(.125*gSize[1],
+	                           .45*makeAVec(gSize[1],gSize[1],gSize[2])));
+	auto ballMap(asl::generateDataContainer_SP(block, ball, 1u, acl::typeToTypeID<FlT>()));
+	
+	std::cout << "Finished" << endl;
+	
+	std::cout << "Numerics initialization... ";
+
+	asl::SPLBGKMultiBlock lbgk(new asl::LBGKMultiBlock(block,
+	                               acl::generateVEConstant(FlT(nuNum.v())),
+	                               &asl::d3q15()));
+	// the band of one radius on both sides of the sphere surface is resolved with dx/2
+	unsigned int iFine(lbgk->addRefinementBand(ball, .125*gSize[1]));
+	asl::SPLBGK coarse(lbgk->getCoarse());
+	asl::SPLBGK fine(lbgk->getFine(iFine));
+	auto ballMapFine(asl::generateDataContainer_SP(fine->getVelocity()->getInternalBlock(), 
+	                                               ball, 1u, 
+	                                               acl::typeToTypeID<FlT>()));
+
+	lbgk->addCoarseBC(asl::generateBCConstantPressure(coarse, 1.2, {asl::X0}));
+	lbgk->addCoarseBC(asl::generateBCConstantPressure(coarse, 0.8, {asl::XE}));
+	lbgk->addCoarseBC(generateBCNoSlip(coarse, {asl::Y0, asl::YE, asl::Z0, asl::ZE}));
+	lbgk->addCoarseBC(generateBCNoSlip(coarse, ballMap));
+	lbgk->addFineBC(iFine, generateBCNoSlip(fine, ballMapFine));
+	lbgk->init();
+
+	asl::LBGKUtilities(coarse).initF(acl::generateVEConstant(.0,.0,.0));
+	asl::LBGKUtilities(fine).initF(acl::generateVEConstant(.0,.0,.0));
+
+	std::vector<asl::SPNumMethod> bcVis;
+	bcVis.push_back(generateBCNoSlipVel(coarse, ballMap));
+	bcVis.push_back(generateBCNoSlipVel(fine, ballMapFine));
+	initAll(bcVis);
+
+	std::cout << "Finished" << endl;
+	std::cout << "Cell updates per step: " << lbgk->getNUpdates() 
+	          << " (uniform fine grid: " 
+	          << 2 * 8 * productOfElements(size) << ")" << endl;
+	std::cout << "Computing...";
+	asl::Timer timer;
+
+	asl::WriterVTKXML writer("flowRefined");
+	writer.addScalars("rho", *coarse->getRho());
+	writer.addVector("v", *coarse->getVelocity());
+	asl::WriterVTKXML writerFine("flowRefinedFine");
+	writerFine.addScalars("rho", *fine->getRho());
+	writerFine.addVector("v", *fine->getVelocity());
+
+	timer.start();
+	for (unsigned int i(1); i < 501; ++i)
+	{
+		lbgk->execute();
+		if (!(i%100))
+		{
+			cout << i << endl;
+			executeAll(bcVis);
+			writer.write();
+			writerFine.write();
+		}
+	}
+	timer.stop();
+	
+	
+	cout << "Finished" << endl;	
+
+	cout << "Computation statistic:" << endl;
+	cout << "Real Time = " << timer.realTime() << "; Processor Time = "
+		 << timer.processorTime() << "; Processor Load = "
+		 << timer.processorLoad() * 100 << "%" << endl;
+
+	return 0;
+}
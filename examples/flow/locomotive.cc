@@ -168,6 +168,8 @@ int main(int argc, char* argv[])
 
 	// Generate boundary conditions for the locomotive geometry. Non-slip BC
 	bc.push_back(generateBCNoSlip(lbgk,  locomotive));
+	// The BC kernel runs only over the boundary points of the locomotive
+	std::dynamic_pointer_cast<asl::BCondWithMap>(bc.back())->setPointsList();
 	bcV.push_back(generateBCNoSlipVel(lbgk, locomotive));
 	bcV.push_back(generateBCNoSlipRho(lbgk, locomotive));
 
@@ -182,6 +184,7 @@ int main(int argc, char* argv[])
 
 	// Generate a numerical method for computation of the air force field that acts on the locomotive
 	auto computeForce(generateComputeSurfaceForce(lbgk, forceField, locomotive));
+	std::dynamic_pointer_cast<asl::BCondWithMap>(computeForce)->setPointsList();
 	computeForce->init();
 	
 	cout << "Finished" << endl;
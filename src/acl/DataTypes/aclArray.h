@@ -69,7 +69,7 @@ namespace acl
 
 
 	template <typename T> Array<T>::Array(unsigned int size_, T *initArray, CommandQueue queue_):
-		MemBlock(size_, typeToTypeID<T>(), queue_, (char*)initArray)
+		MemBlock(size_, typeToTypeID<T>(), (char*)initArray, queue_)
 	{
 		++id;
 		name = prefix + asl::numToStr(id);
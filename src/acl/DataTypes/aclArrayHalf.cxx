@@ -0,0 +1,183 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include "aclArrayHalf.h"
+#include "../../aslUtilities.h"
+#include <cstring>
+
+namespace acl
+{
+
+	unsigned int ArrayHalf::id(0);
+	const string ArrayHalf::prefix("a_h");
+
+	
+	ArrayHalf::ArrayHalf(unsigned int size_, CommandQueue queue_):
+		MemBlock(size_, TYPE_FLOAT, sizeof(cl_half), queue_)
+	{
+		++id;
+		name = prefix + asl::numToStr(id);
+	}
+
+
+	string ArrayHalf::getName() const
+	{
+		return name;
+	}
+
+
+	// Unaligned vector kernels address the elements by INDEX, 
+	// the others by INDEX in units of the vector width
+	string ArrayHalf::str(const KernelConfiguration & kernelConfig) const
+	{
+		string width(kernelConfig.vectorWidth > 1 ? numToStr(kernelConfig.vectorWidth) : "");
+		if (kernelConfig.unaligned && kernelConfig.vectorWidth > 1)
+			return "vload_half" + width + "(0, &" + name + "[" + INDEX + "])";
+		else
+			return "vload_half" + width + "(" + INDEX + ", " + name + ")";
+	}
+
+
+	string ArrayHalf::strStore(const string & value, const KernelConfiguration & kernelConfig) const
+	{
+		string width(kernelConfig.vectorWidth > 1 ? numToStr(kernelConfig.vectorWidth) : "");
+		if (kernelConfig.unaligned && kernelConfig.vectorWidth > 1)
+			return "vstore_half" + width + "(" + value + ", 0, &" + name + "[" + INDEX + "])";
+		else
+			return "vstore_half" + width + "(" + value + ", " + INDEX + ", " + name + ")";
+	}
+
+
+	string ArrayHalf::getTypeSignature(const KernelConfiguration & kernelConfig) const
+	{
+		return "__global half *" + name;
+	}
+
+
+	string ArrayHalf::getAddressSpaceQualifier() const
+	{
+		return "__global";
+	}
+	
+
+	string ArrayHalf::getLocalDeclaration(const KernelConfiguration & kernelConfig) const
+	{
+		return "";
+	}
+
+
+	// Must be empty. Only operators can add arguments.
+	void ArrayHalf::addToKernelSource(vector<Element> & arguments, 
+	                                  vector<Element> & localDeclarations) const
+	{
+	}
+
+
+	void ArrayHalf::setAsArgument(cl::Kernel & kernel, unsigned int argumentIndex) const
+	{
+		cl_int status = 0;		
+		status = kernel.setArg(argumentIndex, *buffer);
+		errorMessage(status, "Kernel::setArg() - " + name
+		             + ", argument " + numToStr(argumentIndex));
+	}
+
+
+	unsigned int ArrayHalf::getElementSize() const
+	{
+		return sizeof(cl_half);
+	}
+
+
+	cl_half floatToHalf(cl_float a)
+	{
+		cl_uint x;
+		memcpy(&x, &a, sizeof(x));
+		cl_uint sign((x >> 16) & 0x8000);
+		cl_uint absx(x & 0x7fffffff);
+
+		// infinity and NaN
+		if (absx >= 0x7f800000)
+			return sign | 0x7c00 | (absx > 0x7f800000 ? 0x200 : 0);
+		// values rounded to more than 65504
+		if (absx >= 0x477ff000)
+			return sign | 0x7c00;
+		// subnormal numbers, below 2^-25 rounded to zero
+		if (absx < 0x38800000)
+		{
+			if (absx < 0x33000000)
+				return sign;
+			cl_uint shift(126 - (absx >> 23));
+			cl_uint m((absx & 0x7fffff) | 0x800000);
+			cl_uint h(m >> shift);
+			cl_uint remainder(m & ((1u << shift) - 1));
+			cl_uint halfway(1u << (shift - 1));
+			if (remainder > halfway || (remainder == halfway && (h & 1)))
+				++h;
+			return sign | h;
+		}
+
+		// normal numbers: the exponent bias changes from 127 to 15
+		cl_uint r(absx - 0x38000000);
+		cl_uint h(r >> 13);
+		cl_uint remainder(r & 0x1fff);
+		if (remainder > 0x1000 || (remainder == 0x1000 && (h & 1)))
+			++h;
+		return sign | h;
+	}
+
+
+	cl_float halfToFloat(cl_half a)
+	{
+		cl_uint sign((cl_uint)(a & 0x8000) << 16);
+		cl_uint e((a >> 10) & 0x1f);
+		cl_uint m(a & 0x3ff);
+		cl_uint x;
+
+		if (e == 0x1f)
+			x = sign | 0x7f800000 | (m << 13);
+		else if (e == 0)
+		{
+			if (m == 0)
+				x = sign;
+			else
+			{
+				// subnormal numbers are normalized
+				e = 113;
+				while (!(m & 0x400))
+				{
+					m <<= 1;
+					--e;
+				}
+				x = sign | (e << 23) | ((m & 0x3ff) << 13);
+			}
+		}
+		else
+			x = sign | ((e + 112) << 23) | (m << 13);
+
+		cl_float f;
+		memcpy(&f, &x, sizeof(f));
+		return f;
+	}
+
+} // namespace acl
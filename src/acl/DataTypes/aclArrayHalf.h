@@ -0,0 +1,73 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef ACLARRAYHALF_H
+#define ACLARRAYHALF_H
+
+#include "../aclStdIncludes.h"
+#include "aclMemBlock.h"
+
+using namespace asl;
+
+namespace acl
+{
+
+	/// Global array of floats stored as half precision numbers
+	/**
+		 The values are converted by vload_half/vstore_half on access, the 
+		 computations are done in the precision of the kernel. The array takes 
+		 half of the memory and of the bandwidth of Array<cl_float>; the values 
+		 have 11 significant bits and the range of +-65504.
+		 acl::copy() converts the values from and to the host types.
+	*/
+	class ArrayHalf: public MemBlock
+	{
+		protected:
+			string name;
+			static const string prefix;
+			static unsigned int id;
+		public:
+			explicit ArrayHalf(unsigned int size, CommandQueue queue_ = hardware.defaultQueue);
+			virtual string str(const KernelConfiguration & kernelConfig) const;
+			virtual string strStore(const string & value, const KernelConfiguration & kernelConfig) const;
+			virtual string getName() const;
+			virtual string getAddressSpaceQualifier() const;
+			virtual string getTypeSignature(const KernelConfiguration & kernelConfig) const;
+			virtual string getLocalDeclaration(const KernelConfiguration & kernelConfig) const;
+			virtual void addToKernelSource(vector<Element> & arguments,
+			                               vector<Element> & localDeclarations) const;
+			virtual void setAsArgument(cl::Kernel & kernel, unsigned int argumentIndex) const;
+			virtual unsigned int getElementSize() const;
+	};
+
+	typedef shared_ptr<ArrayHalf> ElementArrayHalf;
+
+	/// Converts \p a into half precision, rounds to the nearest even \relates ArrayHalf
+	cl_half floatToHalf(cl_float a);
+	/// Converts half precision \p a into float \relates ArrayHalf
+	cl_float halfToFloat(cl_half a);
+
+} // namespace acl
+
+#endif // ACLARRAYHALF_H
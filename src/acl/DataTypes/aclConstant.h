@@ -37,6 +37,8 @@ namespace acl
 			string valueStr;
 		public:
 			explicit Constant(T v);
+			/// Returns the value of the constant
+			inline T getValue() const;
 			virtual string str(const KernelConfiguration & kernelConfig) const;
 			virtual string getName() const;
 			virtual string getTypeSignature(const KernelConfiguration & kernelConfig) const;
@@ -49,6 +51,12 @@ namespace acl
 
 
 
+	template <typename T> inline T Constant<T>::getValue() const
+	{
+		return value;
+	}
+
+
 	template <typename T> std::string Constant<T>::getName() const
 	{
 		return valueStr;
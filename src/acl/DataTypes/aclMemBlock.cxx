@@ -22,6 +22,7 @@
 
 
 #include "aclMemBlock.h"
+#include "aclMemoryPool.h"
 #include "../../aslUtilities.h"
 #include "../aclUtilities.h"
 
@@ -31,16 +32,25 @@ using namespace asl;
 namespace acl
 {
 
+	/// source of the AccessEvents stamps
+	static cl_ulong lastStamp(0);
+
+
 	/// class for compatibility with std::shared_ptr enssure correct unmapping \ingroup LDI
 	/// \todo: maybe pass a MemBlock to the constructor instead of a buffer and a queue?
 	template <typename T> class VectorUnmapper
 	{
 			shared_ptr<cl::Buffer> buffer;
 			CommandQueue queue;
+			/// events of the buffer, their stamp is renewed if the mapping allows writes
+			shared_ptr<AccessEvents> accessEvents;
 		public:
-			VectorUnmapper(shared_ptr<cl::Buffer> buffer_, CommandQueue queue_) :
+			VectorUnmapper(shared_ptr<cl::Buffer> buffer_, 
+			               CommandQueue queue_,
+			               shared_ptr<AccessEvents> accessEvents_ = shared_ptr<AccessEvents>()) :
 				buffer(buffer_),
-				queue(queue_)
+				queue(queue_),
+				accessEvents(accessEvents_)
 			{};
 			
 			inline void operator() (T* d) const
@@ -56,49 +66,65 @@ namespace acl
 				status = event.wait();
 				errorMessage(status, "Event::wait() - event");			
 				d = NULL;
+				// the host could have written the content
+				if (accessEvents)
+					accessEvents->stamp = ++lastStamp;
 			}
 	};
 
 
+	AccessEvents::AccessEvents():
+		stamp(++lastStamp)
+	{
+	}
+
+
 	MemBlock::MemBlock():
 		// typeID fictitious
-		ElementBase(true, 0, TYPE_INT)
+		ElementBase(true, 0, TYPE_INT),
+		accessEvents(new AccessEvents()),
+		version(0)
 	{
 	    buffer.reset(new cl::Buffer());
 	}
 
 
 	MemBlock::MemBlock(unsigned int size_, TypeID typeID, CommandQueue queue_):
-		ElementBase(true, size_, typeID)
+		ElementBase(true, size_, typeID),
+		version(0)
 	{
 		queue = queue_;
 
-		cl_int status = 0;
-
-		// allocate value in GPU memory with padding
-	    buffer.reset(new cl::Buffer(getContext(queue),
-	                                CL_MEM_READ_WRITE,
-	                                size * TYPE_SIZE[typeID] + paddingBytes(size, TYPE_SIZE[typeID], queue),
-	                                NULL,
-	                                &status));
-		errorMessage(status, "cl::Buffer()");
+		// the pool adds the padding
+		memoryPool.allocate(size * TYPE_SIZE[typeID], queue, buffer, accessEvents);
 	}
 
 
 	MemBlock::MemBlock(unsigned int size_, TypeID typeID, char *initArray, CommandQueue queue_):
-		ElementBase(true, size_, typeID)
+		ElementBase(true, size_, typeID),
+		version(0)
 	{
 		queue = queue_;
 		
-		cl_int status = 0;
+		// the pool adds the padding
+		memoryPool.allocate(size * TYPE_SIZE[typeID], queue, buffer, accessEvents, initArray);
+	}
+
+
+	MemBlock::MemBlock(unsigned int size_, TypeID typeID, unsigned int elementSize, CommandQueue queue_):
+		ElementBase(true, size_, typeID),
+		version(0)
+	{
+		queue = queue_;
 
-		// allocate value in GPU memory with padding
-	    buffer = shared_ptr<cl::Buffer>(new cl::Buffer(getContext(queue),
-	                                                   CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
-	                                                   size * TYPE_SIZE[typeID] + paddingBytes(size, TYPE_SIZE[typeID], queue),
-	                                                   initArray,
-	                                                   &status));
-		errorMessage(status, "cl::Buffer()");
+		// the pool adds the padding
+		memoryPool.allocate(size * elementSize, queue, buffer, accessEvents);
+	}
+
+
+	unsigned int MemBlock::getElementSize() const
+	{
+		return TYPE_SIZE[typeID];
 	}
 
 
@@ -108,39 +134,157 @@ namespace acl
 	}
 
 
+	void MemBlock::getDependencies(std::vector<cl::Event> & dependencies, bool write) const
+	{
+		if (accessEvents->write() != NULL)
+			dependencies.push_back(accessEvents->write);
+		if (write)
+			dependencies.insert(dependencies.end(),
+			                    accessEvents->reads.begin(),
+			                    accessEvents->reads.end());
+	}
+
+
+	void MemBlock::registerAccess(const cl::Event & event, bool write)
+	{
+		if (write)
+		{
+			accessEvents->write = event;
+			accessEvents->reads.clear();
+			accessEvents->stamp = ++lastStamp;
+		}
+		else
+		{
+			// drop finished reads in order to keep the list short
+			// for elements which are read repeatedly but never written
+			vector<cl::Event> & reads(accessEvents->reads);
+			unsigned int n(0);
+			for (unsigned int i(0); i < reads.size(); ++i)
+				if (reads[i].getInfo<CL_EVENT_COMMAND_EXECUTION_STATUS>() != CL_COMPLETE)
+					reads[n++] = reads[i];
+			reads.resize(n);
+			reads.push_back(event);
+		}
+	}
+
+
+	void MemBlock::markWritten()
+	{
+		accessEvents->stamp = ++lastStamp;
+	}
+
+
+	void MemBlock::synchronize() const
+	{
+		vector<cl::Event> dependencies;
+		getDependencies(dependencies, true);
+		if (dependencies.size() > 0)
+		{
+			cl_int status = cl::Event::waitForEvents(dependencies);
+			errorMessage(status, "Event::waitForEvents() - MemBlock::synchronize()");
+		}
+	}
+
+
 	std::shared_ptr<void> MemBlock::map()
 	{
-		shared_ptr<void> p;
 		if (region.expired())
 		{
-			cl_int status = 0;
-			cl::Event event;
-
-			// blocking_map = CL_TRUE (second argument)
-			// read and write access (third argument)
-			p.reset(queue->enqueueMapBuffer(*buffer,
-				                            CL_TRUE,
-				                            CL_MAP_READ | CL_MAP_WRITE,
-				                            0,
-				                            size * TYPE_SIZE[typeID],
-				                            NULL,
-				                            &event,
-				                            &status),
-			         VectorUnmapper<void> (buffer, queue));
-			errorMessage(status, "enqueueMapBuffer()");
-			status = event.wait();
-			errorMessage(status, "Event::wait() - event");			
+			shared_ptr<void> p(map(0, size, CL_MAP_READ | CL_MAP_WRITE));
 			region = p;
+			return p;
 		}
 		return region.lock();
 	}
 
 
+	std::shared_ptr<void> MemBlock::map(unsigned int offset, unsigned int length, cl_map_flags access)
+	{
+		if (offset + length > size)
+			errorMessage("MemBlock::map() - the region exceeds the MemBlock size");
+		if (length == 0)
+			return shared_ptr<void>();
+
+		// the region is a part of the existing mapping of the whole buffer
+		shared_ptr<void> whole(region.lock());
+		if (whole)
+			return shared_ptr<void>(whole, (char*)whole.get() + offset * getElementSize());
+
+		cl_int status = 0;
+		cl::Event event;
+		vector<cl::Event> dependencies;
+		// the host only reading the region waits for the writes only
+		getDependencies(dependencies, access != CL_MAP_READ);
+
+		// blocking_map = CL_TRUE (second argument)
+		shared_ptr<void> p(queue->enqueueMapBuffer(*buffer,
+		                                           CL_TRUE,
+		                                           access,
+		                                           offset * getElementSize(),
+		                                           length * getElementSize(),
+		                                           &dependencies,
+		                                           &event,
+		                                           &status),
+		                   VectorUnmapper<void> (buffer, 
+		                                         queue, 
+		                                         access != CL_MAP_READ ? accessEvents : 
+		                                                                 shared_ptr<AccessEvents>()));
+		errorMessage(status, "enqueueMapBuffer()");
+		status = event.wait();
+		errorMessage(status, "Event::wait() - event");			
+		return p;
+	}
+
+
+	bool MemBlock::isHostVisible() const
+	{
+		if ((*buffer)() == NULL)
+			return false;
+		return (buffer->getInfo<CL_MEM_FLAGS>() & (CL_MEM_ALLOC_HOST_PTR | CL_MEM_USE_HOST_PTR)) != 0;
+	}
+
+
+	cl::Event MemBlock::migrate(const CommandQueue & queue_, bool contentUndefined)
+	{
+		if (!inSameContext(queue, queue_))
+			errorMessage("MemBlock::migrate() - the queue does not share the context with the buffer");
+
+		cl_int status = 0;
+		cl::Event event;
+		vector<cl::Event> dependencies;
+		getDependencies(dependencies, true);
+
+		status = queue_->enqueueMigrateMemObjects(vector<cl::Memory>(1, getBuffer()),
+		                                          contentUndefined ? CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED : 0,
+		                                          &dependencies,
+		                                          &event);
+		errorMessage(status, "MemBlock::migrate() - enqueueMigrateMemObjects()");
+		registerAccess(event, true);
+
+		return event;
+	}
+
+
+	unsigned int MemBlock::getArgumentVersion() const
+	{
+		return version;
+	}
+
+
+	cl_ulong MemBlock::getContentStamp() const
+	{
+		return accessEvents->stamp;
+	}
+
+
 	void MemBlock::swapBuffers(MemBlock & a)
 	{
 		if (compatible(size, queue, a.getSize(), a.getQueue()))
 		{
 			std::swap(buffer, a.buffer);
+			std::swap(accessEvents, a.accessEvents);
+			++version;
+			++a.version;
 		}
 		else
 		{
@@ -36,18 +36,76 @@
 namespace acl
 {
 
+	/// Events of the commands accessing a buffer \ingroup LDI
+	/**
+		 Used for tracking of dependencies between asynchronous commands:
+		 a read has to wait for the last write,
+		 a write has to wait for the last write and for all reads after it.
+	*/
+	class AccessEvents
+	{
+		public:
+			cl::Event write;
+			std::vector<cl::Event> reads;
+			/// unique among all buffers, renewed by each registered write
+			cl_ulong stamp;
+			AccessEvents();
+	};
+
+	/// Element residing in a device buffer \ingroup LDI
+	/**
+		 The buffers are provided by acl::memoryPool and return
+		 to it when the last MemBlock using them is destroyed.
+	*/
 	class MemBlock: public ElementBase
 	{
 		protected:
 			shared_ptr<cl::Buffer> buffer; //< pointer in gpu
+			shared_ptr<AccessEvents> accessEvents; //< moves together with buffer
+			unsigned int version; //< incremented whenever buffer is replaced
 			weak_ptr<void> region;
 			MemBlock();
 			MemBlock(unsigned int size, TypeID typeID, CommandQueue queue_);
 			MemBlock(unsigned int size, TypeID typeID, char *initArray, CommandQueue queue_);
+			/// allocates \p size elements of \p elementSize bytes, see getElementSize()
+			MemBlock(unsigned int size, TypeID typeID, unsigned int elementSize, CommandQueue queue_);
 			virtual void swapBuffers(MemBlock & a);
 		public:
 			virtual cl::Buffer &getBuffer();
+			/// Appends to \p dependencies events of the commands which have to be finished
+			/// before the buffer can be read (\p write = false) or written (\p write = true)
+			virtual void getDependencies(std::vector<cl::Event> & dependencies, bool write) const;
+			/// Registers \p event of a command which reads (\p write = false) or writes the buffer
+			virtual void registerAccess(const cl::Event & event, bool write);
+			/// Renews the content stamp after the buffer was written on the host
+			/// through a mapping, see getContentStamp()
+			virtual void markWritten();
+			/// Blocks until all registered commands accessing the buffer are finished
+			void synchronize() const;
+			/// Migrates the buffer to the device of \p queue_ (clEnqueueMigrateMemObjects)
+			/// after all registered commands accessing it. The migration is 
+			/// registered as a write, so subsequent commands on any queue wait for it.
+			/// If \p contentUndefined is true the content is not transferred.
+			cl::Event migrate(const CommandQueue & queue_, bool contentUndefined = false);
+			/// Maps the whole buffer for reading and writing; the mapping is
+			/// shared by all callers till the last returned pointer is released
 			shared_ptr<void> map();
+			/// Maps \p length elements starting at \p offset with \p access: 
+			/// CL_MAP_READ, CL_MAP_WRITE or CL_MAP_WRITE_INVALIDATE_REGION 
+			/// (the content of the region is not transferred to the host).
+			/// A read-only mapping waits only for the commands writing the buffer.
+			/// The region is unmapped when the returned pointer is released.
+			shared_ptr<void> map(unsigned int offset, unsigned int length, cl_map_flags access);
+			/// checks whether the buffer resides in the host memory 
+			/// (zero-copy buffers of CPU devices, see MemoryPool)
+			bool isHostVisible() const;
+			virtual unsigned int getArgumentVersion() const;
+			/// Returns stamp of the content: it changes with each registered write
+			/// and with a replacement of the buffer, see swapBuffers()
+			virtual cl_ulong getContentStamp() const;
+			/// Returns size of a stored element in bytes; it is smaller than the size 
+			/// of the type for reduced precision storage, see ArrayHalf
+			virtual unsigned int getElementSize() const;
 			friend inline void swapBuffers(MemBlock & a, MemBlock & b);
 	};
 
@@ -56,6 +114,11 @@ namespace acl
 
 	
 	template<typename T> inline std::shared_ptr<T> map(ElementData m);
+	/// Maps \p length elements of \p m starting at \p offset, see MemBlock::map()
+	template<typename T> inline std::shared_ptr<T> map(ElementData m,
+	                                                   unsigned int offset,
+	                                                   unsigned int length,
+	                                                   cl_map_flags access);
 	
 // --------------------Implementation -----------------------
 
@@ -67,12 +130,28 @@ namespace acl
 
 	template<typename T> inline std::shared_ptr<T> map(ElementData m)
 	{
-		if (m->getTypeID() != typeToTypeID<T>())
+		if (m->getTypeID() != typeToTypeID<T>() || m->getElementSize() != sizeof(T))
+			asl::errorMessage ("map: there is attempt to cast pointer with type " + 
+			              typeToStr<T>() +
+			              " for an element  with type " +
+			              TYPE[m->getTypeID()]);
+		std::shared_ptr<void> p(m->map());
+		return std::shared_ptr<T> (p, (T*)p.get());
+	}
+
+
+	template<typename T> inline std::shared_ptr<T> map(ElementData m,
+	                                                   unsigned int offset,
+	                                                   unsigned int length,
+	                                                   cl_map_flags access)
+	{
+		if (m->getTypeID() != typeToTypeID<T>() || m->getElementSize() != sizeof(T))
 			asl::errorMessage ("map: there is attempt to cast pointer with type " + 
 			              typeToStr<T>() +
 			              " for an element  with type " +
 			              TYPE[m->getTypeID()]);
-		return std::shared_ptr<T> (m->map(),(T*)m->map().get());
+		std::shared_ptr<void> p(m->map(offset, length, access));
+		return std::shared_ptr<T> (p, (T*)p.get());
 	}
 } // namespace acl
 
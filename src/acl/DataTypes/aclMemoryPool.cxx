@@ -0,0 +1,304 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include "aclMemoryPool.h"
+#include "aclMemBlock.h"
+#include "../aclHardware.h"
+#include "../../aslUtilities.h"
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+using namespace std;
+using namespace asl;
+
+namespace acl
+{
+
+	MemoryPool memoryPool;
+
+
+	/// Returns released buffer to the pool
+	class MemoryPool::BufferReleaser
+	{
+		private:
+			weak_ptr<State> state;
+			BufferKind kind;
+			size_t size;
+			shared_ptr<AccessEvents> accessEvents;
+		public:
+			BufferReleaser(const shared_ptr<State> & state_,
+			               const BufferKind & kind_,
+			               size_t size_,
+			               const shared_ptr<AccessEvents> & accessEvents_):
+				state(state_),
+				kind(kind_),
+				size(size_),
+				accessEvents(accessEvents_)
+			{}
+
+			void operator() (cl::Buffer * b) const
+			{
+				shared_ptr<State> s(state.lock());
+				if (s)
+				{
+					s->statistics.bytesLive -= size;
+					if (s->enabled)
+					{
+						Entry entry;
+						entry.buffer = *b;
+						entry.accessEvents = accessEvents;
+						s->cache[kind][size].push_back(entry);
+						s->statistics.bytesCached += size;
+					}
+				}
+				delete b;
+			}
+	};
+
+
+	MemoryPool::Statistics::Statistics():
+		bytesLive(0),
+		bytesPeak(0),
+		bytesCached(0),
+		requests(0),
+		hits(0)
+	{
+	}
+
+
+	double MemoryPool::Statistics::hitRate() const
+	{
+		return requests > 0 ? (double)hits / requests : 0;
+	}
+
+
+	MemoryPool::State::State():
+		enabled(true),
+		zeroCopy(true),
+		limit(0)
+	{
+	}
+
+
+	MemoryPool::MemoryPool():
+		state(new State())
+	{
+	}
+
+
+	size_t MemoryPool::sizeClass(size_t bytes, size_t alignment)
+	{
+		size_t b(max<size_t>(bytes, 1));
+		// four classes per power of two
+		size_t step(1);
+		while ((step << 3) <= b)
+			step <<= 1;
+		size_t c((b + step - 1) / step * step);
+
+		// the padding required by the vector kernels
+		alignment = max<size_t>(alignment, 1);
+		return (c + alignment - 1) / alignment * alignment;
+	}
+
+
+	bool MemoryPool::reserve(size_t bytes)
+	{
+		Statistics & s(state->statistics);
+		if (s.bytesLive + s.bytesCached + bytes > state->limit)
+			freeCached();
+		return s.bytesLive + bytes <= state->limit;
+	}
+
+
+	void MemoryPool::freeCached()
+	{
+		state->cache.clear();
+		state->statistics.bytesCached = 0;
+	}
+
+
+	inline string toMB(size_t bytes)
+	{
+		stringstream s;
+		s << fixed << setprecision(1) << bytes / 1048576.;
+		return s.str();
+	}
+
+
+	void MemoryPool::allocate(size_t bytes,
+	                          const CommandQueue & queue,
+	                          shared_ptr<cl::Buffer> & buffer,
+	                          shared_ptr<AccessEvents> & accessEvents,
+	                          const void * hostPtr)
+	{
+		size_t size(sizeClass(bytes, getAlignment(queue)));
+		cl::Context context(getContext(queue));
+		BufferKind kind(context(), getFlags(queue));
+		Statistics & s(state->statistics);
+		++s.requests;
+
+		Entry entry;
+		vector<Entry> & cached(state->cache[kind][size]);
+		if (state->enabled && !cached.empty())
+		{
+			entry = cached.back();
+			cached.pop_back();
+			s.bytesCached -= size;
+			++s.hits;
+		}
+		else
+		{
+			if (state->limit > 0)
+			{
+				if (!reserve(size))
+					errorMessage("MemoryPool::allocate() - allocation of " + toMB(size) +
+					             " MB exceeds the device memory limit of " + toMB(state->limit) + 
+					             " MB, " + toMB(s.bytesLive) + " MB are in use");
+			}
+			else
+			{
+				// the cached buffers should not exhaust the device memory
+				size_t deviceMemory(getDevice(queue).getInfo<CL_DEVICE_GLOBAL_MEM_SIZE>());
+				if (s.bytesLive + s.bytesCached + size > deviceMemory)
+					freeCached();
+			}
+
+			cl_int status = 0;
+			entry.buffer = cl::Buffer(context, kind.second, size, NULL, &status);
+			if (status == CL_MEM_OBJECT_ALLOCATION_FAILURE || status == CL_OUT_OF_RESOURCES)
+			{
+				freeCached();
+				entry.buffer = cl::Buffer(context, kind.second, size, NULL, &status);
+			}
+			errorMessage(status, "MemoryPool::allocate() - cl::Buffer() of " + toMB(size) + " MB");
+			entry.accessEvents.reset(new AccessEvents());
+		}
+
+		s.bytesLive += size;
+		s.bytesPeak = max(s.bytesPeak, s.bytesLive);
+
+		if (hostPtr != NULL)
+		{
+			// a reused buffer can be still accessed by the commands of its previous owner
+			vector<cl::Event> dependencies;
+			if (entry.accessEvents->write() != NULL)
+				dependencies.push_back(entry.accessEvents->write);
+			dependencies.insert(dependencies.end(),
+			                    entry.accessEvents->reads.begin(),
+			                    entry.accessEvents->reads.end());
+
+			cl_int status = queue->enqueueWriteBuffer(entry.buffer,
+			                                          CL_TRUE,
+			                                          0,
+			                                          bytes,
+			                                          hostPtr,
+			                                          &dependencies);
+			errorMessage(status, "MemoryPool::allocate() - enqueueWriteBuffer()");
+			// the blocking write has finished all dependencies
+			entry.accessEvents->write = cl::Event();
+			entry.accessEvents->reads.clear();
+		}
+
+		accessEvents = entry.accessEvents;
+		buffer.reset(new cl::Buffer(entry.buffer),
+		             BufferReleaser(state, kind, size, entry.accessEvents));
+	}
+
+
+	void MemoryPool::setLimit(size_t bytes)
+	{
+		state->limit = bytes;
+		if (bytes > 0 && state->statistics.bytesLive + state->statistics.bytesCached > bytes)
+			freeCached();
+	}
+
+
+	size_t MemoryPool::getLimit() const
+	{
+		return state->limit;
+	}
+
+
+	void MemoryPool::setEnabled(bool enabled)
+	{
+		state->enabled = enabled;
+		if (!enabled)
+			freeCached();
+	}
+
+
+	bool MemoryPool::isEnabled() const
+	{
+		return state->enabled;
+	}
+
+
+	void MemoryPool::setZeroCopy(bool zeroCopy)
+	{
+		state->zeroCopy = zeroCopy;
+	}
+
+
+	bool MemoryPool::isZeroCopy() const
+	{
+		return state->zeroCopy;
+	}
+
+
+	cl_mem_flags MemoryPool::getFlags(const CommandQueue & queue) const
+	{
+		// the host and a CPU device share the memory
+		if (state->zeroCopy && getDeviceType(queue) == CL_DEVICE_TYPE_CPU)
+			return CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR;
+		return CL_MEM_READ_WRITE;
+	}
+
+
+	void MemoryPool::clear()
+	{
+		freeCached();
+	}
+
+
+	const MemoryPool::Statistics & MemoryPool::getStatistics() const
+	{
+		return state->statistics;
+	}
+
+
+	string MemoryPool::report() const
+	{
+		const Statistics & s(state->statistics);
+		stringstream r;
+		r << "Device memory pool:\n"
+		  << "  live:     " << toMB(s.bytesLive) << " MB (peak " << toMB(s.bytesPeak) << " MB)\n"
+		  << "  cached:   " << toMB(s.bytesCached) << " MB\n"
+		  << "  requests: " << s.requests << ", reused: " << s.hits 
+		  << " (" << fixed << setprecision(1) << s.hitRate() * 100 << "%)\n"
+		  << "  limit:    " << (state->limit > 0 ? toMB(state->limit) + " MB" : string("none")) << "\n";
+		return r.str();
+	}
+
+} // namespace acl
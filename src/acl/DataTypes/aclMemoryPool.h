@@ -0,0 +1,154 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef ACLMEMORYPOOL_H
+#define ACLMEMORYPOOL_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+//#include <CL/cl.hpp>
+// Supply "cl.hpp" with ASL, since it is not present in OpenCL 2.0
+// Remove the file after switching to OpenCL 2.1
+#include "acl/cl.hpp"
+
+namespace acl
+{
+	typedef std::shared_ptr<cl::CommandQueue> CommandQueue;
+	class AccessEvents;
+
+	/// Pool of device buffers of MemBlock
+	/**	
+		\ingroup LDI
+		The buffers are allocated in size classes (four classes per power
+		of two, at least the alignment of the device), the padding 
+		required by the kernels is added by the pool. A buffer released by
+		its last MemBlock returns to the pool of its context together with
+		the events of the commands still accessing it, so a MemBlock reusing
+		it waits for them (see MemBlock::getDependencies()).
+
+		The total device memory (live and cached buffers) can be limited 
+		by setLimit(), the cached buffers are freed first when the limit or
+		the device memory is exhausted.
+
+		On CPU devices the host and the device share the memory, there the
+		buffers are allocated with CL_MEM_ALLOC_HOST_PTR (zero-copy mode),
+		so mapping of a buffer (MemBlock::map(), acl::copy()) is a pointer
+		hand-off instead of a transfer.
+		
+		\code
+		memoryPool.setLimit(2048ul << 20);
+		// ... simulation ...
+		cout << memoryPool.report();
+		\endcode
+	*/
+	class MemoryPool
+	{
+		public:
+			/// Statistics of the pool
+			class Statistics
+			{
+				public:
+					/// bytes of the buffers used by MemBlocks
+					size_t bytesLive;
+					/// maximum of \p bytesLive
+					size_t bytesPeak;
+					/// bytes of the buffers kept for reuse
+					size_t bytesCached;
+					/// number of allocation requests
+					unsigned long long requests;
+					/// number of requests served by a cached buffer
+					unsigned long long hits;
+					Statistics();
+					double hitRate() const;
+			};
+		private:
+			/// cached buffer with events of the commands accessing it
+			class Entry
+			{
+				public:
+					cl::Buffer buffer;
+					std::shared_ptr<AccessEvents> accessEvents;
+			};
+			/// state shared with the released buffers, 
+			/// the buffers released after destruction of the pool are just freed
+			/// context and flags of a buffer
+			typedef std::pair<cl_context, cl_mem_flags> BufferKind;
+			class State
+			{
+				public:
+					bool enabled;
+					bool zeroCopy;
+					size_t limit;
+					Statistics statistics;
+					/// cached buffers per buffer kind and size class
+					std::map<BufferKind, std::map<size_t, std::vector<Entry> > > cache;
+					State();
+			};
+			class BufferReleaser;
+			std::shared_ptr<State> state;
+
+			/// frees cached buffers till \p bytes can be allocated within the limit;
+			/// returns false if it is impossible
+			bool reserve(size_t bytes);
+			/// frees all cached buffers of all contexts
+			void freeCached();
+		public:
+			MemoryPool();
+			/// Provides a \p buffer of at least \p bytes bytes (plus the padding)
+			/// in the context of \p queue, \p accessEvents are the events of the
+			/// commands which can still access a reused buffer.
+			/// If \p hostPtr is not NULL the buffer is initialized by its content.
+			void allocate(size_t bytes,
+			              const CommandQueue & queue,
+			              std::shared_ptr<cl::Buffer> & buffer,
+			              std::shared_ptr<AccessEvents> & accessEvents,
+			              const void * hostPtr = NULL);
+			/// Sets the maximal size of the device memory in bytes, 0 means no limit
+			void setLimit(size_t bytes);
+			size_t getLimit() const;
+			/// Disabled pool allocates and frees each buffer directly
+			void setEnabled(bool enabled);
+			bool isEnabled() const;
+			/// Enables or disables host-visible buffers on CPU devices for the subsequent allocations
+			void setZeroCopy(bool zeroCopy);
+			bool isZeroCopy() const;
+			/// Returns flags of the buffers allocated for \p queue
+			cl_mem_flags getFlags(const CommandQueue & queue) const;
+			/// frees cached buffers
+			void clear();
+			const Statistics & getStatistics() const;
+			/// Returns the size class of an allocation of \p bytes bytes with alignment \p alignment
+			static size_t sizeClass(size_t bytes, size_t alignment);
+			std::string report() const;
+	};
+
+
+	// GLOBALS
+	extern MemoryPool memoryPool;
+
+} // namespace acl
+
+#endif // ACLMEMORYPOOL_H
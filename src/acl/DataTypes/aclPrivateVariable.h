@@ -43,6 +43,8 @@ namespace acl
 			static unsigned int id;
 		public:
 			PrivateVariable();
+			/// Creates the variable named \p name_; the name has to be unique within the kernel
+			explicit PrivateVariable(const string & name_);
 			virtual string str(const KernelConfiguration & kernelConfig) const;
 			virtual string getName() const;
 			virtual string getAddressSpaceQualifier() const;
@@ -62,6 +64,13 @@ namespace acl
 	}
 
 
+	template <typename T> PrivateVariable<T>::PrivateVariable(const string & name_):
+		ElementBase(true, 0, typeToTypeID<T>()),
+		name(name_)
+	{
+	}
+
+
 	template <typename T> string PrivateVariable<T>::str(const KernelConfiguration & kernelConfig) const
 	{
 		return name;
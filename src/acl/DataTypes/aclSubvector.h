@@ -45,11 +45,16 @@ namespace acl
 			unsigned int offset;
 			shared_ptr<Array<T> > vector;
 			cl_buffer_region buffer_create_info;
+			/// buffer of \p vector the sub-buffer was created from
+			cl_mem parentBuffer;
 		public:
 			Subvector(shared_ptr<Array<T> > vector_,
 			          unsigned int size_,
 			          unsigned int offset_);
 			virtual cl::Buffer &getBuffer();
+			virtual void getDependencies(std::vector<cl::Event> & dependencies, bool write) const;
+			virtual void registerAccess(const cl::Event & event, bool write);
+			virtual void markWritten();
 			virtual string str(const KernelConfiguration & kernelConfig) const;
 			virtual string getName() const;
 			virtual string getTypeSignature(const KernelConfiguration & kernelConfig) const;
@@ -57,6 +62,8 @@ namespace acl
 			virtual void addToKernelSource(std::vector<Element> & arguments,
 			                               std::vector<Element> & localDeclarations) const;
 			virtual void setAsArgument(cl::Kernel & kernel, unsigned int argumentIndex) const;			
+			virtual unsigned int getArgumentVersion() const;
+			virtual cl_ulong getContentStamp() const;
 	};
 
 
@@ -68,7 +75,8 @@ namespace acl
 	                                              unsigned int offset_):
 		MemBlock(),
 		offset(offset_),
-		vector(vector_)
+		vector(vector_),
+		parentBuffer(NULL)
 	{
 		size = size_;
 		queue = vector_->getQueue();
@@ -89,18 +97,61 @@ namespace acl
 
 	template <typename T> cl::Buffer &Subvector<T>::getBuffer()
 	{
-		cl_int status = 0;
-		///  if original buffer is moved within GPU memory	
-		*buffer = vector->getBuffer().createSubBuffer(CL_MEM_READ_WRITE,
-		                                              CL_BUFFER_CREATE_TYPE_REGION,
-		                                              &buffer_create_info,
-		                                              &status);
-		errorMessage(status, "Subvector::Subvector() - createSubBuffer()");
+		cl::Buffer & parent(vector->getBuffer());
+		///  the sub-buffer is recreated only if the original buffer is replaced (e.g. swapped)
+		if (parent() != parentBuffer)
+		{
+			cl_int status = 0;
+			*buffer = parent.createSubBuffer(CL_MEM_READ_WRITE,
+			                                 CL_BUFFER_CREATE_TYPE_REGION,
+			                                 &buffer_create_info,
+			                                 &status);
+			errorMessage(status, "Subvector::Subvector() - createSubBuffer()");
+			parentBuffer = parent();
+			++version;
+		}
 
 		return *buffer;
 	}
 
 
+	// the subvector shares the memory with the original vector
+	template <typename T> 
+	void Subvector<T>::getDependencies(std::vector<cl::Event> & dependencies, bool write) const
+	{
+		vector->getDependencies(dependencies, write);
+	}
+
+
+	template <typename T> 
+	void Subvector<T>::registerAccess(const cl::Event & event, bool write)
+	{
+		vector->registerAccess(event, write);
+	}
+
+
+	template <typename T> 
+	void Subvector<T>::markWritten()
+	{
+		vector->markWritten();
+	}
+
+
+	template <typename T> 
+	cl_ulong Subvector<T>::getContentStamp() const
+	{
+		return vector->getContentStamp();
+	}
+
+
+	// both versions only increase, so the sum changes whenever one of them does
+	template <typename T> 
+	unsigned int Subvector<T>::getArgumentVersion() const
+	{
+		return version + vector->getArgumentVersion();
+	}
+
+
 	template <typename T> string Subvector<T>::getName() const
 	{
 		return name;
@@ -47,7 +47,7 @@ namespace acl
 
 	template <typename T> string Variable<T>::getTypeSignature(const KernelConfiguration & kernelConfig) const
 	{
-		return TYPE[typeID] + " " + name;
+		return stable ? "" : TYPE[typeID] + " " + name;
 	}
 	#define BOOST_TT_rep_expression(r, data, T) \
 	template string Variable<T>::getTypeSignature(const KernelConfiguration & kernelConfig) const;
@@ -55,4 +55,14 @@ namespace acl
 	#undef BOOST_TT_rep_expression
 	
 
+	// stable variables are declared in the kernel body instead of being passed as arguments
+	template <typename T> string Variable<T>::getLocalDeclaration(const KernelConfiguration & kernelConfig) const
+	{
+		return stable ? "const " + TYPE[typeID] + " " + name + " = " + numToLiteral(value) : "";
+	}
+	#define BOOST_TT_rep_expression(r, data, T) \
+	template string Variable<T>::getLocalDeclaration(const KernelConfiguration & kernelConfig) const;
+	BOOST_PP_SEQ_FOR_EACH(BOOST_TT_rep_expression, ~, BOOST_TT_acl_types)
+	#undef BOOST_TT_rep_expression
+
 } // namespace acl
@@ -37,6 +37,8 @@ namespace acl
 	{
 		private:
 			T value;
+			unsigned int version;
+			bool stable;
 			string name;
 			static const string prefix;
 			static unsigned int id;
@@ -49,14 +51,25 @@ namespace acl
 			virtual void addToKernelSource(vector<Element> & arguments,
 			                               vector<Element> & localDeclarations) const;
 			virtual void setAsArgument(cl::Kernel & kernel, unsigned int argumentIndex) const;
+			virtual unsigned int getArgumentVersion() const;
 			virtual const T getValue() const;
 			void setValue(const T & a);
+			/// The value is emitted into the kernel source as a literal constant
+			/**
+				 Allows the compiler to fold the value. Kernels are rebuilt 
+				 (mostly taken from the ProgramCache) when the value changes, 
+				 so it suits parameters changed seldom. Has to be called 
+				 before the Variable is added to a Kernel.
+			*/
+			void setStable(bool flag = true);
 	};
 
 
 	template <typename T> Variable<T>::Variable(T v):
 		ElementBase(true, 0, typeToTypeID<T>()),
-		value(v)
+		value(v),
+		version(0),
+		stable(false)
 	{
 		++id;
 		name = prefix + asl::numToStr(id);
@@ -74,9 +87,9 @@ namespace acl
 		return name;
 	}
 
-	template <typename T> string Variable<T>::getLocalDeclaration(const KernelConfiguration & kernelConfig) const
+	template <typename T> void Variable<T>::setStable(bool flag)
 	{
-		return "";
+		stable = flag;
 	}
 
 
@@ -94,6 +107,12 @@ namespace acl
 	}
 
 
+	template <typename T> unsigned int Variable<T>::getArgumentVersion() const
+	{
+		return version;
+	}
+
+
 	template <typename T>  const T Variable<T>::getValue() const
 	{
 		return value;
@@ -103,6 +122,7 @@ namespace acl
 	template <typename T> void Variable<T>::setValue(const T & a)
 	{
 		value = a;
+		++version;
 	}
 
 		
@@ -37,6 +37,8 @@ namespace acl
 	{
 		private:
 			T & value;
+			mutable T lastValue;
+			mutable unsigned int version;
 			string name;
 			static const string prefix;
 			static unsigned int id;
@@ -49,12 +51,16 @@ namespace acl
 			virtual void addToKernelSource(vector<Element> & arguments,
 			                               vector<Element> & localDeclarations) const;
 			virtual void setAsArgument(cl::Kernel & kernel, unsigned int argumentIndex) const;
+			/// the value can be changed outside, it is compared with the last seen one
+			virtual unsigned int getArgumentVersion() const;
 	};
 
 
 	template <typename T> VariableReference<T>::VariableReference(T & v):
 		ElementBase(true, 0, typeToTypeID<T>()),
-		value(v)
+		value(v),
+		lastValue(value),
+		version(0)
 	{
 		++id;
 		name = prefix + asl::numToStr(id);
@@ -91,6 +97,18 @@ namespace acl
 		errorMessage(status, "Kernel::setArg() - " + name + ", argument " + asl::numToStr(argumentIndex));
 	}
 
+
+
+	template <typename T> unsigned int VariableReference<T>::getArgumentVersion() const
+	{
+		if (!(lastValue == value))
+		{
+			lastValue = value;
+			++version;
+		}
+		return version;
+	}
+
 		
 } // namespace acl
 
@@ -36,6 +36,9 @@ namespace acl
 	{
 		private:
 			std::shared_ptr<T> value;
+			mutable T lastValue;
+			mutable unsigned int version;
+			bool stable;
 			string name;
 			static const string prefix;
 			static unsigned int id;
@@ -48,12 +51,19 @@ namespace acl
 			virtual void addToKernelSource(vector<Element> & arguments,
 			                               vector<Element> & localDeclarations) const;
 			virtual void setAsArgument(cl::Kernel & kernel, unsigned int argumentIndex) const;
+			/// the value can be changed outside, it is compared with the last seen one
+			virtual unsigned int getArgumentVersion() const;
+			/// The value is emitted into the kernel source as a literal constant, see Variable::setStable()
+			void setStable(bool flag = true);
 	};
 
 
 	template <typename T> VariableSP<T>::VariableSP(std::shared_ptr<T> v):
 		ElementBase(true, 0, typeToTypeID<T>()),
-		value(v)
+		value(v),
+		lastValue(*value),
+		version(0),
+		stable(false)
 	{
 		++id;
 		name = prefix + asl::numToStr(id);
@@ -71,9 +81,9 @@ namespace acl
 		return name;
 	}
 
-	template <typename T> string VariableSP<T>::getLocalDeclaration(const KernelConfiguration & kernelConfig) const
+	template <typename T> void VariableSP<T>::setStable(bool flag)
 	{
-		return "";
+		stable = flag;
 	}
 
 
@@ -90,6 +100,18 @@ namespace acl
 		asl::errorMessage(status, "Kernel::setArg() - " + name + ", argument " + asl::numToStr(argumentIndex));
 	}
 
+
+
+	template <typename T> unsigned int VariableSP<T>::getArgumentVersion() const
+	{
+		if (!(lastValue == *value))
+		{
+			lastValue = *value;
+			++version;
+		}
+		return version;
+	}
+
 		
 } // namespace acl
 
@@ -34,7 +34,9 @@ set(acldatatypes_PUBLIC_HEADERS
 	DataTypes/aclVariableReference.h 
 	DataTypes/aclVariableSP.h
 	DataTypes/aclMemBlock.h
+	DataTypes/aclMemoryPool.h
 	DataTypes/aclArray.h
+	DataTypes/aclArrayHalf.h
 	DataTypes/aclSubvector.h
 )
 
@@ -50,6 +52,8 @@ set(acldatatypes_SOURCES
 	DataTypes/aclVariableReference.cxx 
 	DataTypes/aclVariableSP.cxx 
 	DataTypes/aclMemBlock.cxx
+	DataTypes/aclMemoryPool.cxx
 	DataTypes/aclArray.cxx
+	DataTypes/aclArrayHalf.cxx
 	DataTypes/aclSubvector.cxx
 )
@@ -47,13 +47,16 @@ namespace acl
 		{
 			size = max(size, expression_->getSize());
 
-			if (expression_->getQueue().get() != 0)
+			// the first queue is kept, it can be changed by Kernel::setQueue()
+			if ((queue.get() == 0) && (expression_->getQueue().get() != 0))
 			{
 				queue = expression_->getQueue();
 			}
 			
 			expression.push_back(expression_);
 			addElementToKernelSource(expression_, arguments, localDeclarations);
+			expression_->addToWrittenArguments(writtenArguments);
+			expression_->addToReadArguments(readArguments);
 			regenerateKernelSource = true;
 		}
 		else
@@ -85,6 +88,15 @@ namespace acl
 		iter = unique(localDeclarations.begin(), localDeclarations.end());
 		// drop all elements beyond the new end() (= iter) returned by unique
 		localDeclarations.resize(iter - localDeclarations.begin());
+
+		/// sorts all Elements in writtenArguments and removes duplicates
+		sort(writtenArguments.begin(), writtenArguments.end());
+		iter = unique(writtenArguments.begin(), writtenArguments.end());
+		writtenArguments.resize(iter - writtenArguments.begin());
+
+		sort(readArguments.begin(), readArguments.end());
+		iter = unique(readArguments.begin(), readArguments.end());
+		readArguments.resize(iter - readArguments.begin());
 		
 		/// \todoZeev remember duplicate Elements and create an extra local
 		/// variable for them in order to reduce number of memory reads
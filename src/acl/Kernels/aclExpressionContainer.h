@@ -51,6 +51,10 @@ namespace acl
 		protected:
 			std::vector<Element> arguments;
 			std::vector<Element> localDeclarations;
+			/// arguments modified by the expressions, subset of \p arguments
+			std::vector<Element> writtenArguments;
+			/// arguments read by the expressions, subset of \p arguments
+			std::vector<Element> readArguments;
 			void filterDeclarations();
 		public:
 			ExpressionContainer();
@@ -0,0 +1,751 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include "aclExpressionOptimizer.h"
+#include "aclKernelConfiguration.h"
+#include "../acl.h"
+#include "../aclTypesList.h"
+#include "../aclUtilities.h"
+#include "../DataTypes/aclConstant.h"
+#include "../DataTypes/aclPrivateVariable.h"
+#include "../Operators/aclElementSum.h"
+#include "../Operators/aclElementSubtraction.h"
+#include "../Operators/aclElementProduct.h"
+#include "../Operators/aclElementDivision.h"
+#include "../Operators/aclElementMad.h"
+#include "../Operators/aclElementSelect.h"
+#include "../Operators/aclElementSqrt.h"
+#include "../Operators/aclElementSin.h"
+#include "../Operators/aclElementCos.h"
+#include "../Operators/aclElementConvert.h"
+#include "../Operators/aclElementExcerpt.h"
+#include "../Operators/aclElementIfElse.h"
+#include "../Operators/aclElementFor.h"
+#include "../Operators/aclElementParser.h"
+#include "../Operators/aclElementSyncCopy.h"
+#include "../Operators/aclElementGenericUnary.h"
+#include "../Operators/aclElementGenericBinary.h"
+#include "../Operators/aclElementAssignmentSafe.h"
+#include "../Operators/aclGenericAtomicFunction.h"
+#include "../Operators/aclOperatorGeneric.h"
+#include <algorithm>
+#include <typeinfo>
+
+using namespace std;
+
+namespace acl
+{
+
+	/// Subexpression that can be computed once into a private variable
+	struct ExpressionOptimizer::Candidate
+	{
+		Element node;
+		/// arguments and local declarations the subexpression is computed from, sorted
+		vector<Element> reads;
+		/// number of occurrences
+		unsigned int count;
+		/// number of occurrences not enclosed in another repeated candidate
+		unsigned int effective;
+		Element variable;
+	};
+
+
+	bool ExpressionOptimizer::enabled(true);
+
+
+	/// rank of the type within the usual arithmetic conversions
+	int typeRank(TypeID t)
+	{
+		switch (t)
+		{
+			case TYPE_INT:
+				return 0;
+			case TYPE_UINT:
+				return 1;
+			case TYPE_LONG:
+				return 2;
+			case TYPE_FLOAT:
+				return 3;
+			case TYPE_DOUBLE:
+				return 4;
+		}
+		return 0;
+	}
+
+
+	TypeID maxType(TypeID t1, TypeID t2)
+	{
+		return typeRank(t1) >= typeRank(t2) ? t1 : t2;
+	}
+
+
+	template <typename T> inline bool getConstantValue(const Element & e, T & value)
+	{
+		const Constant<T> * c(dynamic_cast<const Constant<T>*>(e.get()));
+		if (c != NULL)
+			value = c->getValue();
+		return c != NULL;
+	}
+
+
+	/// checks whether \p e is a Constant equal to \p x
+	bool isConstantEqual(const Element & e, int x)
+	{
+		#define BOOST_TT_rep_expression(r, data, t) \
+			{ \
+				t value; \
+				if (getConstantValue(e, value)) \
+					return value == t(x); \
+			}
+		BOOST_PP_SEQ_FOR_EACH(BOOST_TT_rep_expression, ~, BOOST_TT_acl_types)
+		#undef BOOST_TT_rep_expression
+
+		return false;
+	}
+
+
+	template <typename T> Element foldConstants(char operation, T a, T b)
+	{
+		switch (operation)
+		{
+			case '+':
+				return Element(new Constant<T>(a + b));
+			case '-':
+				return Element(new Constant<T>(a - b));
+			case '*':
+				return Element(new Constant<T>(a * b));
+			case '/':
+				// division by zero is left to the device
+				if (b == T(0))
+					return Element();
+				return Element(new Constant<T>(a / b));
+		}
+		return Element();
+	}
+
+
+	/// Returns Constant \p c1 \p operation \p c2 or empty Element 
+	/// if the operands are not Constants of the same type
+	Element foldConstants(char operation, const Element & c1, const Element & c2)
+	{
+		#define BOOST_TT_rep_expression(r, data, t) \
+			{ \
+				t a, b; \
+				if (getConstantValue(c1, a) && getConstantValue(c2, b)) \
+					return foldConstants(operation, a, b); \
+			}
+		BOOST_PP_SEQ_FOR_EACH(BOOST_TT_rep_expression, ~, BOOST_TT_acl_types)
+		#undef BOOST_TT_rep_expression
+
+		return Element();
+	}
+
+
+	/// Returns '+', '-', '*', '/' for the arithmetic operators and 0 otherwise
+	char getArithmeticOperation(const ElementBase * e)
+	{
+		if (typeid(*e) == typeid(ElementSum))
+			return '+';
+		if (typeid(*e) == typeid(ElementSubtraction))
+			return '-';
+		if (typeid(*e) == typeid(ElementProduct))
+			return '*';
+		if (typeid(*e) == typeid(ElementDivision))
+			return '/';
+		return 0;
+	}
+
+
+	/// Elements with hidden operands or side effects on other work items
+	bool isOpaque(const ElementBase * e)
+	{
+		return dynamic_cast<const OperatorGeneric*>(e) != NULL ||
+		       dynamic_cast<const ElementIfElse*>(e) != NULL ||
+		       dynamic_cast<const ElementFor*>(e) != NULL ||
+		       dynamic_cast<const ElementParser*>(e) != NULL ||
+		       dynamic_cast<const ElementSyncCopy*>(e) != NULL;
+	}
+
+
+	bool containsMemBlock(const vector<Element> & elements)
+	{
+		for (unsigned int i(0); i < elements.size(); ++i)
+			if (isMemBlock(elements[i]))
+				return true;
+		return false;
+	}
+
+
+	bool containsSubvector(const vector<Element> & elements)
+	{
+		for (unsigned int i(0); i < elements.size(); ++i)
+			if (isSubvector(elements[i]))
+				return true;
+		return false;
+	}
+
+
+	/// checks whether writing of \p written (sorted) can change \p reads (sorted);
+	/// Subvectors share the memory with their vectors
+	bool overlap(const vector<Element> & reads, const vector<Element> & written)
+	{
+		vector<Element> common;
+		set_intersection(reads.begin(), reads.end(),
+		                 written.begin(), written.end(),
+		                 back_inserter(common));
+		return !common.empty() ||
+		       (containsSubvector(written) && containsMemBlock(reads)) ||
+		       (containsSubvector(reads) && containsMemBlock(written));
+	}
+
+
+	Element generateVariable(TypeID t, const string & name)
+	{
+		if (t == TYPE_DOUBLE)
+			return Element(new PrivateVariable<cl_double>(name));
+		return Element(new PrivateVariable<cl_float>(name));
+	}
+
+
+	ExpressionOptimizer::ExpressionOptimizer(const KernelConfiguration & kernelConfig_):
+		kernelConfig(kernelConfig_),
+		nEliminatedNodes(0),
+		declarations(NULL)
+	{
+	}
+
+
+	vector<Element> ExpressionOptimizer::optimize(const vector<Element> & expression,
+	                                              vector<Element> & declarations_)
+	{
+		nEliminatedNodes = 0;
+		declarations = &declarations_;
+		return optimizeBlock(expression);
+	}
+
+
+	vector<Element> ExpressionOptimizer::optimizeBlock(const vector<Element> & block)
+	{
+		vector<Element> folded(block.size());
+		for (unsigned int i(0); i < block.size(); ++i)
+		{
+			const ElementIfElse * ife(dynamic_cast<const ElementIfElse*>(block[i].get()));
+			if (ife != NULL && typeid(*ife) == typeid(ElementIfElse))
+			{
+				shared_ptr<ElementIfElse> copy(new ElementIfElse(*ife));
+				copy->condition = fold(ife->condition);
+				copy->expressionIf = optimizeBlock(ife->expressionIf);
+				copy->expressionElse = optimizeBlock(ife->expressionElse);
+				folded[i] = copy;
+			}
+			else
+			{
+				folded[i] = fold(block[i]);
+			}
+		}
+
+		// the nodes of the nested blocks not used in their optimized versions are
+		// released, their addresses can be reused
+		keys.clear();
+		candidates.clear();
+
+		// the candidates valid within each statement
+		vector<CandidateMap> used(folded.size());
+		CandidateMap active;
+		for (unsigned int i(0); i < folded.size(); ++i)
+		{
+			collect(folded[i], active, used[i]);
+			invalidate(folded[i], active);
+		}
+
+		for (unsigned int i(0); i < folded.size(); ++i)
+			countEffective(folded[i], used[i]);
+
+		vector<Element> optimized;
+		for (unsigned int i(0); i < folded.size(); ++i)
+		{
+			vector<Element> initializations;
+			Element statement(rewrite(folded[i], used[i], initializations));
+			optimized.insert(optimized.end(), initializations.begin(), initializations.end());
+			optimized.push_back(statement);
+		}
+
+		return optimized;
+	}
+
+
+	Element ExpressionOptimizer::fold(const Element & e)
+	{
+		vector<Element> operands(getOperands(e.get()));
+		bool changed(false);
+		for (unsigned int i(0); i < operands.size(); ++i)
+		{
+			Element f(fold(operands[i]));
+			changed |= (f != operands[i]);
+			operands[i] = f;
+		}
+
+		Element r(e);
+		if (changed)
+		{
+			Element c(copyWithOperands(e, operands));
+			if (c)
+				r = c;
+		}
+		
+		return simplify(r);
+	}
+
+
+	Element ExpressionOptimizer::simplify(const Element & e)
+	{
+		vector<Element> operands(getOperands(e.get()));
+		Element r;
+
+		char operation(getArithmeticOperation(e.get()));
+		if (operation != 0)
+		{
+			r = foldConstants(operation, operands[0], operands[1]);
+			if (!r)
+			{
+				TypeID t(promotedType(e));
+				bool neutral0((operation == '+' && isConstantEqual(operands[0], 0)) ||
+				              (operation == '*' && isConstantEqual(operands[0], 1)));
+				bool neutral1((operation != '*' && operation != '/' && isConstantEqual(operands[1], 0)) ||
+				              ((operation == '*' || operation == '/') && isConstantEqual(operands[1], 1)));
+				// the constant may change the type of the result (e.g. 1. * i)
+				if (neutral1 && promotedType(operands[0]) == t)
+					r = operands[0];
+				else if (neutral0 && promotedType(operands[1]) == t)
+					r = operands[1];
+			}
+		}
+
+		if (isPown(e.get()))
+		{
+			int n(0);
+			if (getConstantValue(operands[1], n))
+			{
+				vector<Element> inner(getOperands(operands[0].get()));
+				int m(0);
+				if (n == 1)
+				{
+					r = operands[0];
+				}
+				else if (isPown(operands[0].get()) && getConstantValue(inner[1], m))
+				{
+					r = copyWithOperands(e, {inner[0], Element(new Constant<int>(m * n))});
+				}
+				// pown(x, 2) simplified already
+				else if (typeid(*operands[0]) == typeid(ElementProduct) && inner[0] == inner[1])
+				{
+					r = copyWithOperands(e, {inner[0], Element(new Constant<int>(2 * n))});
+				}
+				else if (n == 2)
+				{
+					// the argument is shared by the elimination of subexpressions
+					return Element(new ElementProduct(operands[0], operands[0]));
+				}
+			}
+		}
+
+		if (!r)
+			return e;
+
+		unsigned int before(countNodes(e));
+		unsigned int after(countNodes(r));
+		if (before > after)
+			nEliminatedNodes += before - after;
+		return r;
+	}
+
+
+	void ExpressionOptimizer::collect(const Element & e, CandidateMap & active, CandidateMap & used)
+	{
+		if (isCandidate(e))
+		{
+			const string & key(getKey(e));
+			SPCandidate & c(active[key]);
+			if (!c)
+			{
+				c.reset(new Candidate());
+				c->node = e;
+				c->count = 0;
+				c->effective = 0;
+				addElementToKernelSource(e, c->reads, c->reads);
+				sort(c->reads.begin(), c->reads.end());
+			}
+			++c->count;
+			used[key] = c;
+		}
+
+		vector<Element> operands(getOperands(e.get()));
+		vector<bool> values(getValueOperands(e.get(), operands.size()));
+		for (unsigned int i(0); i < operands.size(); ++i)
+			if (values[i])
+				collect(operands[i], active, used);
+	}
+
+
+	void ExpressionOptimizer::invalidate(const Element & statement, CandidateMap & active)
+	{
+		// barriers, loops, nested blocks etc.
+		if (isOpaque(statement.get()))
+		{
+			active.clear();
+			return;
+		}
+
+		vector<Element> written;
+		statement->addToWrittenArguments(written);
+		if (written.empty())
+			return;
+		sort(written.begin(), written.end());
+
+		CandidateMap::iterator it(active.begin());
+		while (it != active.end())
+		{
+			if (overlap(it->second->reads, written))
+				active.erase(it++);
+			else
+				++it;
+		}
+	}
+
+
+	void ExpressionOptimizer::countEffective(const Element & e, CandidateMap & used)
+	{
+		if (isCandidate(e))
+		{
+			SPCandidate c(used[getKey(e)]);
+			if (c->count > 1)
+			{
+				++c->effective;
+				// the nested candidates are computed only once as well
+				if (c->effective > 1)
+					return;
+			}
+		}
+
+		vector<Element> operands(getOperands(e.get()));
+		vector<bool> values(getValueOperands(e.get(), operands.size()));
+		for (unsigned int i(0); i < operands.size(); ++i)
+			if (values[i])
+				countEffective(operands[i], used);
+	}
+
+
+	Element ExpressionOptimizer::rewrite(const Element & e,
+	                                     CandidateMap & used,
+	                                     vector<Element> & initializations)
+	{
+		SPCandidate c;
+		if (isCandidate(e))
+		{
+			c = used[getKey(e)];
+			if (c->effective < 2)
+				c.reset();
+			else if (c->variable)
+				return c->variable;
+		}
+
+		vector<Element> operands(getOperands(e.get()));
+		vector<bool> values(getValueOperands(e.get(), operands.size()));
+		bool changed(false);
+		for (unsigned int i(0); i < operands.size(); ++i)
+		{
+			if (values[i])
+			{
+				Element r(rewrite(operands[i], used, initializations));
+				changed |= (r != operands[i]);
+				operands[i] = r;
+			}
+		}
+
+		Element r(e);
+		if (changed)
+		{
+			Element copy(copyWithOperands(e, operands));
+			if (copy)
+				r = copy;
+		}
+
+		if (!c)
+			return r;
+
+		int rank(-1);
+		bool variable(false);
+		isPure(e, rank, variable);
+		c->variable = generateVariable(rank > typeRank(TYPE_FLOAT) ? TYPE_DOUBLE : TYPE_FLOAT,
+		                               "pv_cse" + asl::numToStr(declarations->size()));
+		declarations->push_back(c->variable);
+		initializations.push_back(elementOperators::operatorAssignment(c->variable, r));
+		nEliminatedNodes += (c->effective - 1) * countNodes(c->node);
+		return c->variable;
+	}
+
+
+	bool ExpressionOptimizer::isCandidate(const Element & e)
+	{
+		map<const ElementBase*, bool>::iterator it(candidates.find(e.get()));
+		if (it != candidates.end())
+			return it->second;
+
+		int rank(-1);
+		bool variable(false);
+		bool candidate(!getOperands(e.get()).empty() &&
+		               isPure(e, rank, variable) &&
+		               variable &&
+		               rank >= typeRank(TYPE_FLOAT));
+		candidates[e.get()] = candidate;
+		return candidate;
+	}
+
+
+	const string & ExpressionOptimizer::getKey(const Element & e)
+	{
+		map<const ElementBase*, string>::iterator it(keys.find(e.get()));
+		if (it == keys.end())
+			it = keys.insert(make_pair(e.get(), e->str(kernelConfig))).first;
+		return it->second;
+	}
+
+
+	/// \p rank is the maximal rank of the types of the leaves,
+	/// \p variable is set if some of the leaves is not a Constant
+	bool ExpressionOptimizer::isPure(const Element & e, int & rank, bool & variable)
+	{
+		// shifted load
+		const ElementExcerpt * excerpt(dynamic_cast<const ElementExcerpt*>(e.get()));
+		if (excerpt != NULL)
+		{
+			vector<Element> written;
+			excerpt->filter->addToWrittenArguments(written);
+			if (!isMemBlock(excerpt->source) || !written.empty() || isOpaque(excerpt->filter.get()))
+				return false;
+			rank = max(rank, typeRank(excerpt->source->getTypeID()));
+			variable = true;
+			return true;
+		}
+
+		vector<Element> operands(getOperands(e.get()));
+		if (operands.empty())
+		{
+			if (isOpaque(e.get()))
+				return false;
+			rank = max(rank, typeRank(e->getTypeID()));
+			variable |= !isConstant(e);
+			return true;
+		}
+
+		if (!isArithmetic(e.get()))
+			return false;
+
+		for (unsigned int i(0); i < operands.size(); ++i)
+			if (!isPure(operands[i], rank, variable))
+				return false;
+		return true;
+	}
+
+
+	TypeID ExpressionOptimizer::promotedType(const Element & e)
+	{
+		vector<Element> operands(getOperands(e.get()));
+		if (operands.empty() ||
+		    typeid(*e) == typeid(ElementConvert) ||
+		    typeid(*e) == typeid(ElementGenericBinary) ||
+		    typeid(*e) == typeid(ElementAssignmentSafe) ||
+		    typeid(*e) == typeid(ElementGenericAtomicFunction))
+			return e->getTypeID();
+
+		if (dynamic_cast<const ElementExcerpt*>(e.get()) != NULL || isPown(e.get()))
+			return promotedType(operands[0]);
+
+		// the condition does not affect the type
+		if (typeid(*e) == typeid(ElementSelect))
+			operands.resize(2);
+
+		TypeID t(promotedType(operands[0]));
+		for (unsigned int i(1); i < operands.size(); ++i)
+			t = maxType(t, promotedType(operands[i]));
+		return t;
+	}
+
+
+	vector<Element> ExpressionOptimizer::getOperands(const ElementBase * e)
+	{
+		vector<Element> operands;
+		if (const OperatorUnary * u = dynamic_cast<const OperatorUnary*>(e))
+		{
+			operands.push_back(u->e);
+		}
+		else if (const OperatorBinary * b = dynamic_cast<const OperatorBinary*>(e))
+		{
+			operands.push_back(b->e1);
+			operands.push_back(b->e2);
+		}
+		else if (const OperatorTernary * t = dynamic_cast<const OperatorTernary*>(e))
+		{
+			operands.push_back(t->e1);
+			operands.push_back(t->e2);
+			operands.push_back(t->e3);
+		}
+		else if (const ElementExcerpt * x = dynamic_cast<const ElementExcerpt*>(e))
+		{
+			operands.push_back(x->source);
+			operands.push_back(x->filter);
+		}
+		return operands;
+	}
+
+
+	vector<bool> ExpressionOptimizer::getValueOperands(const ElementBase * e, unsigned int n)
+	{
+		vector<bool> values(n, true);
+		if (const ElementGenericBinary * g = dynamic_cast<const ElementGenericBinary*>(e))
+		{
+			const string & o(g->operation);
+			if (o == "=" || o == "+=" || o == "-=" || o == "*=" || o == "/=")
+				values[0] = false;
+			// short-circuit evaluation
+			if (o == "&&" || o == "||")
+				values[1] = false;
+		}
+		if (dynamic_cast<const ElementAssignmentSafe*>(e) != NULL ||
+		    dynamic_cast<const ElementGenericAtomicFunction*>(e) != NULL)
+			values[0] = false;
+		// the source is evaluated at the indices given by the filter
+		if (dynamic_cast<const ElementExcerpt*>(e) != NULL)
+			values.assign(n, false);
+		return values;
+	}
+
+
+	Element ExpressionOptimizer::copyWithOperands(const Element & e, const vector<Element> & operands)
+	{
+		Element c;
+		#define ACL_COPY_ELEMENT(T) \
+			if (!c && typeid(*e) == typeid(T)) \
+				c.reset(new T(static_cast<const T &>(*e)));
+		ACL_COPY_ELEMENT(ElementSum)
+		ACL_COPY_ELEMENT(ElementSubtraction)
+		ACL_COPY_ELEMENT(ElementProduct)
+		ACL_COPY_ELEMENT(ElementDivision)
+		ACL_COPY_ELEMENT(ElementMad)
+		ACL_COPY_ELEMENT(ElementSelect)
+		ACL_COPY_ELEMENT(ElementSqrt)
+		ACL_COPY_ELEMENT(ElementSin)
+		ACL_COPY_ELEMENT(ElementCos)
+		ACL_COPY_ELEMENT(ElementConvert)
+		ACL_COPY_ELEMENT(ElementExcerpt)
+		ACL_COPY_ELEMENT(ElementGenericUnary)
+		ACL_COPY_ELEMENT(ElementGenericUnarySIMD)
+		ACL_COPY_ELEMENT(ElementGenericBinary)
+		ACL_COPY_ELEMENT(ElementGenericBinaryFunction)
+		ACL_COPY_ELEMENT(ElementAssignmentSafe)
+		ACL_COPY_ELEMENT(ElementGenericAtomicFunction)
+		#undef ACL_COPY_ELEMENT
+
+		if (!c)
+			return c;
+
+		if (OperatorUnary * u = dynamic_cast<OperatorUnary*>(c.get()))
+		{
+			u->e = operands[0];
+		}
+		else if (OperatorBinary * b = dynamic_cast<OperatorBinary*>(c.get()))
+		{
+			b->e1 = operands[0];
+			b->e2 = operands[1];
+		}
+		else if (OperatorTernary * t = dynamic_cast<OperatorTernary*>(c.get()))
+		{
+			t->e1 = operands[0];
+			t->e2 = operands[1];
+			t->e3 = operands[2];
+		}
+		else if (ElementExcerpt * x = dynamic_cast<ElementExcerpt*>(c.get()))
+		{
+			x->source = operands[0];
+			x->filter = operands[1];
+		}
+		return c;
+	}
+
+
+	bool ExpressionOptimizer::isArithmetic(const ElementBase * e)
+	{
+		if (getArithmeticOperation(e) != 0 ||
+		    typeid(*e) == typeid(ElementMad) ||
+		    typeid(*e) == typeid(ElementSqrt) ||
+		    typeid(*e) == typeid(ElementSin) ||
+		    typeid(*e) == typeid(ElementCos))
+			return true;
+
+		if (typeid(*e) == typeid(ElementGenericUnary))
+		{
+			const string & o(static_cast<const ElementGenericUnary*>(e)->operation);
+			return o == "-" || o == "exp" || o == "fabs" || o == "floor" ||
+			       o == "log10" || o == "native_log" || o == "native_rsqrt" || o == "sign";
+		}
+
+		if (typeid(*e) == typeid(ElementGenericBinaryFunction))
+		{
+			const string & f(static_cast<const ElementGenericBinaryFunction*>(e)->functionName);
+			return f == "pown" || f == "min" || f == "max" || f == "copysign";
+		}
+
+		return false;
+	}
+
+
+	bool ExpressionOptimizer::isPown(const ElementBase * e)
+	{
+		return typeid(*e) == typeid(ElementGenericBinaryFunction) &&
+		       static_cast<const ElementGenericBinaryFunction*>(e)->functionName == "pown";
+	}
+
+
+	unsigned int ExpressionOptimizer::countNodes(const Element & e)
+	{
+		vector<Element> operands(getOperands(e.get()));
+		unsigned int n(1);
+		for (unsigned int i(0); i < operands.size(); ++i)
+			n += countNodes(operands[i]);
+		return n;
+	}
+
+
+	void ExpressionOptimizer::setEnabled(bool enabled_)
+	{
+		enabled = enabled_;
+	}
+
+
+	bool ExpressionOptimizer::isEnabled()
+	{
+		return enabled;
+	}
+
+} // namespace acl
@@ -0,0 +1,120 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef ACLEXPRESSIONOPTIMIZER_H
+#define ACLEXPRESSIONOPTIMIZER_H
+
+#include "../aclElementBase.h"
+#include <map>
+
+namespace acl
+{
+
+	/// Optimizer of the expressions of a Kernel
+	/**	
+		\ingroup KernelGen
+		The Kernel applies the optimizer before generation of its source:
+		 - arithmetic of Constants of the same type is folded;
+		 - x*1, 1*x, x/1, x+0, 0+x and x-0 are replaced by x unless 
+		   the constant changes the type of the result;
+		 - pown(x, 1) is replaced by x, pown(pown(x, i), j) by pown(x, i*j)
+		   and pown(x, 2) by x*x;
+		 - identical floating point subexpressions (arithmetic, math functions
+		   and shifted loads) evaluated several times are computed once into
+		   a private variable. The variable is valid till one of the elements
+		   it is computed from is written. Operands that are not always 
+		   evaluated (right side of && and ||) are not considered, 
+		   the bodies of ElementIfElse are optimized separately.
+
+		The element trees are not modified, the changed nodes are copied, 
+		since the elements can be shared by several kernels.
+	*/
+	class ExpressionOptimizer
+	{
+		friend class StencilTiling;
+		private:
+			struct Candidate;
+			typedef std::shared_ptr<Candidate> SPCandidate;
+			typedef std::map<std::string, SPCandidate> CandidateMap;
+
+			static bool enabled;
+			const KernelConfiguration & kernelConfig;
+			unsigned int nEliminatedNodes;
+			/// private variables of the eliminated subexpressions
+			std::vector<Element> * declarations;
+			/// cache of the sources of the candidates
+			std::map<const ElementBase*, std::string> keys;
+			/// cache of the results of isCandidate()
+			std::map<const ElementBase*, bool> candidates;
+
+			std::vector<Element> optimizeBlock(const std::vector<Element> & block);
+			/// folds constants and simplifies the nodes of \p e
+			Element fold(const Element & e);
+			Element simplify(const Element & e);
+			/// counts the occurrences of the candidates within \p e
+			void collect(const Element & e, CandidateMap & active, CandidateMap & used);
+			/// removes candidates depending on the elements written by \p statement
+			void invalidate(const Element & statement, CandidateMap & active);
+			/// counts the occurrences not enclosed in another repeated candidate
+			void countEffective(const Element & e, CandidateMap & used);
+			/// replaces the repeated candidates by private variables
+			Element rewrite(const Element & e, CandidateMap & used, std::vector<Element> & initializations);
+
+			bool isCandidate(const Element & e);
+			const std::string & getKey(const Element & e);
+			bool isPure(const Element & e, int & rank, bool & variable);
+			TypeID promotedType(const Element & e);
+
+			static std::vector<Element> getOperands(const ElementBase * e);
+			/// flags operands which are always evaluated as values (not assignment targets)
+			static std::vector<bool> getValueOperands(const ElementBase * e, unsigned int n);
+			/// returns copy of \p e with operands \p operands or empty Element for unknown types
+			static Element copyWithOperands(const Element & e, const std::vector<Element> & operands);
+			static bool isArithmetic(const ElementBase * e);
+			static bool isPown(const ElementBase * e);
+			static unsigned int countNodes(const Element & e);
+		public:
+			explicit ExpressionOptimizer(const KernelConfiguration & kernelConfig_);
+			/// Returns optimized copy of \p expression, 
+			/// the introduced private variables are added to \p declarations_
+			std::vector<Element> optimize(const std::vector<Element> & expression,
+			                              std::vector<Element> & declarations_);
+			/// Returns number of nodes eliminated by the last call of optimize()
+			inline unsigned int getNEliminatedNodes() const;
+
+			/// Enables or disables the optimization of all kernels built afterwards
+			static void setEnabled(bool enabled_);
+			static bool isEnabled();
+	};
+
+//---------------------------- Implementation -----------------------------
+
+	inline unsigned int ExpressionOptimizer::getNEliminatedNodes() const
+	{
+		return nEliminatedNodes;
+	}
+
+} // namespace acl
+
+#endif // ACLEXPRESSIONOPTIMIZER_H
@@ -24,6 +24,15 @@
 #include "aclKernel.h"
 #include "../aclHardware.h"
 #include <acl/aclElementBase.h>
+#include <acl/DataTypes/aclMemBlock.h>
+#include <acl/DataTypes/aclVariable.h>
+#include "aclProgramCache.h"
+#include "aclParallelBuild.h"
+#include "aclKernelProfiler.h"
+#include "aclExpressionOptimizer.h"
+#include "aclKernelTuner.h"
+#include "aclStencilTiling.h"
+#include "aclStepRecorder.h"
 #include <iostream>
 #include "../../aslUtilities.h"
 #include <algorithm>
@@ -36,17 +45,37 @@ namespace acl
 {
 
 	unsigned int Kernel::kernelNum = 0;
+
+	// The name does not depend on the kernel id, so identical kernels
+	// generate identical sources and share one program, see ProgramCache
+	const string KERNEL_NAME("compute");
+	const string KERNEL_HEADER("__kernel void " + KERNEL_NAME + "(");
 	
 	Kernel::Kernel(const KernelConfiguration kernelConfig_):
 		groupsNumber(0),
+		requestedConfig(kernelConfig_),
 		kernelConfig(kernelConfig_),
-		kernelSource("")
+		kernelSource(""),
+		bytesRead(0),
+		bytesWritten(0),
+		argumentsSet(false),
+		nArgumentsSettings(0),
+		nEliminatedNodes(0),
+		tuningPending(false),
+		tiled(false),
+		indexListSize(0)
 	{
 		id = kernelNum;
 		++kernelNum;
 	}
 
 
+	Kernel::~Kernel()
+	{
+		ParallelBuild::removeKernel(this);
+	}
+
+
 	cl_uint Kernel::detectVectorWidth()
 	{
 		vector<cl_uint> widths;
@@ -136,22 +165,33 @@ namespace acl
 		
 	void Kernel::generateArguments()
 	{
+		string separator(",\n" + string(KERNEL_HEADER.size(), ' '));
 		for (unsigned int i = 0; i < arguments.size(); i++)
 		{
-			kernelSource += arguments[i]->getTypeSignature(kernelConfig) + ",\n                       ";
-			for (unsigned int j = 0; j < numToStr(id).size(); ++j)
-			{
-				kernelSource += " ";
-			}
+			kernelSource += arguments[i]->getTypeSignature(kernelConfig) + separator;
 		}
 		// drop all after the ',' of last parameter
-		kernelSource.erase(kernelSource.size() - 25 - numToStr(id).size());
+		kernelSource.erase(kernelSource.size() - separator.size());
 		kernelSource += ")\n{\n\t";
 	}
 
 
 	void Kernel::generateIndex()
 	{
+		if (indexList)
+		{
+			kernelSource += "uint listIndex = get_global_id(0);\n\t";
+			kernelSource += "if (listIndex >= " + indexListLength->getName() + ")\n\t\treturn;\n\t";
+			kernelSource += "uint " + INDEX + " = " + indexList->getName() + "[listIndex];\n";
+			return;
+		}
+
+		if (tiled)
+		{
+			kernelSource += tiling->getIndexCode();
+			return;
+		}
+
 		if (kernelConfig.local)
 		{
 			kernelSource += "uint " + INDEX + " = get_local_id(0);\n\t";
@@ -179,26 +219,78 @@ namespace acl
 		{
 			kernelSource += "\t" + localDeclarations[i]->getLocalDeclaration(kernelConfig) + ";\n";
 		}
+		for (unsigned int i = 0; i < optimizedDeclarations.size(); i++)
+		{
+			kernelSource += "\t" + optimizedDeclarations[i]->getLocalDeclaration(kernelConfig) + ";\n";
+		}
+	}
+
+
+	void Kernel::optimizeExpressions()
+	{
+		optimizedDeclarations.clear();
+		if (ExpressionOptimizer::isEnabled())
+		{
+			ExpressionOptimizer optimizer(kernelConfig);
+			optimizedExpression = optimizer.optimize(expression, optimizedDeclarations);
+			nEliminatedNodes = optimizer.getNEliminatedNodes();
+		}
+		else
+		{
+			optimizedExpression = expression;
+			nEliminatedNodes = 0;
+		}
 	}
 
 
 	void Kernel::generateExpressions()
 	{
-		for (unsigned int i = 0; i < expression.size(); i++)
+		// the work-items out of the range take part only in the loading of the tiles
+		string indent("\t");
+		if (tiled)
+		{
+			kernelSource += "\tif (" + StencilTiling::INSIDE + ")\n\t{\n";
+			indent = "\t\t";
+		}
+
+		for (unsigned int i = 0; i < optimizedExpression.size(); i++)
 		{
-			kernelSource += "\t" + expression[i]->str(kernelConfig)  + ";\n";
+			string statement(optimizedExpression[i]->str(kernelConfig));
+			if (tiled)
+				statement = tiling->adaptStatement(statement);
+			kernelSource += indent + statement + ";\n";
 		}
 
+		if (tiled)
+		{
+			kernelSource += "\t}\n";
+			kernelSource += tiling->getClosingCode();
+		}
 		kernelSource += "}";
 	}
 
 
 	void Kernel::generateKernelSource()
 	{
-		kernelSource = "__kernel void compute_" + numToStr(id) + "(";
+		kernelSource = KERNEL_HEADER;
 		
+		if (indexList)
+		{
+			arguments.push_back(indexList);
+			arguments.push_back(indexListLength);
+		}
 		filterDeclarations();
 
+		declarationVersions.resize(localDeclarations.size());
+		for (unsigned int i = 0; i < localDeclarations.size(); ++i)
+			declarationVersions[i] = localDeclarations[i]->getArgumentVersion();
+
+		optimizeExpressions();
+
+		if (tiled)
+			optimizedExpression = tiling->apply(optimizedExpression, writtenArguments, 
+			                                    size, queue, kernelConfig.marching);
+
 		generateArguments();
 
 		generateIndex();
@@ -216,51 +308,105 @@ namespace acl
 
 
 	void Kernel::buildKernel()
+	{
+		ParallelBuild::removeKernel(this);
+		bindKernel(programCache.getProgram(kernelSource, queue));
+	}
+
+
+	void Kernel::bindKernel(const cl::Program & program)
 	{
 		cl_int status = 0;
+
+		kernel = cl::Kernel(program, KERNEL_NAME.c_str(), &status);
+		errorMessage(status, "Kernel() - kernelBase_" + numToStr(id));
+		argumentsSet = false;
+
+		// the compiled kernel may support smaller work-groups than the device,
+		// the tile is reduced and the kernel is rebuilt
+		if (tiled)
+		{
+			size_t maxGroupSize(kernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(getDevice(queue)));
+			if (tiling->getGroupSize() > maxGroupSize)
+			{
+				tiling->setGroupSizeLimit(maxGroupSize);
+				generateKernelSource();
+				buildKernel();
+			}
+		}
+//		cout<<"  "<<KERNEL_NAME<<": privMem="<< getKernelPrivateMemSize(*this)<<endl;
 		
-		cl::Program::Sources source(1, make_pair(kernelSource.data(), kernelSource.size()));
+	}
 
-		cl::Program program = cl::Program(getContext(queue), source, &status);
-		errorMessage(status, "Program::Program()");
-		status = program.build(std::vector<cl::Device>(1, getDevice(queue)));
 
-		if (status == CL_BUILD_PROGRAM_FAILURE)
+	void Kernel::setKernelArguments()
+	{
+		argumentVersions.resize(arguments.size());
+		for (unsigned int i = 0; i < arguments.size(); ++i)
 		{
-			string str = program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(getDevice(queue));
-
-			cout << " \n\t\t\tBUILD LOG\n";
-			cout << " ************************************************\n";
-			cout << str << endl;
-			cout << " ************************************************\n";
-			cout << " \n\t\t\tKERNEL SOURCE CODE\n";
-			cout << " ------------------------------------------------\n";
-			cout << kernelSource << endl;
-			cout << " ------------------------------------------------\n";
+			unsigned int version(arguments[i]->getArgumentVersion());
+			if (!argumentsSet || version != argumentVersions[i])
+			{
+				arguments[i]->setAsArgument(kernel, i);
+				argumentVersions[i] = version;
+				++nArgumentsSettings;
+			}
 		}
+		argumentsSet = true;
+	}
 
-		errorMessage(status, "Program::build()");
 
-		string kernelName;
-		kernelName = "compute_" + numToStr(id);
-		kernel = cl::Kernel(program, kernelName.c_str(), &status);
-		errorMessage(status, "Kernel() - kernelBase_" + numToStr(id));
-//		cout<<"  "<<kernelName<<": privMem="<< getKernelPrivateMemSize(*this)<<endl;
-		
+	bool Kernel::declarationsChanged()
+	{
+		for (unsigned int i = 0; i < declarationVersions.size(); ++i)
+			if (localDeclarations[i]->getArgumentVersion() != declarationVersions[i])
+				return true;
+		return false;
 	}
 
 
-	void Kernel::setKernelArguments()
+	void Kernel::collectMemBlockArguments()
 	{
+		memBlockArguments.clear();
+		memBlockArgumentsWritten.clear();
+		bytesRead = 0;
+		bytesWritten = 0;
 		for (unsigned int i = 0; i < arguments.size(); ++i)
 		{
-			arguments[i]->setAsArgument(kernel, i);
+			shared_ptr<MemBlock> m(dynamic_pointer_cast<MemBlock>(arguments[i]));
+			if (m)
+			{
+				memBlockArguments.push_back(m);
+				// writtenArguments is sorted by filterDeclarations()
+				memBlockArgumentsWritten.push_back(binary_search(writtenArguments.begin(),
+				                                                 writtenArguments.end(),
+				                                                 arguments[i]));
+				cl_ulong bytes(min(indexList ? indexListSize : size, m->getSize()) * m->getElementSize());
+				// the read-modify-write arguments are accounted in both directions
+				if (memBlockArgumentsWritten.back())
+					bytesWritten += bytes;
+				if (!memBlockArgumentsWritten.back() ||
+				    binary_search(readArguments.begin(), readArguments.end(), arguments[i]))
+					bytesRead += bytes;
+			}
 		}
 	}
 
 
 	void Kernel::updateKernelConfiguration()
 	{
+		// the configuration may be changed by KernelTuner
+		kernelConfig = requestedConfig;
+		// the marching mode needs no local memory
+		kernelConfig.marching = kernelConfig.marching && tiling && tiling->isMarchingSupported();
+		tiled = tiling && !kernelConfig.local && !indexList &&
+		        (kernelConfig.marching || StencilTiling::isSupported(queue));
+		// the tiled kernels and the kernels over an index list are scalar
+		if (tiled || indexList)
+		{
+			kernelConfig.vectorWidth = 1;
+			kernelConfig.unaligned = false;
+		}
 		// if it is a simd kernel - detect proper vector width
 		if (kernelConfig.vectorWidth > 1) 
 			kernelConfig.vectorWidth = detectVectorWidth();
@@ -278,41 +424,202 @@ namespace acl
 		if (kernelConfig.local && (groupsNumber == 0))
 			errorMessage("Kernel::setup() - groups number was not set");
 
+		if (kernelConfig.local && indexList)
+			errorMessage("Kernel::setup() - an index list can not be used with local kernels");
+
 		updateKernelConfiguration();
 		generateKernelSource();
-		buildKernel();
+		collectMemBlockArguments();
+
+		tuningPending = false;
+		if (kernelTuner.isEnabled() && !kernelConfig.local && !tiled && !indexList)
+		{
+			KernelConfiguration tuned(kernelConfig);
+			if (!kernelTuner.find(kernelSource, size, queue, tuned))
+				tuningPending = true;
+			else if (!(tuned == kernelConfig))
+			{
+				kernelConfig = tuned;
+				generateKernelSource();
+			}
+		}
+
+		kernel = cl::Kernel();
+		if (ParallelBuild::active())
+			ParallelBuild::addKernel(this);
+		else
+			buildKernel();
 	}
 
 
 	inline unsigned int paddingElementsSIMD(unsigned int size, unsigned int vectorWidth);
 	
-	void Kernel::compute()
+	void Kernel::getRanges(cl::NDRange & globalRange, cl::NDRange & localRange)
 	{
-		if (regenerateKernelSource)
+		size_t paddedSize = (size + paddingElementsSIMD(size, kernelConfig.vectorWidth)) / kernelConfig.vectorWidth;
+		// if 4th argument is cl::NullRange - OpenCL implementation
+		// will determine how to break the global work-items into
+		// appropriate work-group instances
+		globalRange = kernelConfig.local ? cl::NDRange(groupsNumber * paddedSize) : cl::NDRange(paddedSize);
+		localRange = cl::NullRange;
+		if (kernelConfig.local)
+			localRange = cl::NDRange(paddedSize);
+		else if (indexList)
+			globalRange = cl::NDRange(indexListSize);
+		else if (tiled)
+		{
+			globalRange = tiling->getGlobalRange();
+			localRange = tiling->getLocalRange();
+		}
+		else if (kernelConfig.groupSize > 0)
+			localRange = cl::NDRange(kernelConfig.groupSize);
+	}
+
+
+	cl::Event Kernel::computeAsync()
+	{
+		// the changed values of stable Variables require new source,
+		// the program is usually found in the ProgramCache
+		if (regenerateKernelSource || declarationsChanged())
 			setup();
+		// the kernel set up within ParallelBuild is not built yet
+		if (kernel() == NULL)
+			buildKernel();
+		if (tuningPending)
+		{
+			// the benchmark launches are not part of a recorded step
+			StepRecorder::Suspension suspension;
+			kernelTuner.tune(*this);
+		}
+		if (StepRecorder::recording())
+			StepRecorder::addLaunch(this);
 	
 		cl_int status = 0;
 		cl::Event event;
+		vector<cl::Event> dependencies;
 
 		setKernelArguments();
 
-		size_t paddedSize = (size + paddingElementsSIMD(size, kernelConfig.vectorWidth)) / kernelConfig.vectorWidth;
-		// if 4th argument is cl::NullRange - OpenCL implementation
-		// will determine how to break the global work-items into
-		// appropriate work-group instances
-		status = queue->enqueueNDRangeKernel(kernel,
-	 	                                     cl::NullRange,
-	    	                                 kernelConfig.local ? cl::NDRange(groupsNumber * paddedSize) : cl::NDRange(paddedSize),
-	    	                                 kernelConfig.local ? cl::NDRange(paddedSize) : cl::NullRange,
-	    	                                 NULL,
-	    	                                 &event);
+		for (unsigned int i = 0; i < memBlockArguments.size(); ++i)
+			memBlockArguments[i]->getDependencies(dependencies, memBlockArgumentsWritten[i]);
+
+		cl::NDRange globalRange;
+		cl::NDRange localRange;
+		getRanges(globalRange, localRange);
+		// an empty index list launches nothing, the marker keeps the dependencies
+		if (indexList && indexListSize == 0)
+		{
+			status = queue->enqueueMarkerWithWaitList(&dependencies, &event);
+			errorMessage(status, "CommandQueue::enqueueMarkerWithWaitList() - kernel");
+		}
+		else
+		{
+			status = queue->enqueueNDRangeKernel(kernel,
+			                                     cl::NullRange,
+			                                     globalRange,
+			                                     localRange,
+			                                     &dependencies,
+			                                     &event);
+			errorMessage(status, "CommandQueue::enqueueNDRangeKernel() - kernel");
+		}
+
+		for (unsigned int i = 0; i < memBlockArguments.size(); ++i)
+			memBlockArguments[i]->registerAccess(event, memBlockArgumentsWritten[i]);
+
+		if (kernelProfiler.isEnabled())
+			kernelProfiler.registerLaunch(*this, event);
+
+		return event;
+	}
+
+
+	void Kernel::launchPrebound()
+	{
+		if (regenerateKernelSource || declarationsChanged())
+			setup();
+		if (kernel() == NULL)
+			buildKernel();
+		if (tuningPending)
+			kernelTuner.tune(*this);
+
+		if (indexList && indexListSize == 0)
+			return;
+
+		setKernelArguments();
+		cl::NDRange globalRange;
+		cl::NDRange localRange;
+		getRanges(globalRange, localRange);
+		cl_int status = queue->enqueueNDRangeKernel(kernel, cl::NullRange, globalRange, localRange);
 		errorMessage(status, "CommandQueue::enqueueNDRangeKernel() - kernel");
+	}
 
-		status = event.wait();
+
+	void Kernel::compute()
+	{
+		cl_int status = computeAsync().wait();
 		errorMessage(status, "Event::wait() - event");
 	}
 
 
+	void Kernel::setQueue(const CommandQueue & queue_)
+	{
+		if (!inSameContext(queue, queue_))
+			errorMessage("Kernel::setQueue() - the queue does not share the context with the kernel arguments");
+
+		if (queue != queue_)
+		{
+			queue = queue_;
+			regenerateKernelSource = true;
+		}
+	}
+
+
+	void Kernel::setTiling(const vector<unsigned int> & gridSize,
+	                       const vector<unsigned int> & tileSize)
+	{
+		if (gridSize.empty())
+			tiling.reset();
+		else
+			tiling.reset(new StencilTiling(gridSize, tileSize));
+		regenerateKernelSource = true;
+	}
+
+
+	void Kernel::setIndexList(Element list, unsigned int n)
+	{
+		if (list && list->getTypeID() != TYPE_UINT)
+			errorMessage("Kernel::setIndexList() - the list should be an array of cl_uint");
+		if (list && n > list->getSize())
+			errorMessage("Kernel::setIndexList() - the list is shorter than " + numToStr(n));
+
+		// only the change of the list requires a new source, the length is an argument
+		if (list != indexList)
+		{
+			if (indexList)
+			{
+				arguments.erase(remove(arguments.begin(), arguments.end(), indexList),
+				                arguments.end());
+				arguments.erase(remove(arguments.begin(), arguments.end(), Element(indexListLength)),
+				                arguments.end());
+			}
+			indexList = list;
+			regenerateKernelSource = true;
+		}
+		indexListSize = n;
+		if (!indexListLength)
+			indexListLength.reset(new Variable<cl_uint>(n));
+		else
+			indexListLength->setValue(n);
+	}
+
+
+	void Kernel::setMarching(bool flag)
+	{
+		requestedConfig.marching = flag;
+		regenerateKernelSource = true;
+	}
+
+
 	void Kernel::setGroupsNumber(unsigned int n)
 	{
 		groupsNumber = n;
@@ -329,7 +636,19 @@ namespace acl
 	}
 
 
-	unsigned int Kernel::getKernelID()
+	void Kernel::setLabel(const string & label_)
+	{
+		label = label_;
+	}
+
+
+	string Kernel::getLabel() const
+	{
+		return label.empty() ? "kernel_" + numToStr(id) : label;
+	}
+
+
+	unsigned int Kernel::getKernelID() const
 	{
 		return id;
 	}
@@ -343,11 +662,21 @@ namespace acl
 
 	void Kernel::clear()
 	{
-		kernelSource = "__kernel void compute_" + numToStr(id) + "(";
+		kernelSource = KERNEL_HEADER;
 		regenerateKernelSource = true;
 		expression.clear();
+		optimizedExpression.clear();
+		optimizedDeclarations.clear();
+		nEliminatedNodes = 0;
 		localDeclarations.clear();
 		arguments.clear();
+		writtenArguments.clear();
+		readArguments.clear();
+		memBlockArguments.clear();
+		memBlockArgumentsWritten.clear();
+		argumentVersions.clear();
+		declarationVersions.clear();
+		argumentsSet = false;
 		size = 0;
 	}
 
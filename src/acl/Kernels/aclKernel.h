@@ -35,6 +35,9 @@ namespace acl
 {
 
 	extern const KernelConfiguration KERNEL_BASIC;
+	class MemBlock;
+	class StencilTiling;
+	template <typename T> class Variable;
 	
 	/// OpenCl Kernel generator 
 	/**	
@@ -51,38 +54,135 @@ namespace acl
 			static unsigned int kernelNum;
 			unsigned int id;
 			unsigned int groupsNumber;
+			/// configuration passed to the constructor, \p kernelConfig is derived from it
+			KernelConfiguration requestedConfig;
 			KernelConfiguration kernelConfig;
 			std::string kernelSource;
 			cl::Kernel kernel;
+			/// name of the kernel in profiling reports
+			std::string label;
+			/// estimated number of bytes read by a launch
+			cl_ulong bytesRead;
+			/// estimated number of bytes written by a launch
+			cl_ulong bytesWritten;
+			/// MemBlock arguments, used for tracking of dependencies between launches
+			std::vector<std::shared_ptr<MemBlock> > memBlockArguments;
+			/// flags whether corresponding elements of \p memBlockArguments are written
+			std::vector<bool> memBlockArgumentsWritten;
+			/// versions of the arguments at the moment of their last setting
+			std::vector<unsigned int> argumentVersions;
+			/// versions of the local declarations used for the source generation;
+			/// stable Variables are emitted as literals, see Variable::setStable()
+			std::vector<unsigned int> declarationVersions;
+			/// false if the arguments of \p kernel have never been set
+			bool argumentsSet;
+			/// number of arguments set since creation of the kernel
+			unsigned int nArgumentsSettings;
+			/// \p expression after ExpressionOptimizer, used for the source generation
+			std::vector<Element> optimizedExpression;
+			/// private variables introduced by ExpressionOptimizer
+			std::vector<Element> optimizedDeclarations;
+			/// number of nodes eliminated by ExpressionOptimizer
+			unsigned int nEliminatedNodes;
+			/// true if the kernel is benchmarked on the next launch, see KernelTuner
+			bool tuningPending;
+			/// tiled execution of the stencil reads, see setTiling()
+			std::shared_ptr<StencilTiling> tiling;
+			/// true if \p tiling is used by the current source
+			bool tiled;
+			/// indices of the points processed by the kernel, see setIndexList()
+			Element indexList;
+			unsigned int indexListSize;
+			/// the length of \p indexList passed as a kernel argument, so that
+			/// lists of different length share one program
+			std::shared_ptr<Variable<cl_uint> > indexListLength;
 
 			/// detects minimal vector width of all available types of Elements
 			cl_uint detectVectorWidth();
+			void optimizeExpressions();
 			void generateExtensions();
 			void generateArguments();
 			void generateIndex();
 			void generateLocalDeclarations();
-			void generateExpressions();
+			virtual void generateExpressions();
 			virtual void generateKernelSource();
 			void updateKernelConfiguration();
 			void buildKernel();
+			/// creates \p kernel from the built \p program
+			void bindKernel(const cl::Program & program);
 			void setKernelArguments();
+			/// true if a value emitted into the source has changed since its generation
+			bool declarationsChanged();
+			void collectMemBlockArguments();
+			/// global and local ranges of a launch
+			void getRanges(cl::NDRange & globalRange, cl::NDRange & localRange);
+			/// Launches the kernel without dependency tracking, used by StepRecorder
+			void launchPrebound();
 		public:
 			explicit Kernel(const KernelConfiguration kernelConfig_ = KERNEL_BASIC);
+			~Kernel();
 			/// Prepares kernel for launch.
 			/// Should always be called before compute() after all expressions are added.
 			/// Generates kernel source, builds kernel and sets its arguments.
+			/// Within the scope of ParallelBuild the build is deferred.
 			void setup();
+			/// Launches the kernel and waits till it is finished
 			void compute();
+			/// Launches the kernel without waiting for its completion.
+			/// The launch waits only for the commands accessing the same MemBlock
+			/// arguments with a read-after-write, write-after-read or 
+			/// write-after-write hazard. acl::copy() and MemBlock::map()
+			/// wait for the launch in turn.
+			cl::Event computeAsync();
+			/// Sets the queue the kernel is launched on. The queue has to share 
+			/// the context with the queues of the arguments; the kernel is rebuilt.
+			void setQueue(const CommandQueue & queue_);
 			void setGroupsNumber(unsigned int n);
 			unsigned int getGroupsNumber();			
 			std::string getKernelSource();
-			unsigned int getKernelID();
+			unsigned int getKernelID() const;
 			const cl::Kernel & getKernel() const;
+			/// Returns number of the kernel arguments set so far. Arguments are
+			/// set only if they were changed since the previous launch
+			inline unsigned int getNArgumentsSettings() const;
+			void setLabel(const std::string & label_);
+			/// Returns the label, "kernel_<id>" if no label was set
+			std::string getLabel() const;
+			/// Returns estimated number of bytes read by a launch;
+			/// the kernel size is accounted for each MemBlock argument that is read
+			inline cl_ulong getBytesRead() const;
+			/// Returns estimated number of bytes written by a launch;
+			/// the kernel size is accounted for each written MemBlock argument
+			inline cl_ulong getBytesWritten() const;
+			/// Returns number of expression nodes eliminated by constant folding 
+			/// and common subexpression elimination, see ExpressionOptimizer
+			inline unsigned int getNEliminatedNodes() const;
+			/// Enables tiled execution, see StencilTiling: the index space is a grid 
+			/// of size \p gridSize, its last dimension is contiguous in memory.
+			/// Empty \p tileSize selects the default tile, empty \p gridSize disables 
+			/// the tiling. The tiling is ignored on devices without dedicated local memory.
+			void setTiling(const std::vector<unsigned int> & gridSize,
+			               const std::vector<unsigned int> & tileSize = std::vector<unsigned int>());
+			/// Returns true if the current source reads the stencils from local memory tiles
+			/// or, in the marching mode, from the rolled registers
+			inline bool isTiled() const;
+			/// Launches the kernel only for the indices stored in the first \p n 
+			/// elements of \p list (Array<cl_uint>): the index of each work-item
+			/// is read from the list. Such kernels are scalar; NULL \p list restores
+			/// the launch over the whole index space
+			void setIndexList(Element list, unsigned int n);
+			/// Sets KernelConfiguration::marching of the requested configuration;
+			/// the marching mode is used only with the grid given by setTiling()
+			void setMarching(bool flag = true);
 			/// removes all expressions from the kernel
 			void clear();
 			inline const KernelConfiguration & getConfiguration()const;
 
 			friend class KernelMerger;
+			friend class KernelFusion;
+			friend class ParallelBuild;
+			friend class KernelTuner;
+			friend class StepRecorder;
 	};
 
 	/// \related Kernel
@@ -108,6 +208,36 @@ namespace acl
 		}
 	}
 
+	inline cl_ulong Kernel::getBytesRead() const
+	{
+		return bytesRead;
+	}
+
+
+	inline cl_ulong Kernel::getBytesWritten() const
+	{
+		return bytesWritten;
+	}
+
+
+	inline unsigned int Kernel::getNEliminatedNodes() const
+	{
+		return nEliminatedNodes;
+	}
+
+
+	inline bool Kernel::isTiled() const
+	{
+		return tiled;
+	}
+
+
+	inline unsigned int Kernel::getNArgumentsSettings() const
+	{
+		return nArgumentsSettings;
+	}
+
+
 	inline const KernelConfiguration & Kernel::getConfiguration()const
 	{
 		return kernelConfig;
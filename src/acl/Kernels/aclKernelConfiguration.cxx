@@ -36,7 +36,9 @@ KernelConfiguration::KernelConfiguration(bool simd,
 	// detected and overwritten by the Kernel
 	vectorWidth(simd ? 2 : 1),
 	unaligned(unaligned_),
-	local(local_)
+	local(local_),
+	groupSize(0),
+	marching(false)
 
 {
 }
@@ -45,7 +47,9 @@ KernelConfiguration::KernelConfiguration(bool simd,
 KernelConfiguration::KernelConfiguration(const KernelConfiguration & kernelConfig_):
 	vectorWidth(kernelConfig_.vectorWidth),
 	unaligned(kernelConfig_.unaligned),
-	local(kernelConfig_.local)
+	local(kernelConfig_.local),
+	groupSize(kernelConfig_.groupSize),
+	marching(kernelConfig_.marching)
 
 {
 	extensions = kernelConfig_.extensions;
@@ -59,6 +63,8 @@ bool KernelConfiguration::operator==(const KernelConfiguration & a) const
 	equal = (vectorWidth == a.vectorWidth)
 			&& (unaligned == a.unaligned)
 			&& (local == a.local)
+			&& (groupSize == a.groupSize)
+			&& (marching == a.marching)
 			&& (extensions == a.extensions);
 
 	return equal;
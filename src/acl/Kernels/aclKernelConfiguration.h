@@ -43,6 +43,12 @@ namespace acl
 			unsigned int vectorWidth;
 			bool unaligned;
 			bool local;
+			/// work-group size of the kernels with \p local = false;
+			/// 0 lets the OpenCL implementation choose it, see KernelTuner
+			unsigned int groupSize;
+			/// work-items march along the slowest dimension of the grid set by
+			/// Kernel::setTiling(), see StencilTiling
+			bool marching;
 			std::vector<std::string> extensions;
 	};
 
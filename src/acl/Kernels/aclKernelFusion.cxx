@@ -0,0 +1,296 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "aclKernelFusion.h"
+#include "aclKernel.h"
+#include "aclParallelBuild.h"
+#include <acl/acl.h>
+#include "acl/DataTypes/aclMemBlock.h"
+#include <aslUtilities.h>
+#include <algorithm>
+
+using namespace std;
+using namespace asl;
+
+namespace acl
+{
+
+	inline bool isIdentifierCharacter(char c)
+	{
+		return isalnum(c) || (c == '_');
+	}
+
+
+	/// Returns positions of the occurrences of the identifier \p name in \p source
+	vector<size_t> findIdentifier(const string & source, const string & name)
+	{
+		vector<size_t> positions;
+		size_t found(source.find(name));
+		while (found != string::npos)
+		{
+			size_t end(found + name.size());
+			if ((found == 0 || !isIdentifierCharacter(source[found - 1])) &&
+			    (end == source.size() || !isIdentifierCharacter(source[end])))
+				positions.push_back(found);
+			found = source.find(name, end);
+		}
+		return positions;
+	}
+
+
+	/// Checks whether all accesses to \p name in \p source are "name[index]".
+	/// If \p addressAllowed is false the address of the access
+	/// must not be taken (vload, vstore, atomic functions).
+	bool accessedAtOwnIndex(const string & source, const string & name, bool addressAllowed)
+	{
+		const string access(name + "[" + INDEX + "]");
+		vector<size_t> positions(findIdentifier(source, name));
+		for (unsigned int i(0); i < positions.size(); ++i)
+		{
+			if (source.compare(positions[i], access.size(), access) != 0)
+				return false;
+			if (!addressAllowed && positions[i] > 0 && source[positions[i] - 1] == '&')
+				return false;
+		}
+		return true;
+	}
+
+
+	/// Kernel generated by KernelFusion
+	/**
+		 MemBlocks accessed several times, all of them at the own index,
+		 are loaded into private variables at the beginning and
+		 stored at the end, if written
+	*/
+	class FusedKernel: public Kernel
+	{
+		protected:
+			virtual void generateExpressions();
+		public:
+			explicit FusedKernel(const KernelConfiguration & kernelConfig_);
+	};
+
+
+	FusedKernel::FusedKernel(const KernelConfiguration & kernelConfig_):
+		Kernel(kernelConfig_)
+	{
+	}
+
+
+	void FusedKernel::generateExpressions()
+	{
+		string body;
+		for (unsigned int i = 0; i < optimizedExpression.size(); i++)
+		{
+			body += "\t" + optimizedExpression[i]->str(kernelConfig) + ";\n";
+		}
+
+		string loads;
+		string stores;
+		// unaligned vector kernels access the MemBlocks through vload/vstore
+		if (!kernelConfig.unaligned || kernelConfig.vectorWidth == 1)
+		{
+			for (unsigned int i = 0; i < arguments.size(); ++i)
+			{
+				shared_ptr<MemBlock> m(dynamic_pointer_cast<MemBlock>(arguments[i]));
+				if (!m)
+					continue;
+				const string name(m->getName());
+				vector<size_t> positions(findIdentifier(body, name));
+				if (positions.size() < 2 || !accessedAtOwnIndex(body, name, false))
+					continue;
+
+				const string access(name + "[" + INDEX + "]");
+				const string privateName(name + "_fused");
+				// replace from the end, so the positions remain valid
+				for (unsigned int j(positions.size()); j > 0; --j)
+					body.replace(positions[j - 1], access.size(), privateName);
+
+				string type(TYPE[m->getTypeID()]);
+				if (kernelConfig.vectorWidth > 1)
+					type += numToStr(kernelConfig.vectorWidth);
+				loads += "\t" + type + " " + privateName + " = " + access + ";\n";
+				// writtenArguments is sorted by filterDeclarations()
+				if (binary_search(writtenArguments.begin(), writtenArguments.end(), arguments[i]))
+					stores += "\t" + access + " = " + privateName + ";\n";
+			}
+		}
+
+		kernelSource += loads + body + stores + "}";
+	}
+
+
+	KernelFusion::KernelFusion()
+	{
+	}
+
+
+	bool KernelFusion::fusible(unsigned int first, unsigned int last)
+	{
+		const Kernel & k0(*kernels[first]);
+		const Kernel & k(*kernels[last]);
+		if (k0.kernelConfig.local || !(k.kernelConfig == k0.kernelConfig))
+			return false;
+		if ((k.size != k0.size) || (k.queue.get() != k0.queue.get()))
+			return false;
+
+		string source;
+		vector<Element> arguments;
+		vector<Element> writtenArguments;
+		for (unsigned int i(first); i <= last; ++i)
+		{
+			const Kernel & ki(*kernels[i]);
+			for (unsigned int j(0); j < ki.expression.size(); ++j)
+				source += ki.expression[j]->str(ki.kernelConfig) + ";\n";
+			arguments.insert(arguments.end(), ki.arguments.begin(), ki.arguments.end());
+			writtenArguments.insert(writtenArguments.end(),
+			                        ki.writtenArguments.begin(),
+			                        ki.writtenArguments.end());
+		}
+
+		// a return or a barrier within one kernel would skip or block 
+		// the expressions of the others and the final stores
+		if (!findIdentifier(source, "return").empty() || 
+		    !findIdentifier(source, "barrier").empty())
+			return false;
+
+		sort(writtenArguments.begin(), writtenArguments.end());
+		for (unsigned int i(0); i < arguments.size(); ++i)
+		{
+			if (!isMemBlock(arguments[i]))
+				continue;
+			if (isSubvector(arguments[i]))
+				return false;
+			if (binary_search(writtenArguments.begin(), writtenArguments.end(), arguments[i]) &&
+			    !accessedAtOwnIndex(source, arguments[i]->getName(), true))
+			{
+				// a written MemBlock accessed at other indices is harmless only 
+				// within a single kernel
+				bool usedByNew(find(k.arguments.begin(), k.arguments.end(), arguments[i]) != k.arguments.end());
+				bool usedByPrevious(false);
+				for (unsigned int j(first); j < last; ++j)
+					usedByPrevious |= (find(kernels[j]->arguments.begin(),
+					                        kernels[j]->arguments.end(),
+					                        arguments[i]) != kernels[j]->arguments.end());
+				if (usedByNew && usedByPrevious)
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+
+	SPKernel KernelFusion::fuse(unsigned int first, unsigned int last)
+	{
+		if (last - first == 1)
+			return kernels[first];
+
+		SPKernel k(new FusedKernel(kernels[first]->kernelConfig));
+		string label(kernels[first]->getLabel());
+		for (unsigned int i(first); i < last; ++i)
+		{
+			for (unsigned int j(0); j < kernels[i]->expression.size(); ++j)
+				k->addExpression(kernels[i]->expression[j]);
+			if (i > first)
+				label += " * " + kernels[i]->getLabel();
+		}
+		k->setQueue(kernels[first]->getQueue());
+		k->setLabel(label);
+
+		return k;
+	}
+
+
+	void KernelFusion::setup()
+	{
+		if (!kernels.size())
+			errorMessage("KernelFusion::setup() : no kernels have been added."); 
+
+		fusedKernels.clear();
+		unsigned int first(0);
+		for (unsigned int i(1); i <= kernels.size(); ++i)
+		{
+			if ((i < kernels.size()) && fusible(first, i))
+				continue;
+			fusedKernels.push_back(fuse(first, i));
+			first = i;
+		}
+
+		ParallelBuild parallelBuild;
+		for (unsigned int i(0); i < fusedKernels.size(); ++i)
+			fusedKernels[i]->setup();
+		parallelBuild.build();
+	}
+
+
+	void KernelFusion::compute()
+	{
+		cl_int status = computeAsync().wait();
+		errorMessage(status, "Event::wait() - event");
+	}
+
+
+	cl::Event KernelFusion::computeAsync()
+	{
+		cl::Event event;
+		for (unsigned int i(0); i < fusedKernels.size(); ++i)
+			event = fusedKernels[i]->computeAsync();
+		return event;
+	}
+
+
+	string KernelFusion::getKernelSource()
+	{
+		string source;
+		for (unsigned int i(0); i < fusedKernels.size(); ++i)
+			source += fusedKernels[i]->getKernelSource() + "\n\n";
+		return source;
+	}
+
+
+	void KernelFusion::clear()
+	{
+		kernels.clear();
+		fusedKernels.clear();
+	}
+
+
+	void KernelFusion::addKernel(SPKernel k)
+	{
+		kernels.push_back(k);
+	}
+
+
+	void KernelFusion::addKernel(const KernelFusion & kf)
+	{
+		kernels.insert(kernels.end(), kf.kernels.begin(), kf.kernels.end());
+	}
+
+
+	unsigned int KernelFusion::getNKernels()
+	{
+		return fusedKernels.size();
+	}
+
+} // namespace acl
@@ -0,0 +1,91 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ACLKERNELFUSION_H
+#define ACLKERNELFUSION_H
+
+#include <memory>
+#include <vector>
+//#include <CL/cl.hpp>
+// Supply "cl.hpp" with ASL, since it is not present in OpenCL 2.0
+// Remove the file after switching to OpenCL 2.1
+#include "acl/cl.hpp"
+
+namespace acl
+{
+	class Kernel;
+	typedef std::shared_ptr<Kernel> SPKernel;
+
+	/// OpenCl Kernel fusion
+	/**	
+		\ingroup KernelGen
+		The KernelFusion joins the expressions of consecutive kernels with 
+		the same size, configuration and queue into a single kernel, so each
+		work item executes the expressions of all of them one after another.
+		Unlike KernelMerger, which places the kernels next to each other
+		in the index space, the fused kernels share the index space. 
+
+		A kernel is fused with the preceding ones only if each MemBlock written
+		by one of them and used by another is accessed at the own index of the 
+		work item only; accesses at other indices (e.g. stencils) would create 
+		read-after-write or write-after-read hazards between work items.
+		Kernels with local memory and Subvectors, which alias their vectors,
+		are not fused. Neither are kernels containing a return statement 
+		(e.g. the map check of asl::SingleKernelMapNM) or a barrier.
+
+		Within a fused kernel each MemBlock accessed several times, all of them 
+		at the own index, is loaded once into a private variable and, 
+		if it is written, stored once at the end.
+	*/
+	class KernelFusion
+	{
+		private:
+			std::vector<SPKernel> kernels;
+			/// kernels launched by compute(), each fuses a sequence of \p kernels
+			std::vector<SPKernel> fusedKernels;
+
+			/// checks whether kernels[\p last] can join kernels[\p first] ... kernels[\p last - 1]
+			bool fusible(unsigned int first, unsigned int last);
+			SPKernel fuse(unsigned int first, unsigned int last);
+		public:
+			KernelFusion();
+			void setup();
+			/// Launches the fused kernels and waits till they are finished
+			void compute();
+			/// Launches the fused kernels without waiting, see Kernel::computeAsync()
+			cl::Event computeAsync();
+			std::string getKernelSource();
+			/// removes all kernels
+			void clear();
+			void addKernel(SPKernel k);
+			void addKernel(const KernelFusion & kf);
+			/// Returns number of kernels launched by compute(), available after setup()
+			unsigned int getNKernels();
+	};
+
+	/// \related Kernel
+	typedef std::shared_ptr<KernelFusion> SPKernelFusion;
+
+} // namespace acl
+
+#endif // ACLKERNELFUSION_H
@@ -42,6 +42,12 @@ namespace acl
 		kernel->compute();		
 	}
 
+
+	cl::Event KernelMerger::computeAsync()
+	{
+		return kernel->computeAsync();
+	}
+
 	unsigned int KernelMerger::getKernelSize(unsigned int i)
 	{
 		const KernelConfiguration &kc(kernels[i]->kernelConfig);
@@ -108,6 +114,10 @@ namespace acl
 		if (kernels.size() > 1)
 		{
 			kernel.reset(new Kernel(kernels[0]->kernelConfig));
+			string label(kernels[0]->getLabel());
+			for (unsigned int i(1); i < kernels.size(); ++i)
+				label += " + " + kernels[i]->getLabel();
+			kernel->setLabel(label);
 			computeOffsets();
 			kernel->addExpression(castSpliter(0, kernels.size() - 1));		
 		}
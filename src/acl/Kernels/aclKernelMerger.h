@@ -26,6 +26,10 @@
 
 #include <memory>
 #include <vector>
+//#include <CL/cl.hpp>
+// Supply "cl.hpp" with ASL, since it is not present in OpenCL 2.0
+// Remove the file after switching to OpenCL 2.1
+#include "acl/cl.hpp"
 
 namespace acl
 {
@@ -58,6 +62,8 @@ namespace acl
 			KernelMerger();
 			void setup();
 			void compute();
+			/// Launches the merged kernel without waiting, see Kernel::computeAsync()
+			cl::Event computeAsync();
 			std::string getKernelSource();
 			/// removes all kernels
 			void clear();
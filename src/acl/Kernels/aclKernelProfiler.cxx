@@ -0,0 +1,241 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include "aclKernelProfiler.h"
+#include "aclKernel.h"
+#include "../aclHardware.h"
+#include "../../aslUtilities.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+using namespace std;
+using namespace asl;
+
+namespace acl
+{
+
+	KernelProfiler kernelProfiler;
+
+	// the events are accounted in portions in order to limit the memory usage
+	const unsigned int MAX_PENDING_LAUNCHES(4096);
+
+
+	KernelProfiler::Record::Record():
+		kernelID(0),
+		launches(0),
+		totalTime(0),
+		maxTime(0),
+		bytesRead(0),
+		bytesWritten(0)
+	{
+	}
+
+
+	double KernelProfiler::Record::meanTime() const
+	{
+		return launches > 0 ? totalTime / launches : 0;
+	}
+
+
+	double KernelProfiler::Record::bandwidth() const
+	{
+		return totalTime > 0 ? (double)launches * (bytesRead + bytesWritten) / totalTime * 1e-9 : 0;
+	}
+
+
+	bool compareTotalTime(const KernelProfiler::Record & a, const KernelProfiler::Record & b)
+	{
+		return a.totalTime > b.totalTime;
+	}
+
+
+	KernelProfiler::KernelProfiler():
+		enabled(false)
+	{
+	}
+
+
+	void KernelProfiler::enable()
+	{
+		if (!enabled)
+			hardware.enableProfiling();
+		enabled = true;
+	}
+
+
+	void KernelProfiler::registerLaunch(const Kernel & kernel, const cl::Event & event)
+	{
+		Record & r(records[kernel.getKernelID()]);
+		r.label = kernel.getLabel();
+		r.kernelID = kernel.getKernelID();
+		r.bytesRead = kernel.getBytesRead();
+		r.bytesWritten = kernel.getBytesWritten();
+
+		pendingLaunches.push_back(make_pair(kernel.getKernelID(), event));
+		if (pendingLaunches.size() >= MAX_PENDING_LAUNCHES)
+			collect();
+	}
+
+
+	void KernelProfiler::collect()
+	{
+		cl_int status = 0;
+		for (unsigned int i = 0; i < pendingLaunches.size(); ++i)
+		{
+			cl::Event & event(pendingLaunches[i].second);
+			status = event.wait();
+			errorMessage(status, "KernelProfiler::collect() - Event::wait()");
+
+			cl_ulong start(event.getProfilingInfo<CL_PROFILING_COMMAND_START>(&status));
+			errorMessage(status, "KernelProfiler::collect() - CL_PROFILING_COMMAND_START");
+			cl_ulong end(event.getProfilingInfo<CL_PROFILING_COMMAND_END>(&status));
+			errorMessage(status, "KernelProfiler::collect() - CL_PROFILING_COMMAND_END");
+
+			Record & r(records[pendingLaunches[i].first]);
+			double time((end - start) * 1e-9);
+			++r.launches;
+			r.totalTime += time;
+			r.maxTime = max(r.maxTime, time);
+		}
+		pendingLaunches.clear();
+	}
+
+
+	vector<KernelProfiler::Record> KernelProfiler::getRecords()
+	{
+		collect();
+
+		vector<Record> v;
+		for (map<unsigned int, Record>::iterator it(records.begin()); it != records.end(); ++it)
+			v.push_back(it->second);
+		stable_sort(v.begin(), v.end(), compareTotalTime);
+		return v;
+	}
+
+
+	void KernelProfiler::reset()
+	{
+		collect();
+		records.clear();
+	}
+
+
+	string KernelProfiler::report()
+	{
+		vector<Record> v(getRecords());
+
+		double total(0);
+		for (unsigned int i = 0; i < v.size(); ++i)
+			total += v[i].totalTime;
+
+		stringstream s;
+		s << left << setw(32) << "label" << right
+		  << setw(8) << "id"
+		  << setw(10) << "launches"
+		  << setw(12) << "mean, ms"
+		  << setw(12) << "max, ms"
+		  << setw(12) << "total, ms"
+		  << setw(8) << "%"
+		  << setw(10) << "GB/s" << "\n";
+		s << fixed;
+		for (unsigned int i = 0; i < v.size(); ++i)
+		{
+			s << left << setw(32) << v[i].label << right
+			  << setw(8) << v[i].kernelID
+			  << setw(10) << v[i].launches
+			  << setw(12) << setprecision(3) << v[i].meanTime() * 1e3
+			  << setw(12) << setprecision(3) << v[i].maxTime * 1e3
+			  << setw(12) << setprecision(1) << v[i].totalTime * 1e3
+			  << setw(8) << setprecision(1) << (total > 0 ? v[i].totalTime / total * 100. : 0.)
+			  << setw(10) << setprecision(2) << v[i].bandwidth() << "\n";
+		}
+		return s.str();
+	}
+
+
+	string escapeJSON(const string & s)
+	{
+		string r;
+		for (unsigned int i = 0; i < s.size(); ++i)
+		{
+			if (s[i] == '"' || s[i] == '\\')
+				r += '\\';
+			r += s[i];
+		}
+		return r;
+	}
+
+
+	void KernelProfiler::writeJSON(const string & fileName)
+	{
+		vector<Record> v(getRecords());
+
+		std::ofstream fo(fileName);
+		if (!fo.good())
+			errorMessage("KernelProfiler::writeJSON() - can not open file: " + fileName);
+
+		fo << "[\n";
+		for (unsigned int i = 0; i < v.size(); ++i)
+		{
+			fo << "\t{\"label\": \"" << escapeJSON(v[i].label) << "\""
+			   << ", \"id\": " << v[i].kernelID
+			   << ", \"launches\": " << v[i].launches
+			   << ", \"mean_s\": " << v[i].meanTime()
+			   << ", \"max_s\": " << v[i].maxTime
+			   << ", \"total_s\": " << v[i].totalTime
+			   << ", \"bytes_read\": " << v[i].bytesRead
+			   << ", \"bytes_written\": " << v[i].bytesWritten
+			   << ", \"bandwidth_GBps\": " << v[i].bandwidth()
+			   << "}" << (i + 1 < v.size() ? "," : "") << "\n";
+		}
+		fo << "]\n";
+	}
+
+
+	void KernelProfiler::writeCSV(const string & fileName)
+	{
+		vector<Record> v(getRecords());
+
+		std::ofstream fo(fileName);
+		if (!fo.good())
+			errorMessage("KernelProfiler::writeCSV() - can not open file: " + fileName);
+
+		fo << "label,id,launches,mean_s,max_s,total_s,bytes_read,bytes_written,bandwidth_GBps\n";
+		for (unsigned int i = 0; i < v.size(); ++i)
+		{
+			fo << "\"" << v[i].label << "\","
+			   << v[i].kernelID << ","
+			   << v[i].launches << ","
+			   << v[i].meanTime() << ","
+			   << v[i].maxTime << ","
+			   << v[i].totalTime << ","
+			   << v[i].bytesRead << ","
+			   << v[i].bytesWritten << ","
+			   << v[i].bandwidth() << "\n";
+		}
+	}
+
+} // namespace acl
@@ -0,0 +1,114 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef ACLKERNELPROFILER_H
+#define ACLKERNELPROFILER_H
+
+#include <map>
+#include <string>
+#include <vector>
+//#include <CL/cl.hpp>
+// Supply "cl.hpp" with ASL, since it is not present in OpenCL 2.0
+// Remove the file after switching to OpenCL 2.1
+#include "acl/cl.hpp"
+
+namespace acl
+{
+	class Kernel;
+
+	/// Collects execution times of kernels
+	/**	
+		\ingroup KernelGen
+		The profiling is opt-in: enable() recreates the queues with 
+		CL_QUEUE_PROFILING_ENABLE, afterwards every launch of a Kernel is 
+		timed by the START/END of its event. The statistics is accumulated 
+		per Kernel id together with the estimated bytes read and written 
+		(see Kernel::getBytesRead()), which gives the effective bandwidth.
+		
+		\code
+		kernelProfiler.enable();
+		// ... time steps ...
+		cout << kernelProfiler.report();
+		kernelProfiler.writeJSON("profile.json");
+		\endcode
+	*/
+	class KernelProfiler
+	{
+		public:
+			/// Statistics of one kernel
+			class Record
+			{
+				public:
+					std::string label;
+					unsigned int kernelID;
+					unsigned int launches;
+					/// in seconds
+					double totalTime;
+					/// in seconds
+					double maxTime;
+					cl_ulong bytesRead;
+					cl_ulong bytesWritten;
+					Record();
+					/// in seconds
+					double meanTime() const;
+					/// effective bandwidth in GB/s
+					double bandwidth() const;
+			};
+		private:
+			bool enabled;
+			std::map<unsigned int, Record> records;
+			/// launches which are not accounted yet
+			std::vector<std::pair<unsigned int, cl::Event> > pendingLaunches;
+			/// accounts all pending launches, waits for them if necessary
+			void collect();
+		public:
+			KernelProfiler();
+			/// enables profiling of all queues of acl::hardware
+			void enable();
+			inline bool isEnabled() const;
+			void registerLaunch(const Kernel & kernel, const cl::Event & event);
+			/// Returns records sorted by the total time in descending order
+			std::vector<Record> getRecords();
+			/// removes all collected statistics
+			void reset();
+			/// Returns table of the records sorted by the total time
+			std::string report();
+			void writeJSON(const std::string & fileName);
+			void writeCSV(const std::string & fileName);
+	};
+
+
+	// GLOBALS
+	extern KernelProfiler kernelProfiler;
+
+//---------------------------- Implementation -----------------------------
+
+	inline bool KernelProfiler::isEnabled() const
+	{
+		return enabled;
+	}
+
+} // namespace acl
+
+#endif // ACLKERNELPROFILER_H
@@ -0,0 +1,331 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+
+#include "aclKernelTuner.h"
+#include "aclKernel.h"
+#include "aclProgramCache.h"
+#include "../DataTypes/aclMemBlock.h"
+#include "../../aslUtilities.h"
+#include "../../utilities/aslTimer.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <cstdlib>
+
+using namespace std;
+using namespace asl;
+
+namespace acl
+{
+
+	KernelTuner kernelTuner;
+
+	// Explicit work-group sizes tried in addition to the implementation's choice
+	const unsigned int TUNER_GROUP_SIZES[] = {32, 64, 128, 256};
+	const unsigned int TUNER_VECTOR_WIDTHS[] = {1, 2, 4, 8, 16};
+	
+
+	KernelTuner::KernelTuner():
+		enabled(false),
+		loaded(false),
+		nRepetitions(5),
+		nTunings(0),
+		nHits(0)
+	{
+		const char * db(getenv("ASL_TUNING_DATABASE"));
+		if (db != NULL)
+			setDatabase(db);
+	}
+
+
+	void KernelTuner::setEnabled(bool enabled_)
+	{
+		enabled = enabled_;
+	}
+
+
+	void KernelTuner::setDatabase(const std::string & database_)
+	{
+		database = database_;
+		entries.clear();
+		loaded = false;
+		enabled = true;
+	}
+
+
+	void KernelTuner::setNRepetitions(unsigned int n)
+	{
+		nRepetitions = max(n, 1u);
+	}
+
+
+	string KernelTuner::composeKey(const string & source,
+	                               unsigned int size,
+	                               const CommandQueue & queue) const
+	{
+		stringstream key;
+		key << hex << setw(16) << setfill('0') << fnv1a(source) << " "
+		    << dec << size << " "
+		    << getPlatformVendor(queue) << " / " << getDeviceName(queue) << " / "
+		    << getDriverVersion(queue);
+		return key.str();
+	}
+
+
+	// Each line of the database: vectorWidth unaligned groupSize key
+	void KernelTuner::load()
+	{
+		loaded = true;
+		if (database.empty())
+			return;
+
+		std::ifstream fi(database);
+		string line;
+		while (getline(fi, line))
+		{
+			istringstream s(line);
+			KernelConfiguration config;
+			bool unaligned(false);
+			string key;
+			s >> config.vectorWidth >> unaligned >> config.groupSize;
+			getline(s >> ws, key);
+			if (!s.fail() && !key.empty() && config.vectorWidth > 0)
+			{
+				config.unaligned = unaligned;
+				// later entries override earlier ones
+				entries[key] = config;
+			}
+		}
+	}
+
+
+	void KernelTuner::store(const string & key, const KernelConfiguration & config)
+	{
+		entries[key] = config;
+		if (database.empty())
+			return;
+
+		std::ofstream fo(database, ios::app);
+		fo << config.vectorWidth << " " << config.unaligned << " " 
+		   << config.groupSize << " " << key << endl;
+		if (!fo.good())
+			warningMessage("KernelTuner::store() - can not write file: " + database);
+	}
+
+
+	bool KernelTuner::find(const string & source,
+	                       unsigned int size,
+	                       const CommandQueue & queue,
+	                       KernelConfiguration & config)
+	{
+		if (!loaded)
+			load();
+
+		std::map<string, KernelConfiguration>::const_iterator it(entries.find(composeKey(source, size, queue)));
+		if (it == entries.end())
+			return false;
+
+		config.vectorWidth = it->second.vectorWidth;
+		config.unaligned = it->second.unaligned;
+		config.groupSize = it->second.groupSize;
+		++nHits;
+		return true;
+	}
+
+
+	vector<KernelConfiguration> KernelTuner::getCandidates(const KernelConfiguration & config,
+	                                                       unsigned int size,
+	                                                       const CommandQueue & queue) const
+	{
+		vector<KernelConfiguration> candidates;
+		if (config.local)
+			return candidates;
+
+		// a basic kernel may contain elements without SIMD support
+		vector<unsigned int> widths(1, 1);
+		if (config.vectorWidth > 1)
+			widths.assign(TUNER_VECTOR_WIDTHS, 
+			              TUNER_VECTOR_WIDTHS + sizeof(TUNER_VECTOR_WIDTHS) / sizeof(unsigned int));
+
+		// an aligned kernel may be made unaligned but not vice versa
+		vector<bool> alignments(1, config.unaligned);
+		if (config.vectorWidth > 1 && !config.unaligned)
+			alignments.push_back(true);
+
+		size_t maxGroupSize(getMaxItemSize(queue));
+		for (unsigned int i = 0; i < widths.size(); ++i)
+		{
+			unsigned int nItems((size + widths[i] - 1) / widths[i]);
+			for (unsigned int j = 0; j < alignments.size(); ++j)
+			{
+				// the alignment does not matter for scalar kernels
+				if (widths[i] == 1 && j > 0)
+					continue;
+
+				KernelConfiguration c(config);
+				c.vectorWidth = widths[i];
+				c.unaligned = alignments[j];
+				c.groupSize = 0;
+				candidates.push_back(c);
+
+				// the global size has to be a multiple of the group size
+				for (unsigned int k = 0; k < sizeof(TUNER_GROUP_SIZES) / sizeof(unsigned int); ++k)
+				{
+					if (TUNER_GROUP_SIZES[k] <= maxGroupSize && nItems % TUNER_GROUP_SIZES[k] == 0)
+					{
+						c.groupSize = TUNER_GROUP_SIZES[k];
+						candidates.push_back(c);
+					}
+				}
+			}
+		}
+
+		return candidates;
+	}
+
+
+	double KernelTuner::benchmark(Kernel & kernel)
+	{
+		// the first launch sets the arguments and is not timed
+		kernel.compute();
+
+		Timer timer;
+		timer.start();
+		cl::Event event;
+		for (unsigned int i = 0; i < nRepetitions; ++i)
+			event = kernel.computeAsync();
+		cl_int status = event.wait();
+		errorMessage(status, "KernelTuner::benchmark() - Event::wait()");
+		timer.stop();
+
+		return timer.realTime();
+	}
+
+
+	// Copies \p size bytes between buffers and waits for the completion
+	void copyBuffer(const CommandQueue & queue,
+	                const cl::Buffer & source,
+	                const cl::Buffer & destination,
+	                size_t size,
+	                const vector<cl::Event> & dependencies)
+	{
+		cl::Event event;
+		cl_int status = queue->enqueueCopyBuffer(source, destination, 0, 0, size, &dependencies, &event);
+		errorMessage(status, "KernelTuner - enqueueCopyBuffer()");
+		status = event.wait();
+		errorMessage(status, "KernelTuner - Event::wait()");
+	}
+	
+
+	void KernelTuner::tune(Kernel & kernel)
+	{
+		kernel.tuningPending = false;
+
+		// the key is the source of the requested configuration
+		string key(composeKey(kernel.kernelSource, kernel.size, kernel.queue));
+		KernelConfiguration best(kernel.kernelConfig);
+		vector<KernelConfiguration> candidates(getCandidates(best, kernel.size, kernel.queue));
+		if (candidates.size() < 2)
+		{
+			store(key, best);
+			return;
+		}
+
+		// the arguments written by the kernel are saved and restored after the benchmark
+		vector<cl::Buffer> backup;
+		vector<size_t> backupSize;
+		for (unsigned int i = 0; i < kernel.memBlockArguments.size(); ++i)
+		{
+			if (!kernel.memBlockArgumentsWritten[i])
+				continue;
+
+			MemBlock & m(*kernel.memBlockArguments[i]);
+			cl_int status = 0;
+			backupSize.push_back(m.getSize() * m.getElementSize());
+			backup.push_back(cl::Buffer(getContext(kernel.queue), 
+			                            CL_MEM_READ_WRITE, 
+			                            backupSize.back(),
+			                            NULL,
+			                            &status));
+			errorMessage(status, "KernelTuner::tune() - Buffer::Buffer()");
+			vector<cl::Event> dependencies;
+			m.getDependencies(dependencies, false);
+			copyBuffer(kernel.queue, m.getBuffer(), backup.back(), backupSize.back(), dependencies);
+		}
+
+		double bestTime(numeric_limits<double>::max());
+		for (unsigned int i = 0; i < candidates.size(); ++i)
+		{
+			kernel.kernelConfig = candidates[i];
+			try
+			{
+				kernel.generateKernelSource();
+				kernel.buildKernel();
+				size_t maxGroupSize(kernel.kernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(getDevice(kernel.queue)));
+				if (candidates[i].groupSize > maxGroupSize)
+					continue;
+
+				double time(benchmark(kernel));
+				if (time < bestTime)
+				{
+					bestTime = time;
+					best = candidates[i];
+				}
+			}
+			catch (logic_error & e)
+			{
+				warningMessage("KernelTuner::tune() - configuration skipped: " + string(e.what()));
+			}
+		}
+
+		for (unsigned int i = 0, j = 0; i < kernel.memBlockArguments.size(); ++i)
+		{
+			if (!kernel.memBlockArgumentsWritten[i])
+				continue;
+
+			MemBlock & m(*kernel.memBlockArguments[i]);
+			vector<cl::Event> dependencies;
+			m.getDependencies(dependencies, true);
+			copyBuffer(kernel.queue, backup[j], m.getBuffer(), backupSize[j], dependencies);
+			++j;
+		}
+
+		kernel.kernelConfig = best;
+		kernel.generateKernelSource();
+		kernel.buildKernel();
+
+		store(key, best);
+		++nTunings;
+	}
+
+
+	void KernelTuner::clear()
+	{
+		entries.clear();
+		loaded = false;
+	}
+
+} // namespace acl
@@ -0,0 +1,141 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef ACLKERNELTUNER_H
+#define ACLKERNELTUNER_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "aclKernelConfiguration.h"
+#include "../aclHardware.h"
+
+namespace acl
+{
+
+	class Kernel;
+	
+	/// Auto-tuner of kernel configurations
+	/**	
+		\ingroup KernelGen
+		If enabled, each non-local kernel is benchmarked on its first launch
+		with a set of configurations: vector widths 1, 2, 4, 8 and 16 and 
+		unaligned access for SIMD kernels, explicit work-group sizes for all
+		of them. Only configurations producing the same results as the 
+		requested one are tried: a basic kernel is not vectorized and an
+		unaligned kernel is not made aligned. The arguments written by the
+		kernel are restored after the benchmark.
+
+		The winner is stored in a database keyed by the hash of the kernel
+		source, the kernel size, the device name and the driver version. 
+		The size is a part of the key since the sources of the non-local 
+		kernels do not contain it, while the group size has to divide it.
+		Subsequent setups of the same kernel on the same device reuse it 
+		without benchmarking.
+		The database is a text file which is appended in each run; its name 
+		is taken from the environment variable ASL_TUNING_DATABASE by default.
+		The tuning is enabled by setting a database name; an empty name keeps
+		the results in memory only.
+	*/
+	class KernelTuner
+	{
+		private:
+			bool enabled;
+			std::string database;
+			/// false until the database file is read
+			bool loaded;
+			std::map<std::string, KernelConfiguration> entries;
+			unsigned int nRepetitions;
+			unsigned int nTunings;
+			unsigned int nHits;
+
+			std::string composeKey(const std::string & source, 
+			                       unsigned int size,
+			                       const CommandQueue & queue) const;
+			void load();
+			void store(const std::string & key, const KernelConfiguration & config);
+			/// returns time of \p nRepetitions launches of \p kernel
+			double benchmark(Kernel & kernel);
+		public:
+			KernelTuner();
+			void setEnabled(bool enabled_);
+			inline bool isEnabled() const;
+			/// Sets the database file and enables the tuning
+			void setDatabase(const std::string & database_);
+			inline const std::string & getDatabase() const;
+			/// Sets number of launches timed for each configuration
+			void setNRepetitions(unsigned int n);
+			/// Looks up the configuration stored for \p source and \p size; on success
+			/// overwrites vector width, alignment and group size of \p config
+			bool find(const std::string & source, 
+			          unsigned int size,
+			          const CommandQueue & queue,
+			          KernelConfiguration & config);
+			/// Returns configurations tried for a kernel with \p config and \p size
+			std::vector<KernelConfiguration> getCandidates(const KernelConfiguration & config,
+			                                               unsigned int size,
+			                                               const CommandQueue & queue) const;
+			/// Benchmarks the candidate configurations of \p kernel, sets it 
+			/// up with the fastest one and stores the result
+			void tune(Kernel & kernel);
+			/// removes all entries kept in memory, the file is read again on the next lookup
+			void clear();
+			/// number of kernels benchmarked
+			inline unsigned int getNTunings() const;
+			/// number of kernels configured from the database
+			inline unsigned int getNHits() const;
+	};
+
+
+	// GLOBALS
+	extern KernelTuner kernelTuner;
+
+//---------------------------- Implementation -----------------------------
+
+	inline bool KernelTuner::isEnabled() const
+	{
+		return enabled;
+	}
+
+
+	inline const std::string & KernelTuner::getDatabase() const
+	{
+		return database;
+	}
+
+
+	inline unsigned int KernelTuner::getNTunings() const
+	{
+		return nTunings;
+	}
+
+
+	inline unsigned int KernelTuner::getNHits() const
+	{
+		return nHits;
+	}
+
+} // namespace acl
+
+#endif // ACLKERNELTUNER_H
@@ -0,0 +1,165 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include "aclParallelBuild.h"
+#include "aclKernel.h"
+#include "aclProgramCache.h"
+#include "../../aslUtilities.h"
+#include <algorithm>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <exception>
+
+using namespace std;
+using namespace asl;
+
+namespace acl
+{
+
+	unsigned int ParallelBuild::level = 0;
+	vector<Kernel*> ParallelBuild::deferredKernels;
+
+
+	ParallelBuild::ParallelBuild()
+	{
+		++level;
+	}
+
+
+	ParallelBuild::~ParallelBuild()
+	{
+		--level;
+	}
+
+
+	bool ParallelBuild::active()
+	{
+		return level > 0;
+	}
+
+
+	void ParallelBuild::addKernel(Kernel * k)
+	{
+		if (find(deferredKernels.begin(), deferredKernels.end(), k) == deferredKernels.end())
+			deferredKernels.push_back(k);
+	}
+
+
+	void ParallelBuild::removeKernel(Kernel * k)
+	{
+		deferredKernels.erase(remove(deferredKernels.begin(), deferredKernels.end(), k),
+		                      deferredKernels.end());
+	}
+
+
+	/// Program sources to be built by the worker threads
+	class BuildTasks
+	{
+		public:
+			vector<const string*> sources;
+			vector<CommandQueue> queues;
+			vector<cl::Program> programs;
+			vector<exception_ptr> errors;
+			unsigned int next;
+			mutex nextMutex;
+
+			BuildTasks(): next(0) {}
+			/// returns false if there are no more tasks
+			bool getTask(unsigned int & i);
+	};
+
+
+	bool BuildTasks::getTask(unsigned int & i)
+	{
+		lock_guard<mutex> lock(nextMutex);
+		i = next++;
+		return i < sources.size();
+	}
+
+
+	void buildWorker(BuildTasks * tasks)
+	{
+		unsigned int i;
+		while (tasks->getTask(i))
+		{
+			try
+			{
+				tasks->programs[i] = programCache.getProgram(*tasks->sources[i], tasks->queues[i]);
+			}
+			catch(...)
+			{
+				tasks->errors[i] = current_exception();
+			}
+		}
+	}
+
+
+	void ParallelBuild::build()
+	{
+		if (level > 1)
+			return;
+
+		vector<Kernel*> kernels;
+		kernels.swap(deferredKernels);
+		if (kernels.empty())
+			return;
+
+		// identical sources are built once
+		BuildTasks tasks;
+		map<pair<cl::CommandQueue*, string>, unsigned int> taskIDs;
+		vector<unsigned int> kernelTasks(kernels.size());
+		for (unsigned int i = 0; i < kernels.size(); ++i)
+		{
+			pair<cl::CommandQueue*, string> key(kernels[i]->queue.get(), kernels[i]->kernelSource);
+			map<pair<cl::CommandQueue*, string>, unsigned int>::iterator it(taskIDs.find(key));
+			if (it == taskIDs.end())
+			{
+				it = taskIDs.insert(make_pair(key, tasks.sources.size())).first;
+				tasks.sources.push_back(&kernels[i]->kernelSource);
+				tasks.queues.push_back(kernels[i]->queue);
+			}
+			kernelTasks[i] = it->second;
+		}
+		tasks.programs.resize(tasks.sources.size());
+		tasks.errors.resize(tasks.sources.size());
+
+		unsigned int nThreads(min((unsigned int)tasks.sources.size(),
+		                          max(thread::hardware_concurrency(), 1u)));
+		vector<thread> threads;
+		for (unsigned int i = 1; i < nThreads; ++i)
+			threads.push_back(thread(buildWorker, &tasks));
+		buildWorker(&tasks);
+		for (unsigned int i = 0; i < threads.size(); ++i)
+			threads[i].join();
+
+		for (unsigned int i = 0; i < tasks.errors.size(); ++i)
+			if (tasks.errors[i])
+				rethrow_exception(tasks.errors[i]);
+
+		for (unsigned int i = 0; i < kernels.size(); ++i)
+			kernels[i]->bindKernel(tasks.programs[kernelTasks[i]]);
+	}
+
+} // namespace acl
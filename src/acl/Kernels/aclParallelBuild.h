@@ -0,0 +1,70 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef ACLPARALLELBUILD_H
+#define ACLPARALLELBUILD_H
+
+#include <vector>
+
+namespace acl
+{
+	class Kernel;
+
+	/// Builds kernels concurrently
+	/**	
+		\ingroup KernelGen
+		Kernel::setup() called while an object of this class exists 
+		generates the kernel source only. build() compiles the programs of 
+		all such kernels concurrently and binds the kernels afterwards.
+		Objects can be nested, in this case the kernels are built by 
+		the outermost one. Kernels which are not built (e.g. due to an 
+		exception) are built at their first launch.
+
+		\code
+		ParallelBuild parallelBuild;
+		k1.setup();
+		k2.setup();
+		parallelBuild.build();
+		\endcode
+	*/
+	class ParallelBuild
+	{
+		private:
+			static unsigned int level;
+			/// kernels set up but not built yet
+			static std::vector<Kernel*> deferredKernels;
+		public:
+			ParallelBuild();
+			~ParallelBuild();
+			/// Builds all deferred kernels, does nothing if the object is nested
+			void build();
+			/// returns true if kernels set up currently should be deferred
+			static bool active();
+			static void addKernel(Kernel * k);
+			static void removeKernel(Kernel * k);
+	};
+
+} // namespace acl
+
+#endif // ACLPARALLELBUILD_H
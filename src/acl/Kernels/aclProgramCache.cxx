@@ -0,0 +1,271 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include "aclProgramCache.h"
+#include "../../aslUtilities.h"
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <cstdlib>
+
+using namespace std;
+using namespace asl;
+using namespace boost::filesystem;
+
+namespace acl
+{
+
+	ProgramCache programCache;
+
+	// Header of the binary files, should be changed with the file layout
+	const string PROGRAM_CACHE_SIGNATURE("ASL program binary 1\n");
+
+	
+	unsigned long long fnv1a(const string & s)
+	{
+		unsigned long long h(14695981039346656037ULL);
+		for (unsigned int i = 0; i < s.size(); ++i)
+		{
+			h ^= (unsigned char)s[i];
+			h *= 1099511628211ULL;
+		}
+		return h;
+	}
+
+
+	ProgramCache::ProgramCache():
+		nBuilds(0),
+		nMemoryHits(0),
+		nDiskHits(0)
+	{
+		const char * dir(getenv("ASL_PROGRAM_CACHE_DIR"));
+		if (dir != NULL)
+			directory = dir;
+	}
+
+
+	void ProgramCache::setDirectory(const std::string & directory_)
+	{
+		directory = directory_;
+	}
+
+
+	const std::string & ProgramCache::getDirectory() const
+	{
+		return directory;
+	}
+
+
+	string ProgramCache::composeKey(const string & source,
+	                                const CommandQueue & queue,
+	                                const string & options) const
+	{
+		return getPlatformVendor(queue) + "\n" + getDeviceName(queue) + "\n"
+		       + getDriverVersion(queue) + "\n" + options + "\n" + source;
+	}
+
+
+	string ProgramCache::getFileName(const string & key) const
+	{
+		stringstream name;
+		name << hex << setw(16) << setfill('0') << fnv1a(key) << ".bin";
+		return (path(directory) / name.str()).string();
+	}
+
+
+	bool ProgramCache::load(const string & key,
+	                        const CommandQueue & queue,
+	                        const string & options,
+	                        cl::Program & program)
+	{
+		std::ifstream fi(getFileName(key), ios::binary);
+		if (!fi.good())
+			return false;
+
+		// the full key is stored in the file in order to exclude hash collisions
+		string signature(PROGRAM_CACHE_SIGNATURE.size(), ' ');
+		unsigned long long keySize(0);
+		unsigned long long binarySize(0);
+		fi.read(&signature[0], signature.size());
+		fi.read((char*)&keySize, sizeof(keySize));
+		if (!fi.good() || signature != PROGRAM_CACHE_SIGNATURE || keySize != key.size())
+			return false;
+
+		string storedKey(keySize, ' ');
+		fi.read(&storedKey[0], keySize);
+		fi.read((char*)&binarySize, sizeof(binarySize));
+		if (!fi.good() || storedKey != key || binarySize == 0)
+			return false;
+
+		vector<char> binary(binarySize);
+		fi.read(&binary[0], binarySize);
+		if (!fi.good())
+			return false;
+
+		cl_int status = 0;
+		vector<cl_int> binaryStatus;
+		cl::Program::Binaries binaries(1, make_pair((const void*)&binary[0], (size_t)binarySize));
+		program = cl::Program(getContext(queue),
+		                      vector<cl::Device>(1, getDevice(queue)),
+		                      binaries,
+		                      &binaryStatus,
+		                      &status);
+		if (status != CL_SUCCESS || binaryStatus.size() != 1 || binaryStatus[0] != CL_SUCCESS)
+			return false;
+
+		// the program has to be built even if it is created from a binary
+		return program.build(vector<cl::Device>(1, getDevice(queue)), options.c_str()) == CL_SUCCESS;
+	}
+
+
+	void ProgramCache::store(const string & key, const cl::Program & program)
+	{
+		cl_int status = 0;
+		vector<size_t> sizes(program.getInfo<CL_PROGRAM_BINARY_SIZES>(&status));
+		if (status != CL_SUCCESS || sizes.size() != 1 || sizes[0] == 0)
+		{
+			warningMessage("ProgramCache::store() - program binary is not available");
+			return;
+		}
+
+		vector<char> binary(sizes[0]);
+		vector<char*> binaries(1, &binary[0]);
+		status = program.getInfo(CL_PROGRAM_BINARIES, &binaries);
+		if (status != CL_SUCCESS)
+		{
+			warningMessage("ProgramCache::store() - program binary is not available");
+			return;
+		}
+
+		try
+		{
+			create_directories(directory);
+			// the binary is written into a temporary file and renamed afterwards,
+			// so concurrently running processes never read incomplete files
+			path fileName(getFileName(key));
+			path tmpFileName(fileName.string() + unique_path(".%%%%-%%%%").string());
+			{
+				std::ofstream fo(tmpFileName.string(), ios::binary);
+				unsigned long long keySize(key.size());
+				unsigned long long binarySize(binary.size());
+				fo.write(PROGRAM_CACHE_SIGNATURE.data(), PROGRAM_CACHE_SIGNATURE.size());
+				fo.write((const char*)&keySize, sizeof(keySize));
+				fo.write(key.data(), keySize);
+				fo.write((const char*)&binarySize, sizeof(binarySize));
+				fo.write(&binary[0], binarySize);
+				if (!fo.good())
+				{
+					fo.close();
+					boost::filesystem::remove(tmpFileName);
+					warningMessage("ProgramCache::store() - can not write file: " + tmpFileName.string());
+					return;
+				}
+			}
+			boost::filesystem::rename(tmpFileName, fileName);
+		}
+		catch(filesystem_error & e)
+		{
+			warningMessage(string("ProgramCache::store() - ") + e.what());
+		}
+	}
+
+
+	cl::Program ProgramCache::build(const string & source,
+	                                const CommandQueue & queue,
+	                                const string & options)
+	{
+		cl_int status = 0;
+		
+		cl::Program::Sources sources(1, make_pair(source.data(), source.size()));
+
+		cl::Program program = cl::Program(getContext(queue), sources, &status);
+		errorMessage(status, "Program::Program()");
+		status = program.build(vector<cl::Device>(1, getDevice(queue)), options.c_str());
+
+		if (status == CL_BUILD_PROGRAM_FAILURE)
+		{
+			string str = program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(getDevice(queue));
+
+			cout << " \n\t\t\tBUILD LOG\n";
+			cout << " ************************************************\n";
+			cout << str << endl;
+			cout << " ************************************************\n";
+			cout << " \n\t\t\tKERNEL SOURCE CODE\n";
+			cout << " ------------------------------------------------\n";
+			cout << source << endl;
+			cout << " ------------------------------------------------\n";
+		}
+
+		errorMessage(status, "Program::build()");
+
+		return program;
+	}
+
+
+	cl::Program ProgramCache::getProgram(const string & source,
+	                                     const CommandQueue & queue,
+	                                     const string & options)
+	{
+		string key(composeKey(source, queue, options));
+		// the device name is not unique within a context with several identical devices
+		MemoryKey memoryKey(getContext(queue)(), getDevice(queue)(), key);
+
+		{
+			lock_guard<std::mutex> lock(mutex);
+			map<MemoryKey, cl::Program>::iterator it(programs.find(memoryKey));
+			if (it != programs.end())
+			{
+				++nMemoryHits;
+				return it->second;
+			}
+		}
+
+		cl::Program program;
+		bool loaded(!directory.empty() && load(key, queue, options, program));
+		if (!loaded)
+		{
+			program = build(source, queue, options);
+			if (!directory.empty())
+				store(key, program);
+		}
+
+		lock_guard<std::mutex> lock(mutex);
+		if (loaded)
+			++nDiskHits;
+		else
+			++nBuilds;
+		programs[memoryKey] = program;
+		return program;
+	}
+
+
+	void ProgramCache::clear()
+	{
+		lock_guard<std::mutex> lock(mutex);
+		programs.clear();
+	}
+
+} // namespace acl
@@ -0,0 +1,125 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef ACLPROGRAMCACHE_H
+#define ACLPROGRAMCACHE_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include "../aclHardware.h"
+
+namespace acl
+{
+
+	/// Cache of built OpenCL programs
+	/**	
+		\ingroup KernelGen
+		Programs are identified by a key composed of the program source,
+		device name, driver version and build options. Identical programs
+		requested within the process are built only once for each device
+		of a context. If a directory is
+		set, the program binaries (CL_PROGRAM_BINARIES) are stored there and 
+		reloaded with clCreateProgramWithBinary() in subsequent runs.
+		The directory is taken from the environment variable 
+		ASL_PROGRAM_CACHE_DIR by default; the on-disk cache is disabled 
+		if the directory is empty. getProgram() can be called from 
+		several threads concurrently, see ParallelBuild.
+	*/
+	class ProgramCache
+	{
+		private:
+			std::string directory;
+			/// programs are kept per context and device, since a program is
+			/// built only for the device of the queue
+			typedef std::tuple<cl_context, cl_device_id, std::string> MemoryKey;
+			std::map<MemoryKey, cl::Program> programs;
+			unsigned int nBuilds;
+			unsigned int nMemoryHits;
+			unsigned int nDiskHits;
+			/// protects \p programs and the counters, the programs are built unlocked
+			std::mutex mutex;
+
+			std::string composeKey(const std::string & source,
+			                       const CommandQueue & queue,
+			                       const std::string & options) const;
+			std::string getFileName(const std::string & key) const;
+			/// returns false if there is no valid binary for \p key
+			bool load(const std::string & key,
+			          const CommandQueue & queue,
+			          const std::string & options,
+			          cl::Program & program);
+			void store(const std::string & key, const cl::Program & program);
+			cl::Program build(const std::string & source,
+			                  const CommandQueue & queue,
+			                  const std::string & options);
+		public:
+			ProgramCache();
+			/// Sets directory for program binaries, empty string disables the on-disk cache
+			void setDirectory(const std::string & directory_);
+			const std::string & getDirectory() const;
+			/// Returns built program for \p source; builds it if it is not cached
+			cl::Program getProgram(const std::string & source,
+			                       const CommandQueue & queue,
+			                       const std::string & options = "");
+			/// removes all programs kept in memory, the files are not affected
+			void clear();
+			/// number of programs built from source
+			inline unsigned int getNBuilds() const;
+			/// number of programs reused within the process
+			inline unsigned int getNMemoryHits() const;
+			/// number of programs loaded from the directory
+			inline unsigned int getNDiskHits() const;
+	};
+
+
+	// GLOBALS
+	extern ProgramCache programCache;
+
+	/// 64-bit FNV-1a hash, stable between runs in contrast to std::hash
+	unsigned long long fnv1a(const std::string & s);
+
+//---------------------------- Implementation -----------------------------
+
+	inline unsigned int ProgramCache::getNBuilds() const
+	{
+		return nBuilds;
+	}
+
+
+	inline unsigned int ProgramCache::getNMemoryHits() const
+	{
+		return nMemoryHits;
+	}
+
+
+	inline unsigned int ProgramCache::getNDiskHits() const
+	{
+		return nDiskHits;
+	}
+
+} // namespace acl
+
+#endif // ACLPROGRAMCACHE_H
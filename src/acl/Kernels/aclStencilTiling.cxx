@@ -0,0 +1,606 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include "aclStencilTiling.h"
+#include "aclExpressionOptimizer.h"
+#include "../acl.h"
+#include "../aclHardware.h"
+#include "../aclUtilities.h"
+#include "../DataTypes/aclIndex.h"
+#include "../DataTypes/aclConstant.h"
+#include "../DataTypes/aclMemBlock.h"
+#include "../Operators/aclElementSum.h"
+#include "../Operators/aclElementExcerpt.h"
+#include "../../aslUtilities.h"
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <numeric>
+#include <typeinfo>
+
+using namespace std;
+using namespace asl;
+
+namespace acl
+{
+
+	const string StencilTiling::INSIDE("inside");
+
+
+	inline unsigned int productOfSizes(const vector<unsigned int> & size)
+	{
+		return accumulate(size.begin(), size.end(), 1u, multiplies<unsigned int>());
+	}
+
+
+	/// Read of the local copy of a tiled array
+	class TileAccess: public ElementBase
+	{
+		private:
+			string access;
+		public:
+			TileAccess(const string & access_, TypeID typeID_):
+				ElementBase(false, 0, typeID_),
+				access(access_)
+			{
+			}
+			virtual string str(const KernelConfiguration & kernelConfig) const
+			{
+				return access;
+			}
+			virtual string getName() const
+			{
+				return "";
+			}
+			virtual string getTypeSignature(const KernelConfiguration & kernelConfig) const
+			{
+				return "";
+			}
+			virtual string getLocalDeclaration(const KernelConfiguration & kernelConfig) const
+			{
+				return "";
+			}
+			virtual void addToKernelSource(vector<Element> & arguments,
+			                               vector<Element> & localDeclarations) const
+			{
+			}
+			virtual void setAsArgument(cl::Kernel & kernel, unsigned int argumentIndex) const
+			{
+			}
+	};
+
+
+	StencilTiling::StencilTiling(const vector<unsigned int> & gridSize_,
+	                             const vector<unsigned int> & tileSize_):
+		gridSize(gridSize_),
+		requestedTileSize(tileSize_),
+		marching(false),
+		groupSizeLimit(0),
+		strides(gridSize_.size(), 1),
+		kernelSize(0)
+	{
+		unsigned int nD(gridSize.size());
+		if (nD < 1 || nD > 3)
+			errorMessage("StencilTiling::StencilTiling() - only 1D, 2D and 3D grids are supported");
+
+		if (requestedTileSize.empty())
+		{
+			const unsigned int defaultTiles[3][3] = {{256, 0, 0}, {8, 32, 0}, {4, 4, 16}};
+			requestedTileSize.assign(defaultTiles[nD - 1], defaultTiles[nD - 1] + nD);
+		}
+		if (requestedTileSize.size() != nD)
+			errorMessage("StencilTiling::StencilTiling() - the tile and the grid have different dimensionalities");
+		tileSize = requestedTileSize;
+
+		for (int i(nD - 2); i >= 0; --i)
+			strides[i] = strides[i + 1] * gridSize[i + 1];
+	}
+
+
+	bool StencilTiling::isSupported(const CommandQueue & queue)
+	{
+		return getLocalMemoryType(queue) == CL_LOCAL;
+	}
+
+
+	bool StencilTiling::parseFilter(const Element & e, int & shift)
+	{
+		if (typeid(*e) == typeid(Index))
+		{
+			shift = 0;
+			return true;
+		}
+		if (typeid(*e) != typeid(ElementSum))
+			return false;
+
+		vector<Element> operands(ExpressionOptimizer::getOperands(e.get()));
+		for (unsigned int i(0); i < 2; ++i)
+		{
+			const Constant<cl_int> * c(dynamic_cast<const Constant<cl_int>*>(operands[1 - i].get()));
+			if (typeid(*operands[i]) == typeid(Index) && c != NULL)
+			{
+				shift = c->getValue();
+				return true;
+			}
+		}
+		return false;
+	}
+
+
+	bool StencilTiling::parseAccess(const Element & e, Element & array, int & offset)
+	{
+		if (isMemBlock(e))
+		{
+			const MemBlock * m(dynamic_cast<const MemBlock*>(e.get()));
+			// Subvectors and reduced precision arrays are not indexed directly
+			if (isSubvector(e) || m->getElementSize() != TYPE_SIZE[m->getTypeID()])
+				return false;
+			array = e;
+			return true;
+		}
+
+		if (typeid(*e) != typeid(ElementExcerpt))
+			return false;
+		vector<Element> operands(ExpressionOptimizer::getOperands(e.get()));
+		int shift(0);
+		if (!parseFilter(operands[1], shift) || !parseAccess(operands[0], array, offset))
+			return false;
+		offset += shift;
+		return true;
+	}
+
+
+	vector<int> StencilTiling::decompose(int offset) const
+	{
+		unsigned int nD(gridSize.size());
+		vector<int> d(nD, 0);
+		for (unsigned int i(0); i + 1 < nD; ++i)
+		{
+			// the nearest plane, the remainder is a shift within it
+			d[i] = offset >= 0 ? (offset + strides[i] / 2) / strides[i] :
+			                     -((-offset + strides[i] / 2) / strides[i]);
+			offset -= d[i] * strides[i];
+		}
+		d[nD - 1] = offset;
+		return d;
+	}
+
+
+	unsigned int StencilTiling::localOffset(const Field & field, int offset) const
+	{
+		vector<int> d(decompose(offset));
+		unsigned int r(0);
+		for (unsigned int i(0); i < d.size(); ++i)
+			r = r * field.extents[i] + d[i] - field.lo[i];
+		return r;
+	}
+
+
+	const StencilTiling::Field * StencilTiling::findField(const Element & array) const
+	{
+		for (unsigned int i(0); i < fields.size(); ++i)
+			if (fields[i].array == array)
+				return &fields[i];
+		return NULL;
+	}
+
+
+	const StencilTiling::Column * StencilTiling::findColumn(const Element & array, int shift) const
+	{
+		for (unsigned int i(0); i < columns.size(); ++i)
+			if (columns[i].array == array && columns[i].shift == shift)
+				return &columns[i];
+		return NULL;
+	}
+
+
+	void StencilTiling::addColumns(const Element & array, const set<int> & offsets)
+	{
+		unsigned int first(columns.size());
+		for (set<int>::const_iterator o(offsets.begin()); o != offsets.end(); ++o)
+		{
+			int d0(decompose(*o)[0]);
+			int shift(*o - d0 * strides[0]);
+			unsigned int i(first);
+			while (i < columns.size() && columns[i].shift != shift)
+				++i;
+			if (i < columns.size())
+			{
+				columns[i].lo = min(columns[i].lo, d0);
+				columns[i].hi = max(columns[i].hi, d0);
+				continue;
+			}
+
+			Column c;
+			c.array = array;
+			c.shift = shift;
+			c.lo = d0;
+			c.hi = d0;
+			c.name = "r_" + array->getName() + "_" + numToStr(i - first);
+			columns.push_back(c);
+		}
+	}
+
+
+	void StencilTiling::collect(const Element & e)
+	{
+		Element array;
+		int offset(0);
+		if (parseAccess(e, array, offset))
+		{
+			accesses[array].insert(offset);
+			return;
+		}
+		// excerpts with other filters are left untouched
+		if (typeid(*e) == typeid(ElementExcerpt))
+			return;
+
+		vector<Element> operands(ExpressionOptimizer::getOperands(e.get()));
+		vector<bool> values(ExpressionOptimizer::getValueOperands(e.get(), operands.size()));
+		for (unsigned int i(0); i < operands.size(); ++i)
+			if (values[i])
+				collect(operands[i]);
+	}
+
+
+	Element StencilTiling::rewrite(const Element & e)
+	{
+		Element array;
+		int offset(0);
+		if (parseAccess(e, array, offset) && marching)
+		{
+			int d0(decompose(offset)[0]);
+			const Column * c(findColumn(array, offset - d0 * strides[0]));
+			if (c == NULL)
+				return e;
+			return Element(new TileAccess(c->name + "_" + numToStr(d0 - c->lo),
+			                              array->getTypeID()));
+		}
+		if (!marching && parseAccess(e, array, offset))
+		{
+			const Field * f(findField(array));
+			if (f == NULL)
+				return e;
+			return Element(new TileAccess(f->tile + "[" + f->tile + "_base + " + 
+			                              numToStr(localOffset(*f, offset)) + "]",
+			                              array->getTypeID()));
+		}
+		if (typeid(*e) == typeid(ElementExcerpt))
+			return e;
+
+		vector<Element> operands(ExpressionOptimizer::getOperands(e.get()));
+		vector<bool> values(ExpressionOptimizer::getValueOperands(e.get(), operands.size()));
+		bool changed(false);
+		for (unsigned int i(0); i < operands.size(); ++i)
+		{
+			if (values[i])
+			{
+				Element r(rewrite(operands[i]));
+				changed |= (r != operands[i]);
+				operands[i] = r;
+			}
+		}
+		if (!changed)
+			return e;
+
+		// unknown elements keep reading the global memory
+		Element c(ExpressionOptimizer::copyWithOperands(e, operands));
+		return c ? c : e;
+	}
+
+
+	vector<Element> StencilTiling::apply(const vector<Element> & expression,
+	                                     const vector<Element> & writtenArguments,
+	                                     unsigned int kernelSize_,
+	                                     const CommandQueue & queue,
+	                                     bool marching_)
+	{
+		unsigned int nD(gridSize.size());
+		kernelSize = kernelSize_;
+		if (kernelSize > strides[0] * gridSize[0])
+			errorMessage("StencilTiling::apply() - the kernel is larger than the grid");
+
+		marching = marching_ && isMarchingSupported();
+		tileSize = requestedTileSize;
+		// the work-group of the marching mode is a tile of columns
+		if (marching)
+			tileSize[0] = 1;
+		// the local range lists the tile extents in reverse order, see getLocalRange()
+		vector<size_t> maxItemSizes(getDevice(queue).getInfo<CL_DEVICE_MAX_WORK_ITEM_SIZES>());
+		for (unsigned int i(0); i < nD; ++i)
+			tileSize[i] = min<size_t>(tileSize[i], maxItemSizes[nD - 1 - i]);
+		// the tile is reduced to the maximal work-group size
+		size_t maxGroupSize(getMaxWorkGroupSize(queue));
+		if (groupSizeLimit > 0)
+			maxGroupSize = min(maxGroupSize, groupSizeLimit);
+		while (productOfSizes(tileSize) > maxGroupSize)
+		{
+			vector<unsigned int>::iterator it(max_element(tileSize.begin(), tileSize.end()));
+			*it = max(1u, *it / 2);
+		}
+
+		accesses.clear();
+		fields.clear();
+		columns.clear();
+		for (unsigned int i(0); i < expression.size(); ++i)
+			collect(expression[i]);
+
+		cl_ulong available(getLocalMemorySize(queue) / 2);
+		for (std::map<Element, set<int> >::iterator it(accesses.begin()); it != accesses.end(); ++it)
+		{
+			// single reads gain nothing from the local copy
+			if (it->second.size() < 2 ||
+			    binary_search(writtenArguments.begin(), writtenArguments.end(), it->first))
+				continue;
+
+			Field f;
+			f.array = it->first;
+			f.tile = "tile_" + it->first->getName();
+			f.lo.assign(nD, 0);
+			f.hi.assign(nD, 0);
+			bool first(true);
+			for (set<int>::iterator o(it->second.begin()); o != it->second.end(); ++o)
+			{
+				vector<int> d(decompose(*o));
+				for (unsigned int i(0); i < nD; ++i)
+				{
+					f.lo[i] = first ? d[i] : min(f.lo[i], d[i]);
+					f.hi[i] = first ? d[i] : max(f.hi[i], d[i]);
+				}
+				first = false;
+			}
+			f.extents.resize(nD);
+			f.volume = 1;
+			for (unsigned int i(0); i < nD; ++i)
+			{
+				f.extents[i] = tileSize[i] + f.hi[i] - f.lo[i];
+				f.volume *= f.extents[i];
+			}
+
+			if (marching)
+			{
+				fields.push_back(f);
+				addColumns(f.array, it->second);
+				continue;
+			}
+
+			cl_ulong bytes(f.volume * TYPE_SIZE[f.array->getTypeID()]);
+			if (bytes <= available)
+			{
+				available -= bytes;
+				fields.push_back(f);
+			}
+		}
+
+		vector<Element> r(expression.size());
+		for (unsigned int i(0); i < expression.size(); ++i)
+			r[i] = rewrite(expression[i]);
+		return r;
+	}
+
+
+	string StencilTiling::loadRegister(const Column & column,
+	                                   int k,
+	                                   const string & plane,
+	                                   const string & indent) const
+	{
+		const MemBlock * m(dynamic_cast<const MemBlock*>(column.array.get()));
+		return indent + "p = (" + plane + " + (" + numToStr(column.lo + k) + ")) * " + 
+		       numToStr(strides[0]) + " + column + (" + numToStr(column.shift) + ");\n" +
+		       indent + column.name + "_" + numToStr(k) + " = (p >= 0 && p < " + 
+		       numToStr(m->getSize()) + ") ? " + column.array->getName() + "[p] : 0;\n";
+	}
+
+
+	string StencilTiling::getMarchingCode() const
+	{
+		unsigned int nD(gridSize.size());
+		string s;
+		string column;
+		string outside;
+		for (unsigned int i(1); i < nD; ++i)
+		{
+			string c("c" + numToStr(i));
+			s += "int " + c + " = get_global_id(" + numToStr(nD - 1 - i) + ");\n\t";
+			column += (i > 1 ? " + " : "") + c + " * " + numToStr(strides[i]);
+			outside += (i > 1 ? " || " : "") + c + " >= " + numToStr(gridSize[i]);
+		}
+		s += "if (" + outside + ")\n\t\treturn;\n\t";
+		s += "int column = " + column + ";\n";
+		if (!columns.empty())
+			s += "\tint p;\n";
+
+		// the registers are rolled at the beginning of each step, so the
+		// registers but the leading one are loaded for the plane -1
+		for (unsigned int j(0); j < columns.size(); ++j)
+		{
+			const Column & c(columns[j]);
+			s += "\t" + TYPE[c.array->getTypeID()] + " ";
+			for (int k(0); k <= c.hi - c.lo; ++k)
+				s += (k > 0 ? ", " : "") + c.name + "_" + numToStr(k);
+			s += ";\n";
+			for (int k(1); k <= c.hi - c.lo; ++k)
+				s += loadRegister(c, k, "-1", "\t");
+		}
+
+		unsigned int nPlanes((kernelSize + strides[0] - 1) / strides[0]);
+		s += "\tfor (int plane = 0; plane < " + numToStr(nPlanes) + "; ++plane)\n\t{\n";
+		for (unsigned int j(0); j < columns.size(); ++j)
+		{
+			const Column & c(columns[j]);
+			for (int k(0); k < c.hi - c.lo; ++k)
+				s += "\t\t" + c.name + "_" + numToStr(k) + " = " + c.name + "_" + numToStr(k + 1) + ";\n";
+			s += loadRegister(c, c.hi - c.lo, "plane", "\t\t");
+		}
+		s += "\t\tuint " + INDEX + " = plane * " + numToStr(strides[0]) + " + column;\n";
+		s += "\t\tbool " + INSIDE + " = " + INDEX + " < " + numToStr(kernelSize) + ";\n";
+		return s;
+	}
+
+
+	string StencilTiling::getClosingCode() const
+	{
+		return marching ? "\t}\n" : "";
+	}
+
+
+	string StencilTiling::adaptStatement(const string & statement) const
+	{
+		if (!marching)
+			return statement;
+
+		// the return of a point proceeds to the next plane
+		const string from("return");
+		const string to("continue");
+		string s(statement);
+		size_t pos(s.find(from));
+		while (pos != string::npos)
+		{
+			size_t end(pos + from.size());
+			bool word((pos == 0 || !(isalnum(s[pos - 1]) || s[pos - 1] == '_')) &&
+			          (end == s.size() || !(isalnum(s[end]) || s[end] == '_')));
+			if (word)
+			{
+				s.replace(pos, from.size(), to);
+				end = pos + to.size();
+			}
+			pos = s.find(from, end);
+		}
+		return s;
+	}
+
+
+	string StencilTiling::getIndexCode() const
+	{
+		if (marching)
+			return getMarchingCode();
+
+		unsigned int nD(gridSize.size());
+		string s;
+		// the contiguous dimension of the grid is the first one of the NDRange
+		for (unsigned int i(0); i < nD; ++i)
+		{
+			s += "int tl" + numToStr(i) + " = get_local_id(" + numToStr(nD - 1 - i) + ");\n\t";
+			s += "int to" + numToStr(i) + " = get_group_id(" + numToStr(nD - 1 - i) + ") * " +
+			     numToStr(tileSize[i]) + ";\n\t";
+		}
+
+		string index;
+		string inside(INDEX + " < " + numToStr(kernelSize));
+		string localID("get_local_id(" + numToStr(nD - 1) + ")");
+		for (unsigned int i(0); i < nD; ++i)
+		{
+			string coordinate("(to" + numToStr(i) + " + tl" + numToStr(i) + ")");
+			index += (i > 0 ? " + " : "") + coordinate + " * " + numToStr(strides[i]);
+			if (i > 0)
+			{
+				inside += " && " + coordinate + " < " + numToStr(gridSize[i]);
+				localID = "get_local_id(" + numToStr(nD - 1 - i) + ") + " + 
+				          numToStr(tileSize[i]) + " * (" + localID + ")";
+			}
+		}
+		s += "uint " + INDEX + " = " + index + ";\n\t";
+		s += "bool " + INSIDE + " = " + inside + ";\n\t";
+		if (fields.empty())
+			return s;
+
+		s += "int tid = " + localID + ";\n";
+		for (unsigned int k(0); k < fields.size(); ++k)
+		{
+			const Field & f(fields[k]);
+			const MemBlock * m(dynamic_cast<const MemBlock*>(f.array.get()));
+			s += "\t__local " + TYPE[f.array->getTypeID()] + " " + f.tile + "[" + numToStr(f.volume) + "];\n";
+			s += "\tfor (int j = tid; j < " + numToStr(f.volume) + "; j += " + 
+			     numToStr(productOfSizes(tileSize)) + ")\n\t{\n";
+			string position;
+			unsigned int stride(1);
+			for (int i(nD - 1); i >= 0; --i)
+			{
+				string e("j / " + numToStr(stride) + " % " + numToStr(f.extents[i]));
+				position = "(to" + numToStr(i) + " + " + e + " + (" + numToStr(f.lo[i]) + ")) * " +
+				           numToStr(strides[i]) + (position.empty() ? "" : " + ") + position;
+				stride *= f.extents[i];
+			}
+			s += "\t\tint p = " + position + ";\n";
+			s += "\t\t" + f.tile + "[j] = (p >= 0 && p < " + numToStr(m->getSize()) + ") ? " + 
+			     f.array->getName() + "[p] : 0;\n\t}\n";
+			string base;
+			stride = 1;
+			for (int i(nD - 1); i >= 0; --i)
+			{
+				base = "tl" + numToStr(i) + " * " + numToStr(stride) + (base.empty() ? "" : " + ") + base;
+				stride *= f.extents[i];
+			}
+			s += "\tint " + f.tile + "_base = " + base + ";\n";
+		}
+		s += "\tbarrier(CLK_LOCAL_MEM_FENCE);\n\t";
+		return s;
+	}
+
+
+	void StencilTiling::setGroupSizeLimit(size_t n)
+	{
+		groupSizeLimit = n;
+	}
+
+
+	size_t StencilTiling::getGroupSize() const
+	{
+		return productOfSizes(tileSize);
+	}
+
+
+	cl::NDRange StencilTiling::getGlobalRange() const
+	{
+		unsigned int nD(gridSize.size());
+		vector<size_t> r(nD);
+		for (unsigned int i(0); i < nD; ++i)
+		{
+			size_t extent(i == 0 ? (kernelSize + strides[0] - 1) / strides[0] : gridSize[i]);
+			r[nD - 1 - i] = (extent + tileSize[i] - 1) / tileSize[i] * tileSize[i];
+		}
+		// the marching dimension is covered by the loop of each work-item
+		if (marching)
+			return nD == 2 ? cl::NDRange(r[0]) : cl::NDRange(r[0], r[1]);
+		if (nD == 1)
+			return cl::NDRange(r[0]);
+		if (nD == 2)
+			return cl::NDRange(r[0], r[1]);
+		return cl::NDRange(r[0], r[1], r[2]);
+	}
+
+
+	cl::NDRange StencilTiling::getLocalRange() const
+	{
+		unsigned int nD(gridSize.size());
+		if (marching)
+			return nD == 2 ? cl::NDRange(tileSize[1]) : cl::NDRange(tileSize[2], tileSize[1]);
+		if (nD == 1)
+			return cl::NDRange(tileSize[0]);
+		if (nD == 2)
+			return cl::NDRange(tileSize[1], tileSize[0]);
+		return cl::NDRange(tileSize[2], tileSize[1], tileSize[0]);
+	}
+
+} // namespace acl
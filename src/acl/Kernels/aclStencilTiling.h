@@ -0,0 +1,182 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef ACLSTENCILTILING_H
+#define ACLSTENCILTILING_H
+
+#include "../aclElementBase.h"
+#include <map>
+#include <set>
+
+namespace cl
+{
+	class NDRange;
+}
+
+namespace acl
+{
+
+	/// Tiled execution of stencil kernels
+	/**	
+		\ingroup KernelGen
+		The index space of the kernel is treated as a grid of size \p gridSize
+		with the last dimension contiguous in memory, the kernel index 0 
+		corresponds to the grid point 0. Each work-group processes a tile of 
+		the grid. The arrays which are not written by the kernel and are read 
+		at several constant shifts of the index (see generateShiftedElement())
+		are loaded with the halo of the tile into __local memory once per 
+		work-group, the shifted reads are served from the local copy.
+
+		The tiled kernels are scalar. The tiles of all arrays take at most 
+		half of the local memory, the remaining arrays are read directly.
+
+		In the marching mode (KernelConfiguration::marching, 2D and 3D grids)
+		each work-item owns a column of the grid along the first (slowest) 
+		dimension and marches along it; the work-group is a tile of columns. 
+		The shifted reads of an array along the marching dimension are kept 
+		in registers which are rolled from plane to plane, only the leading 
+		plane is loaded. No local memory is used, the mode targets the CPU 
+		devices. The "return" of the statements (see returnStatement()) is 
+		replaced by "continue", it should not be used within loops of the 
+		statements.
+	*/
+	class StencilTiling
+	{
+		private:
+			/// array loaded into the local memory
+			struct Field
+			{
+				Element array;
+				/// name of the local copy
+				std::string tile;
+				/// minimal and maximal shifts along each dimension
+				std::vector<int> lo;
+				std::vector<int> hi;
+				/// extents of the local copy
+				std::vector<unsigned int> extents;
+				unsigned int volume;
+			};
+
+			/// registers of an array rolled along the marching dimension
+			struct Column
+			{
+				Element array;
+				/// shift of the column within the plane, in the index space
+				int shift;
+				/// minimal and maximal shifts along the marching dimension
+				int lo;
+				int hi;
+				/// prefix of the register names
+				std::string name;
+			};
+
+			std::vector<unsigned int> gridSize;
+			std::vector<unsigned int> requestedTileSize;
+			/// tile of the last apply(), the first extent is 1 in the marching mode
+			std::vector<unsigned int> tileSize;
+			bool marching;
+			/// limit of the work-items of a tile, 0 if there is no limit
+			size_t groupSizeLimit;
+			/// strides of the grid dimensions in the index space
+			std::vector<int> strides;
+			unsigned int kernelSize;
+			std::vector<Field> fields;
+			std::vector<Column> columns;
+			/// shifts of the reads of each array
+			std::map<Element, std::set<int> > accesses;
+
+			/// returns shifts along the grid dimensions corresponding to \p offset
+			std::vector<int> decompose(int offset) const;
+			/// offset of the shift \p offset within the local copy of \p field
+			unsigned int localOffset(const Field & field, int offset) const;
+			const Field * findField(const Element & array) const;
+			const Column * findColumn(const Element & array, int shift) const;
+			/// declares the columns of \p array read at \p offsets
+			void addColumns(const Element & array, const std::set<int> & offsets);
+			/// code loading register \p k of \p column for the plane \p plane
+			std::string loadRegister(const Column & column,
+			                         int k,
+			                         const std::string & plane,
+			                         const std::string & indent) const;
+			std::string getMarchingCode() const;
+			void collect(const Element & e);
+			Element rewrite(const Element & e);
+
+			/// true if \p e reads an array at the index shifted by \p offset
+			static bool parseAccess(const Element & e, Element & array, int & offset);
+			/// true if \p e is the index shifted by \p shift
+			static bool parseFilter(const Element & e, int & shift);
+		public:
+			/// empty \p tileSize_ selects the default tile
+			StencilTiling(const std::vector<unsigned int> & gridSize_,
+			              const std::vector<unsigned int> & tileSize_ = std::vector<unsigned int>());
+			/// Returns copy of \p expression reading the tiled arrays from the local memory
+			/// or, if \p marching_ is true, from the rolled registers.
+			/// \p writtenArguments should be sorted
+			std::vector<Element> apply(const std::vector<Element> & expression,
+			                           const std::vector<Element> & writtenArguments,
+			                           unsigned int kernelSize_,
+			                           const CommandQueue & queue,
+			                           bool marching_ = false);
+			/// Limits the number of work-items of a tile in the subsequent apply(),
+			/// e.g. to CL_KERNEL_WORK_GROUP_SIZE of the built kernel; 0 removes the limit
+			void setGroupSizeLimit(size_t n);
+			/// Returns the number of work-items of a tile of the last apply()
+			size_t getGroupSize() const;
+			/// Returns code computing the index and loading the tiles; the statements
+			/// of the kernel have to be executed only if "inside" is true
+			std::string getIndexCode() const;
+			/// Returns code following the statements, closes the marching loop
+			std::string getClosingCode() const;
+			/// Returns \p statement adapted to the execution mode
+			std::string adaptStatement(const std::string & statement) const;
+			cl::NDRange getGlobalRange() const;
+			cl::NDRange getLocalRange() const;
+			/// Returns number of the arrays loaded into the local memory by the last apply()
+			inline unsigned int getNTiledFields() const;
+			/// true if the grid allows the marching mode (2D and 3D grids)
+			inline bool isMarchingSupported() const;
+			/// true if the device of \p queue has dedicated local memory, 
+			/// on other devices (CPUs) the tiling brings no benefit
+			static bool isSupported(const CommandQueue & queue);
+			/// name of the flag of the work-items within the kernel range
+			static const std::string INSIDE;
+	};
+
+//---------------------------- Implementation -----------------------------
+
+	inline unsigned int StencilTiling::getNTiledFields() const
+	{
+		return fields.size();
+	}
+
+
+	inline bool StencilTiling::isMarchingSupported() const
+	{
+		return gridSize.size() > 1;
+	}
+
+} // namespace acl
+
+#endif // ACLSTENCILTILING_H
@@ -0,0 +1,214 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include "aclStepRecorder.h"
+#include "aclKernel.h"
+#include "aclKernelProfiler.h"
+#include "../DataTypes/aclMemBlock.h"
+#include "../../aslUtilities.h"
+
+using namespace std;
+using namespace asl;
+
+namespace acl
+{
+
+	StepRecorder * StepRecorder::current = NULL;
+	unsigned int StepRecorder::suspensionLevel = 0;
+
+
+	StepRecorder::Suspension::Suspension()
+	{
+		++suspensionLevel;
+	}
+
+
+	StepRecorder::Suspension::~Suspension()
+	{
+		--suspensionLevel;
+	}
+
+
+	StepRecorder::StepRecorder():
+		nUnmarkedLaunches(0)
+	{
+	}
+
+
+	StepRecorder::~StepRecorder()
+	{
+		if (current == this)
+			current = NULL;
+	}
+
+
+	void StepRecorder::begin()
+	{
+		if (current != NULL)
+			errorMessage("StepRecorder::begin() - another recording is in progress");
+		clear();
+		current = this;
+	}
+
+
+	void StepRecorder::end()
+	{
+		if (current != this)
+			errorMessage("StepRecorder::end() - the recorder is not recording");
+		current = NULL;
+
+		for (unsigned int i(0); i < commands.size(); ++i)
+		{
+			Kernel * k(commands[i].kernel);
+			if (k == NULL)
+				continue;
+			if (!queue)
+				queue = k->queue;
+			else if (queue != k->queue)
+			{
+				queue.reset();
+				break;
+			}
+		}
+	}
+
+
+	void StepRecorder::clear()
+	{
+		commands.clear();
+		queue.reset();
+		nUnmarkedLaunches = 0;
+	}
+
+
+	bool StepRecorder::recording()
+	{
+		return current != NULL && suspensionLevel == 0;
+	}
+
+
+	void StepRecorder::addLaunch(Kernel * k)
+	{
+		Command c;
+		c.kernel = k;
+		current->commands.push_back(c);
+	}
+
+
+	void StepRecorder::hostAction(const function<void()> & action)
+	{
+		if (recording())
+		{
+			Command c;
+			c.kernel = NULL;
+			c.action = action;
+			current->commands.push_back(c);
+		}
+		Suspension suspension;
+		action();
+	}
+
+
+	bool StepRecorder::prebound() const
+	{
+		// the profiler needs an event of each launch
+		return queue && !kernelProfiler.isEnabled();
+	}
+
+
+	void StepRecorder::waitForArguments()
+	{
+		vector<cl::Event> dependencies;
+		for (unsigned int i(0); i < commands.size(); ++i)
+		{
+			Kernel * k(commands[i].kernel);
+			if (k != NULL)
+				for (unsigned int j(0); j < k->memBlockArguments.size(); ++j)
+					k->memBlockArguments[j]->getDependencies(dependencies, true);
+		}
+		if (dependencies.empty())
+			return;
+		cl_int status(queue->enqueueBarrierWithWaitList(&dependencies));
+		errorMessage(status, "CommandQueue::enqueueBarrierWithWaitList() - StepRecorder");
+	}
+
+
+	void StepRecorder::markArguments()
+	{
+		if (nUnmarkedLaunches == 0)
+			return;
+
+		// the marker follows all launches of the in-order queue
+		cl::Event marker;
+		cl_int status(queue->enqueueMarkerWithWaitList(NULL, &marker));
+		errorMessage(status, "CommandQueue::enqueueMarkerWithWaitList() - StepRecorder");
+		for (unsigned int i(0); i < commands.size(); ++i)
+		{
+			Kernel * k(commands[i].kernel);
+			if (k != NULL)
+				for (unsigned int j(0); j < k->memBlockArguments.size(); ++j)
+					k->memBlockArguments[j]->registerAccess(marker, k->memBlockArgumentsWritten[j]);
+		}
+		nUnmarkedLaunches = 0;
+	}
+
+
+	void StepRecorder::replay(unsigned int n)
+	{
+		if (current == this)
+			errorMessage("StepRecorder::replay() - the recording is not finished");
+
+		if (!prebound())
+		{
+			for (unsigned int j(0); j < n; ++j)
+				for (unsigned int i(0); i < commands.size(); ++i)
+					if (commands[i].kernel != NULL)
+						commands[i].kernel->computeAsync();
+					else
+						commands[i].action();
+			return;
+		}
+
+		for (unsigned int j(0); j < n; ++j)
+		{
+			for (unsigned int i(0); i < commands.size(); ++i)
+			{
+				if (commands[i].kernel != NULL)
+				{
+					if (nUnmarkedLaunches == 0)
+						waitForArguments();
+					commands[i].kernel->launchPrebound();
+					++nUnmarkedLaunches;
+				}
+				else
+				{
+					markArguments();
+					commands[i].action();
+				}
+			}
+		}
+		markArguments();
+	}
+
+} // namespace acl
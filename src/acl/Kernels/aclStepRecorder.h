@@ -0,0 +1,145 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef ACLSTEPRECORDER_H
+#define ACLSTEPRECORDER_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+//#include <CL/cl.hpp>
+// Supply "cl.hpp" with ASL, since it is not present in OpenCL 2.0
+// Remove the file after switching to OpenCL 2.1
+#include "acl/cl.hpp"
+
+namespace acl
+{
+	class Kernel;
+	typedef std::shared_ptr<cl::CommandQueue> CommandQueue;
+
+	/// Records the kernel launches of a time step and replays them
+	/**	
+		\ingroup KernelGen
+		The launches of Kernel::computeAsync() between begin() and end() 
+		are executed and recorded into a command list. The host-side parts 
+		of a step which depend on the state (the buffer swaps, the shifts 
+		and the conditional copy kernels of the numerical methods) are 
+		passed to hostAction(): they are executed at each replay, the 
+		launches within them are not recorded. 
+
+		replay() submits the list with minimal host overhead: if all 
+		recorded kernels share one queue and the profiling is off, the 
+		launches are enqueued in order without events, their arguments
+		are set only if changed. The dependencies on other commands are 
+		resolved once before the launches and the MemBlock arguments are 
+		marked as accessed before each host action and at the end of 
+		replay(), so acl::copy() and MemBlock::map() wait as usual.
+		Otherwise the launches go through Kernel::computeAsync().
+
+		The recorded kernels have to exist while the recorder is used.
+		The command-buffer extensions are not used: the recorded steps 
+		change their arguments and contain host actions.
+
+		\code
+		StepRecorder step;
+		step.begin();
+		lbgk->execute();
+		executeAll(bc);
+		step.end();
+		for (unsigned int i(0); i < 100; ++i)
+			step.replay(10);
+		\endcode
+	*/
+	class StepRecorder
+	{
+		public:
+			/// Launches within the scope of an object of this class are not recorded
+			class Suspension
+			{
+				public:
+					Suspension();
+					~Suspension();
+			};
+		private:
+			/// launch of \p kernel or, if it is NULL, execution of \p action
+			struct Command
+			{
+				Kernel * kernel;
+				std::function<void()> action;
+			};
+			std::vector<Command> commands;
+			/// queue of all recorded kernels, NULL if they use different queues
+			CommandQueue queue;
+			/// number of launches enqueued since the last marking of the arguments
+			unsigned int nUnmarkedLaunches;
+
+			/// the recorder capturing the launches, NULL if none
+			static StepRecorder * current;
+			static unsigned int suspensionLevel;
+
+			/// true if the launches can be enqueued without events
+			bool prebound() const;
+			/// enqueues a barrier waiting for other commands on the arguments
+			void waitForArguments();
+			/// registers a marker as access to the arguments of the recorded kernels
+			void markArguments();
+		public:
+			StepRecorder();
+			~StepRecorder();
+			/// starts recording, the previous list is removed
+			void begin();
+			void end();
+			/// submits the recorded list \p n times without waiting for its completion
+			void replay(unsigned int n = 1);
+			void clear();
+			inline unsigned int getNLaunches() const;
+			inline unsigned int getNHostActions() const;
+
+			/// returns true if launches are recorded currently
+			static bool recording();
+			static void addLaunch(Kernel * k);
+			/// Executes \p action and, if recording, adds it to the list; 
+			/// launches within \p action are not recorded
+			static void hostAction(const std::function<void()> & action);
+	};
+
+//---------------------------- Implementation -----------------------------
+
+	inline unsigned int StepRecorder::getNLaunches() const
+	{
+		unsigned int n(0);
+		for (unsigned int i(0); i < commands.size(); ++i)
+			n += commands[i].kernel != NULL;
+		return n;
+	}
+
+
+	inline unsigned int StepRecorder::getNHostActions() const
+	{
+		return commands.size() - getNLaunches();
+	}
+
+} // namespace acl
+
+#endif // ACLSTEPRECORDER_H
@@ -24,16 +24,32 @@
 
 set(aclkernels_PUBLIC_HEADERS
 	Kernels/aclExpressionContainer.h
+	Kernels/aclExpressionOptimizer.h
+	Kernels/aclStencilTiling.h
 	Kernels/aclKernel.h
 	Kernels/aclKernelConfiguration.h
 	Kernels/aclKernelConfigurationTemplates.h
 	Kernels/aclKernelMerger.h
+	Kernels/aclKernelFusion.h
+	Kernels/aclKernelProfiler.h
+	Kernels/aclKernelTuner.h
+	Kernels/aclParallelBuild.h
+	Kernels/aclProgramCache.h
+	Kernels/aclStepRecorder.h
 )
 
 set(aclkernels_SOURCES
 	Kernels/aclExpressionContainer.cxx
+	Kernels/aclExpressionOptimizer.cxx
+	Kernels/aclStencilTiling.cxx
 	Kernels/aclKernel.cxx
 	Kernels/aclKernelConfiguration.cxx
 	Kernels/aclKernelConfigurationTemplates.cxx
 	Kernels/aclKernelMerger.cxx
+	Kernels/aclKernelFusion.cxx
+	Kernels/aclKernelProfiler.cxx
+	Kernels/aclKernelTuner.cxx
+	Kernels/aclParallelBuild.cxx
+	Kernels/aclProgramCache.cxx
+	Kernels/aclStepRecorder.cxx
 )
@@ -22,6 +22,7 @@
 
 
 #include "aclElementAssignmentSafe.h"
+#include "../aclUtilities.h"
 #include "../../aslUtilities.h"
 #include "../Kernels/aclKernelConfigurationTemplates.h"
 
@@ -38,6 +39,9 @@ string ElementAssignmentSafe::str(const KernelConfiguration & kernelConfig) cons
 {
 	string e1s(e1->str(KERNEL_BASIC));
 	string e2s(e2->str(kernelConfig));	
+	string store(e1->strStore(e2s, kernelConfig));
+	if (!store.empty())
+		return store;
 
 	if (kernelConfig.unaligned && kernelConfig.vectorWidth > 1)
 	{
@@ -50,4 +54,17 @@ string ElementAssignmentSafe::str(const KernelConfiguration & kernelConfig) cons
 }
 
 
+void ElementAssignmentSafe::addToWrittenArguments(vector<Element> & writtenArguments) const
+{
+	addElementToWrittenArguments(e1, writtenArguments);
+	OperatorBinary::addToWrittenArguments(writtenArguments);
+}
+
+
+void ElementAssignmentSafe::addToReadArguments(vector<Element> & readArguments) const
+{
+	addElementToReadArguments(e2, readArguments);
+}
+
+
 } // namespace acl
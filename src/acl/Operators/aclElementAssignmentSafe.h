@@ -34,6 +34,8 @@ class ElementAssignmentSafe: public OperatorBinary
 	public:
 		ElementAssignmentSafe(Element a1, Element a2);
 		virtual string str(const KernelConfiguration & kernelConfig) const;
+		virtual void addToWrittenArguments(vector<Element> & writtenArguments) const;
+		virtual void addToReadArguments(vector<Element> & readArguments) const;
 };
 
 } // namespace acl
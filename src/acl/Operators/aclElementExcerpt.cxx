@@ -33,7 +33,7 @@ namespace acl
 ElementExcerpt::ElementExcerpt(Element source_, Element filter_):
 	ElementBase(source_->isWritable, filter_->getSize(), source_->getTypeID())
 {
-	if (onSameDevice(source_, filter_))
+	if (inSameContext(source_->getQueue(), filter_->getQueue()))
 	{
 		source = source_;
 		filter = filter_;
@@ -51,15 +51,15 @@ ElementExcerpt::ElementExcerpt(Element source_, Element filter_):
 }
 
 
-string ElementExcerpt::str(const KernelConfiguration & kernelConfig) const
+// Replaces all occurrences of INDEX in \p s by \p filter
+string replaceIndex(string s, const string & filter)
 {
-	string s = source->str(kernelConfig);
 	size_t found = s.find(INDEX);
 
-	int filterSize(filter->str(kernelConfig).size());
+	int filterSize(filter.size());
 	while (found != string::npos)
 	{
-		s.replace(found, INDEX.size(), filter->str(kernelConfig));
+		s.replace(found, INDEX.size(), filter);
 		found = s.find(INDEX, found + filterSize);
 	}
 
@@ -67,6 +67,26 @@ string ElementExcerpt::str(const KernelConfiguration & kernelConfig) const
 }
 
 
+string ElementExcerpt::str(const KernelConfiguration & kernelConfig) const
+{
+	return replaceIndex(source->str(kernelConfig), filter->str(kernelConfig));
+}
+
+
+string ElementExcerpt::strStore(const string & value, const KernelConfiguration & kernelConfig) const
+{
+	// the value is inserted after the replacement, its INDEX belongs to other elements
+	const string placeholder("\x01");
+	string s(source->strStore(placeholder, kernelConfig));
+	if (s.empty())
+		return s;
+
+	s = replaceIndex(s, filter->str(kernelConfig));
+	s.replace(s.find(placeholder), placeholder.size(), value);
+	return s;
+}
+
+
 void ElementExcerpt::addToKernelSource(vector<Element> & arguments,
 		                               vector<Element> & localDeclarations) const
 {
@@ -80,6 +100,20 @@ void ElementExcerpt::setAsArgument(cl::Kernel & kernel, unsigned int argumentInd
 }
 
 
+void ElementExcerpt::addToWrittenArguments(vector<Element> & writtenArguments) const
+{
+	source->addToWrittenArguments(writtenArguments);
+	filter->addToWrittenArguments(writtenArguments);
+}
+
+
+void ElementExcerpt::addToReadArguments(vector<Element> & readArguments) const
+{
+	source->addToReadArguments(readArguments);
+	addElementToReadArguments(filter, readArguments);
+}
+
+
 string ElementExcerpt::getName() const
 {
 	return "";
@@ -30,12 +30,15 @@
 namespace acl
 {
 
+class ExpressionOptimizer;
+
 /// Creates excerpt from source defined by filter
 /// by replacing of "INDEX" occurrences
 /// in source_->str() by filter_->str()
 
 class ElementExcerpt: public ElementBase
 {
+	friend class ExpressionOptimizer;
 	protected:
 		Element source;
 		Element filter;
@@ -47,7 +50,10 @@ class ElementExcerpt: public ElementBase
 		virtual void addToKernelSource(vector<Element> & arguments,
 		                               vector<Element> & localDeclarations) const;
 		virtual void setAsArgument(cl::Kernel & kernel, unsigned int argumentIndex) const;
+		virtual void addToWrittenArguments(vector<Element> & writtenArguments) const;
+		virtual void addToReadArguments(vector<Element> & readArguments) const;
 		virtual string str(const KernelConfiguration & kernelConfig) const;
+		virtual string strStore(const string & value, const KernelConfiguration & kernelConfig) const;
 };
 
 } // namespace acl
@@ -120,6 +120,19 @@ void ElementFor::setAsArgument(cl::Kernel & kernel, unsigned int argumentIndex)
 }
 
 
+void ElementFor::addToWrittenArguments(vector<Element> & writtenArguments) const
+{
+	initialization->addToWrittenArguments(writtenArguments);
+	condition->addToWrittenArguments(writtenArguments);
+	increase->addToWrittenArguments(writtenArguments);
+
+	for (unsigned int i = 0; i < expression.size(); i++)
+	{
+		expression[i]->addToWrittenArguments(writtenArguments);
+	}
+}
+
+
 string ElementFor::getName() const
 {
 	return "";
@@ -22,6 +22,7 @@
 
 
 #include "aclElementGenericBinary.h"
+#include "../aclUtilities.h"
 
 using namespace acl;
 
@@ -34,7 +35,46 @@ ElementGenericBinary::ElementGenericBinary(Element a1, Element a2, const string
 
 string ElementGenericBinary::str(const KernelConfiguration & kernelConfig) const
 {
-		return "(" + e1->str(kernelConfig) + operation + e2->str(kernelConfig) + ")";
+		string e1s(e1->str(kernelConfig));
+		string e2s(e2->str(kernelConfig));
+		if (isAssignment())
+		{
+			// the compound assignments are expanded for the converting stores
+			string s(e1->strStore(operation == "=" ? e2s : "(" + e1s + operation[0] + e2s + ")",
+			                      kernelConfig));
+			if (!s.empty())
+				return s;
+		}
+		return "(" + e1s + operation + e2s + ")";
+}
+
+
+bool ElementGenericBinary::isAssignment() const
+{
+	return operation == "=" || operation == "+=" || operation == "-=" ||
+	       operation == "*=" || operation == "/=";
+}
+
+
+void ElementGenericBinary::addToWrittenArguments(vector<Element> & writtenArguments) const
+{
+	if (isAssignment())
+		addElementToWrittenArguments(e1, writtenArguments);
+	OperatorBinary::addToWrittenArguments(writtenArguments);
+}
+
+
+void ElementGenericBinary::addToReadArguments(vector<Element> & readArguments) const
+{
+	if (!isAssignment())
+	{
+		OperatorBinary::addToReadArguments(readArguments);
+		return;
+	}
+	// the compound assignments read their targets
+	if (operation != "=")
+		addElementToReadArguments(e1, readArguments);
+	addElementToReadArguments(e2, readArguments);
 }
 
 
@@ -32,16 +32,22 @@ namespace acl
 	///\todo{Add optimization for Singlevalued elements on function level}
 	class ElementGenericBinary: public OperatorBinary
 	{
+		friend class ExpressionOptimizer;
 		private:
 			const string operation;
+			/// true for "=" and the compound assignments
+			bool isAssignment() const;
 		public:
 			ElementGenericBinary(Element a1, Element a2, const string & operation_);
 			virtual string str(const KernelConfiguration & kernelConfig) const;
+			virtual void addToWrittenArguments(vector<Element> & writtenArguments) const;
+			virtual void addToReadArguments(vector<Element> & readArguments) const;
 	};
 
 
 	class ElementGenericBinaryFunction: public OperatorBinary
 	{
+		friend class ExpressionOptimizer;
 		private:
 			const string functionName;
 		public:
@@ -30,6 +30,7 @@ namespace acl
 {
 	class ElementGenericUnary: public OperatorUnary
 	{
+		friend class ExpressionOptimizer;
 		private:
 			const string operation;
 			bool outside;
@@ -40,6 +41,7 @@ namespace acl
 
 	class ElementGenericUnarySIMD: public OperatorUnary
 	{
+		friend class ExpressionOptimizer;
 		private:
 			const string operation;
 			bool outside;
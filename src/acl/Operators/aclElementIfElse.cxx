@@ -133,6 +133,38 @@ void ElementIfElse::setAsArgument(cl::Kernel & kernel, unsigned int argumentInde
 }
 
 
+void ElementIfElse::addToWrittenArguments(vector<Element> & writtenArguments) const
+{
+	condition->addToWrittenArguments(writtenArguments);
+
+	for (unsigned int i = 0; i < expressionIf.size(); i++)
+	{
+		expressionIf[i]->addToWrittenArguments(writtenArguments);
+	}
+
+	for (unsigned int i = 0; i < expressionElse.size(); i++)
+	{
+		expressionElse[i]->addToWrittenArguments(writtenArguments);
+	}
+}
+
+
+void ElementIfElse::addToReadArguments(vector<Element> & readArguments) const
+{
+	addElementToReadArguments(condition, readArguments);
+
+	for (unsigned int i = 0; i < expressionIf.size(); i++)
+	{
+		expressionIf[i]->addToReadArguments(readArguments);
+	}
+
+	for (unsigned int i = 0; i < expressionElse.size(); i++)
+	{
+		expressionElse[i]->addToReadArguments(readArguments);
+	}
+}
+
+
 string ElementIfElse::getName() const
 {
 	return "";
@@ -30,9 +30,12 @@
 namespace acl
 {
 
+class ExpressionOptimizer;
+
 /// If-Else conditional structure
 class ElementIfElse: public ElementBase
 {
+	friend class ExpressionOptimizer;
 	protected:
 		vector<Element> expressionIf;
 		vector<Element> expressionElse;
@@ -47,6 +50,8 @@ class ElementIfElse: public ElementBase
 		virtual void addToKernelSource(vector<Element> & arguments,
 		                               vector<Element> & localDeclarations) const;
 		virtual void setAsArgument(cl::Kernel & kernel, unsigned int argumentIndex) const;
+		virtual void addToWrittenArguments(vector<Element> & writtenArguments) const;
+		virtual void addToReadArguments(vector<Element> & readArguments) const;
 		virtual string str(const KernelConfiguration & kernelConfig) const;
 };
 
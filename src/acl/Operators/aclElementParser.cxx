@@ -102,6 +102,16 @@ void ElementParser::setAsArgument(cl::Kernel & kernel, unsigned int argumentInde
 }
 
 
+// The statement is not analyzed, all elements are considered as written
+void ElementParser::addToWrittenArguments(vector<Element> & writtenArguments) const
+{
+	for (unsigned int i = 0; i < elementNamePairs.size(); ++i)
+	{
+		addElementToWrittenArguments(elementNamePairs[i].first, writtenArguments);
+	}
+}
+
+
 string ElementParser::getName() const
 {
 	return "";
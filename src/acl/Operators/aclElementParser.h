@@ -49,6 +49,7 @@ class ElementParser: public ElementBase
 		virtual void addToKernelSource(vector<Element> & arguments,
 		                               vector<Element> & localDeclarations) const;
 		virtual void setAsArgument(cl::Kernel & kernel, unsigned int argumentIndex) const;
+		virtual void addToWrittenArguments(vector<Element> & writtenArguments) const;
 		virtual string str(const KernelConfiguration & kernelConfig) const;
 };
 
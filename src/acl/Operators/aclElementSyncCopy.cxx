@@ -110,6 +110,12 @@ void ElementSyncCopy::setAsArgument(cl::Kernel & kernel, unsigned int argumentIn
 }
 
 
+void ElementSyncCopy::addToWrittenArguments(vector<Element> & writtenArguments) const
+{
+	addElementToWrittenArguments(destination, writtenArguments);
+}
+
+
 string ElementSyncCopy::getName() const
 {
 	return "";
@@ -53,6 +53,7 @@ class ElementSyncCopy: public ElementBase
 		virtual void addToKernelSource(vector<Element> & arguments,
 		                               vector<Element> & localDeclarations) const;
 		virtual void setAsArgument(cl::Kernel & kernel, unsigned int argumentIndex) const;
+		virtual void addToWrittenArguments(vector<Element> & writtenArguments) const;
 		virtual string str(const KernelConfiguration & kernelConfig) const;
 };
 
@@ -23,6 +23,7 @@
 
 #include "aclGenericAtomicFunction.h"
 #include "../../aslUtilities.h"
+#include "../aclUtilities.h"
 
 
 namespace acl
@@ -42,4 +43,11 @@ string ElementGenericAtomicFunction::str(const KernelConfiguration & kernelConfi
 	return functionName + "(&" + e1->str(kernelConfig) + ", " + e2->str(kernelConfig) + ")";
 }
 
+
+void ElementGenericAtomicFunction::addToWrittenArguments(vector<Element> & writtenArguments) const
+{
+	addElementToWrittenArguments(e1, writtenArguments);
+	OperatorBinary::addToWrittenArguments(writtenArguments);
+}
+
 } // namespace acl
@@ -36,6 +36,7 @@ namespace acl
 		public:
 			ElementGenericAtomicFunction(Element a1, Element a2, const string & operation_);
 			virtual string str(const KernelConfiguration & kernelConfig) const;
+			virtual void addToWrittenArguments(vector<Element> & writtenArguments) const;
 	};
 
 } // namespace acl
@@ -68,6 +68,13 @@ namespace acl
 	}
 
 
+	void OperatorBinary::addToWrittenArguments(vector<Element> & writtenArguments) const
+	{
+		e1->addToWrittenArguments(writtenArguments);
+		e2->addToWrittenArguments(writtenArguments);
+	}
+
+
 	string OperatorBinary::getName() const
 	{
 		return "";
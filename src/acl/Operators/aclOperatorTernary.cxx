@@ -77,6 +77,14 @@ namespace acl
 	}
 
 
+	void OperatorTernary::addToWrittenArguments(vector<Element> & writtenArguments) const
+	{
+		e1->addToWrittenArguments(writtenArguments);
+		e2->addToWrittenArguments(writtenArguments);
+		e3->addToWrittenArguments(writtenArguments);
+	}
+
+
 	string OperatorTernary::getName() const
 	{
 		return "";
@@ -57,6 +57,12 @@ namespace acl
 	}
 
 
+	void OperatorUnary::addToWrittenArguments(vector<Element> & writtenArguments) const
+	{
+		e->addToWrittenArguments(writtenArguments);
+	}
+
+
 	string OperatorUnary::getName() const
 	{
 		return "";
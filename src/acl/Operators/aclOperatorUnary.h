@@ -28,9 +28,11 @@
 
 namespace acl
 {
+	class ExpressionOptimizer;
 
 	class OperatorUnary: public ElementBase
 	{
+		friend class ExpressionOptimizer;
 		protected:
 			Element e;
 			OperatorUnary(Element a);
@@ -42,6 +44,7 @@ namespace acl
 			virtual void addToKernelSource(vector<Element> & arguments,
 			                               vector<Element> & localDeclarations) const;
 			virtual void setAsArgument(cl::Kernel & kernel, unsigned int argumentIndex) const;
+			virtual void addToWrittenArguments(vector<Element> & writtenArguments) const;
 	};
 	
 } // namespace acl
@@ -43,11 +43,14 @@
 #include "Operators/aclElementSyncCopy.h"
 #include "Operators/aclElementConvert.h"
 #include "../aslUtilities.h"
+#include <cstring>
 #include "Kernels/aclKernel.h"
 #include "DataTypes/aclConstant.h"
+#include "aclTypesList.h"
 #include "DataTypes/aclIndex.h"
 #include "DataTypes/aclVariableReference.h"
 #include "DataTypes/aclArray.h"
+#include "DataTypes/aclArrayHalf.h"
 #include "DataTypes/aclLocalArray.h"
 #include "Kernels/aclExpressionContainer.h"
 #include "aclMath/aclVectorOfElementsDef.h"
@@ -422,8 +425,14 @@ namespace acl
 	
 	//	RTTI functions
 
-	bool isConstant()
+	bool isConstant(Element e)
 	{
+		#define BOOST_TT_rep_expression(r, data, t) \
+			if (dynamic_cast<Constant<t>*>(e.get()) != NULL) \
+				return true;
+		BOOST_PP_SEQ_FOR_EACH(BOOST_TT_rep_expression, ~, BOOST_TT_acl_types)
+		#undef BOOST_TT_rep_expression
+
 		return false;
 	}
 	
@@ -442,15 +451,37 @@ namespace acl
 	/// Copies source to destination, resizes destination to accommodate source.
 	template <typename T> void copy(MemBlock & source, T* destination)
 	{
+		// reduced precision storage is converted on the host
+		if (source.getElementSize() != sizeof(T))
+		{
+			if (source.getElementSize() != sizeof(cl_half))
+				errorMessage("copy() - the MemBlock element size does not match the type");
+			vector<cl_half> h(source.getSize());
+			copy(source, &h[0]);
+			for (unsigned int i(0); i < h.size(); ++i)
+				destination[i] = halfToFloat(h[i]);
+			return;
+		}
+
+		// zero-copy buffer: the mapping is a pointer hand-off
+		if (source.isHostVisible())
+		{
+			shared_ptr<void> p(source.map(0, source.getSize(), CL_MAP_READ));
+			memcpy(destination, p.get(), source.getSize() * sizeof(T));
+			return;
+		}
+
 		cl_int status = 0;
 		cl::Event event;
+		vector<cl::Event> dependencies;
+		source.getDependencies(dependencies, false);
 		// Enqueue readBuffer. Blocking read (CL_TRUE)!
 		status = source.getQueue()->enqueueReadBuffer(source.getBuffer(),
 		                                              CL_TRUE,
 		                                              0,
 		                                              source.getSize() * sizeof(T),
 		                                              destination,
-		                                              NULL,
+		                                              &dependencies,
 		                                              &event);
 		
 		errorMessage(status, "queue::enqueueReadBuffer()");
@@ -458,6 +489,33 @@ namespace acl
 		errorMessage(status, "Event::wait() - event");
 	}
 	
+	template <typename T> cl::Event copyAsync(MemBlock & source, T* destination)
+	{
+		if (source.getElementSize() != sizeof(T))
+			errorMessage("copyAsync() - the MemBlock element size does not match the type");
+
+		cl_int status = 0;
+		cl::Event event;
+		vector<cl::Event> dependencies;
+		source.getDependencies(dependencies, false);
+		// Non-blocking read (CL_FALSE)
+		status = source.getQueue()->enqueueReadBuffer(source.getBuffer(),
+		                                              CL_FALSE,
+		                                              0,
+		                                              source.getSize() * sizeof(T),
+		                                              destination,
+		                                              &dependencies,
+		                                              &event);
+		errorMessage(status, "queue::enqueueReadBuffer()");
+		source.registerAccess(event, false);
+		return event;
+	}
+
+	template cl::Event copyAsync(MemBlock & source, cl_int* destination);
+	template cl::Event copyAsync(MemBlock & source, cl_float* destination);
+	template cl::Event copyAsync(MemBlock & source, cl_double* destination);
+
+	
 	/// Copies source to destination, resizes destination to accommodate source.
 	template <typename T> void copy(MemBlock & source, std::vector<T> & destination)
 	{
@@ -476,6 +534,7 @@ namespace acl
 	}
 
 	template void copy(Element source, std::vector<cl_int> &destination);
+	template void copy(Element source, std::vector<cl_uint> &destination);
 	template void copy(Element source, std::vector<cl_float> &destination);
 	template void copy(Element source, std::vector<cl_double> &destination);
 
@@ -488,25 +547,51 @@ namespace acl
 	}
 
 	template void copy(Element source, cl_int* destination);
+	template void copy(Element source, cl_uint* destination);
 	template void copy(Element source, cl_float* destination);
 	template void copy(Element source, cl_double* destination);
 	
 	
 	template <typename T> void copy(T* source, MemBlock & destination)
 	{
+		// reduced precision storage is converted on the host
+		if (destination.getElementSize() != sizeof(T))
+		{
+			if (destination.getElementSize() != sizeof(cl_half))
+				errorMessage("copy() - the MemBlock element size does not match the type");
+			vector<cl_half> h(destination.getSize());
+			for (unsigned int i(0); i < h.size(); ++i)
+				h[i] = floatToHalf(source[i]);
+			copy(&h[0], destination);
+			return;
+		}
+
+		// zero-copy buffer: the mapping is a pointer hand-off
+		if (destination.isHostVisible())
+		{
+			shared_ptr<void> p(destination.map(0, destination.getSize(), CL_MAP_WRITE_INVALIDATE_REGION));
+			memcpy(p.get(), &source[0], destination.getSize() * sizeof(T));
+			p.reset();
+			destination.markWritten();
+			return;
+		}
+
 		cl_int status = 0;
 		cl::Event event;		
+		vector<cl::Event> dependencies;
+		destination.getDependencies(dependencies, true);
 		// Write data to buffer 
 		status = destination.getQueue()->enqueueWriteBuffer(destination.getBuffer(),
 		                                                    CL_TRUE,
 		                                                    0,
 		                                                    destination.getSize() * sizeof(T),
 		                                                    &source[0],
-		                                                    NULL,
+		                                                    &dependencies,
 		                                                    &event);
 		errorMessage(status, "copy() - queue::enqueueWriteBuffer()");
 		status = event.wait();
 		errorMessage(status, "Event::wait() - event");
+		destination.registerAccess(event, true);
 		
 	}
 
@@ -530,8 +615,8 @@ namespace acl
 			}
 			else
 			{
-				shared_ptr<void> buffer = source.map();
-				copy((T *)buffer, destination);
+				shared_ptr<void> buffer = source.map(0, source.getSize(), CL_MAP_READ);
+				copy((T *)buffer.get(), destination);
 			}
 		}
 		else
@@ -541,6 +626,40 @@ namespace acl
 		    
 	}
 	
+	void copy(MemBlock & source, unsigned int sourceOffset,
+	          MemBlock & destination, unsigned int destinationOffset,
+	          unsigned int n)
+	{
+		if (source.getTypeID() != destination.getTypeID() ||
+		    source.getElementSize() != destination.getElementSize())
+			errorMessage("copy() - types of the MemBlocks do not match");
+		if ((sourceOffset + n > source.getSize()) || (destinationOffset + n > destination.getSize()))
+			errorMessage("copy() - the region exceeds the MemBlock size");
+		if (!inSameContext(source.getQueue(), destination.getQueue()))
+			errorMessage("copy() - the MemBlocks do not share the context");
+
+		if (n == 0)
+			return;
+
+		const unsigned int typeSize(source.getElementSize());
+		cl_int status = 0;
+		cl::Event event;
+		vector<cl::Event> dependencies;
+		source.getDependencies(dependencies, false);
+		destination.getDependencies(dependencies, true);
+		status = destination.getQueue()->enqueueCopyBuffer(source.getBuffer(),
+		                                                   destination.getBuffer(),
+		                                                   sourceOffset * typeSize,
+		                                                   destinationOffset * typeSize,
+		                                                   n * typeSize,
+		                                                   &dependencies,
+		                                                   &event);
+		errorMessage(status, "copy() - queue::enqueueCopyBuffer()");
+		source.registerAccess(event, false);
+		destination.registerAccess(event, true);
+	}
+
+
 	template <typename T> void copy(std::vector<T> & source, Element destination)
 	{
 		if (isMemBlock(destination))
@@ -550,6 +669,7 @@ namespace acl
 	}
 
 	template void copy(std::vector<cl_int> & source, Element destination);
+	template void copy(std::vector<cl_uint> & source, Element destination);
 	template void copy(std::vector<cl_float> & source, Element destination);
 	template void copy(std::vector<cl_double> & source, Element destination);
 
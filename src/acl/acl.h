@@ -33,6 +33,7 @@
 namespace cl
 {
 	class CommandQueue;
+	class Event;
 }
 
 
@@ -375,6 +376,7 @@ namespace acl
 	
 	//	RTTI functions
 
+	/// checks whether \p e is a Constant of any type
 	bool isConstant(Element e);
 
 	/// The function returns true when the input is a single valued object e.g. aclConstatnt, aclVariable 
@@ -394,6 +396,11 @@ namespace acl
 	/// \ingroup HostInteractionFunctions
 	template <typename T> void copy(MemBlock &source, std::vector<T> &destination);
 
+	/// Starts copying of source to destination and returns the event of the copy;
+	/// \p destination has to stay valid till the event is complete.
+	/// \ingroup HostInteractionFunctions
+	template <typename T> cl::Event copyAsync(MemBlock &source, T* destination);
+
 	/// Copies source to destination, exit(1) if sizes do not match.
 	/// \ingroup HostInteractionFunctions
 	template <typename T> void copy(std::vector<T> &source, MemBlock &destination);
@@ -402,6 +409,14 @@ namespace acl
 	/// \ingroup HostInteractionFunctions
 	template <typename T> void copy(MemBlock &source, MemBlock &destination);
 
+	/// Copies \p n elements of \p source starting at \p sourceOffset
+	/// into \p destination starting at \p destinationOffset.
+	/// The copy is asynchronous (clEnqueueCopyBuffer on the queue of \p destination)
+	/// and ordered by the events of both blocks, which have to share the context.
+	void copy(MemBlock &source, unsigned int sourceOffset,
+	          MemBlock &destination, unsigned int destinationOffset,
+	          unsigned int n);
+
 	/// Copies source to destination, resizes destination to accommodate source.
 	/// \ingroup HostInteractionFunctions
 	template <typename T> void copy(Element source, std::vector<T> &destination);	
@@ -70,4 +70,27 @@ namespace acl
 		return typeID;
 	}
 
+
+	void ElementBase::addToWrittenArguments(vector<shared_ptr<ElementBase> > & writtenArguments) const
+	{
+	}
+
+
+	void ElementBase::addToReadArguments(vector<shared_ptr<ElementBase> > & readArguments) const
+	{
+		addToKernelSource(readArguments, readArguments);
+	}
+
+
+	string ElementBase::strStore(const string & value, const KernelConfiguration & kernelConfig) const
+	{
+		return "";
+	}
+
+
+	unsigned int ElementBase::getArgumentVersion() const
+	{
+		return 0;
+	}
+
 } // namespace acl
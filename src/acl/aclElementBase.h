@@ -63,11 +63,24 @@ namespace acl
 			TypeID getTypeID() const;
 			virtual string getTypeSignature(const KernelConfiguration & kernelConfig = KERNEL_BASIC) const = 0;
 			virtual string getLocalDeclaration(const KernelConfiguration & kernelConfig = KERNEL_BASIC) const = 0;
+			/// Returns code storing \p value into the element if the store needs a conversion 
+			/// (reduced precision storage, see ArrayHalf), an empty string otherwise
+			virtual string strStore(const string & value, 
+			                        const KernelConfiguration & kernelConfig = KERNEL_BASIC) const;
 			/// Adds ElementBase to the kernel source either as an argument or as a local declaration
 			virtual void addToKernelSource(vector<shared_ptr<ElementBase> > & arguments,
 			                               vector<shared_ptr<ElementBase> > & localDeclarations) const = 0;
+			/// Adds arguments modified by the ElementBase (e.g. assignment targets) to \p writtenArguments
+			/// used by the Kernel for tracking of dependencies between launches
+			virtual void addToWrittenArguments(vector<shared_ptr<ElementBase> > & writtenArguments) const;
+			/// Adds arguments read by the ElementBase used as a statement to \p readArguments;
+			/// the targets of the plain assignments are not read
+			virtual void addToReadArguments(vector<shared_ptr<ElementBase> > & readArguments) const;
 
 			virtual void setAsArgument(cl::Kernel & kernel, unsigned int argumentIndex) const = 0;
+			/// Returns version of the value set by setAsArgument(), the version changes
+			/// whenever the value changes; used by the Kernel for skipping of unchanged arguments
+			virtual unsigned int getArgumentVersion() const;
 			virtual ~ElementBase();
 	};
 
@@ -26,6 +26,7 @@
 #include "acl.h"
 #include "DataTypes/aclConstant.h"
 #include "DataTypes/aclArray.h"
+#include "DataTypes/aclArrayHalf.h"
 #include "DataTypes/aclSubvector.h"
 #include "DataTypes/aclVariableReference.h"
 #include "DataTypes/aclVariableSP.h"
@@ -184,6 +185,24 @@ namespace acl
 			v[i] = generateElementArray(typeID, length, queue);
 		return v;
 	}
+
+
+	VectorOfElementsData generateVEDataHalf(unsigned int length,
+	                                        unsigned int nComponents,
+	                                        CommandQueue queue)
+	{
+		VectorOfElementsData v(nComponents);
+		for (unsigned int i(0); i < nComponents; ++i)
+			v[i] = ElementData(new ArrayHalf(length, queue));
+		return v;
+	}
+
+
+	VectorOfElementsData generateVEDataHalf(unsigned int length,
+	                                        unsigned int nComponents)
+	{
+		return generateVEDataHalf(length, nComponents, hardware.defaultQueue);
+	}
 	
 
 	VectorOfElements generateVELocalArray(unsigned int componentSize,
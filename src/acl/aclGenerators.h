@@ -69,6 +69,18 @@ namespace acl
     	                                TypeID typeID,
 		                                unsigned int nComponents = 1);
 
+	/// Generates VectorOfElementsData with \p nComponents Elements acl::ArrayHalf with size \p length \ingroup generateVE
+	/**
+		 The values are stored in half precision and computed in the precision of the kernel
+	*/
+	VectorOfElementsData generateVEDataHalf(unsigned int length,
+	                                        unsigned int nComponents,
+	                                        CommandQueue queue);
+
+	/// Generates VectorOfElementsData with \p nComponents Elements acl::ArrayHalf with size \p length and default queue \ingroup generateVE
+	VectorOfElementsData generateVEDataHalf(unsigned int length,
+	                                        unsigned int nComponents = 1);
+
 	
 	/// Generates VectorOfElements with \p size Elements acl::LocalArray of type \p typeID with size \p componentSize \ingroup generateVE
 	VectorOfElements generateVELocalArray(unsigned int componentSize,
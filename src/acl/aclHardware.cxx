@@ -23,8 +23,10 @@
 
 #include "aclHardware.h"
 #include "../aslUtilities.h"
+#include "aclUtilities.h"
 #include "Kernels/aclKernel.h"
 #include <fstream>
+#include <algorithm>
 
 
 using namespace std;
@@ -75,12 +77,16 @@ namespace acl
 				cps[1] = (cl_context_properties)(platforms[i])();
 				cps[2] = 0;
 
+				if (devices.size() == 0)
+					continue;
+
+				// Create one OpenCL context for all devices of the platform,
+				// so buffers and events can be shared between their queues
+				context = cl::Context(devices, cps, NULL, NULL, &status);
+				errorMessage(status, "acl::Context::Context()");
+
 				for (unsigned int j = 0; j < devices.size(); ++j)
 				{
-					// Create an OpenCL context for the current device
-					context = cl::Context(vector<cl::Device>(1, devices[j]), cps, NULL, NULL, &status);
-					errorMessage(status, "acl::Context::Context()");
-
 					// Create an OpenCL command queue for current context and device
 					queues.push_back(CommandQueue(new cl::CommandQueue(context, devices[j], 0, &status)));
 					errorMessage(status, "acl::CommandQueue::CommandQueue()");
@@ -128,6 +134,102 @@ namespace acl
 	}
 
 
+	CommandQueue Hardware::createQueue(const CommandQueue & queue)
+	{
+		cl_int status = 0;
+		cl_command_queue_properties properties(queue->getInfo<CL_QUEUE_PROPERTIES>());
+		CommandQueue q(new cl::CommandQueue(getContext(queue), getDevice(queue), properties, &status));
+		errorMessage(status, "acl::CommandQueue::CommandQueue()");
+		queues.push_back(q);
+		return q;
+	}
+
+
+	vector<CommandQueue> Hardware::getQueuesInContext(const CommandQueue & queue)
+	{
+		vector<CommandQueue> v;
+		for (unsigned int i(0); i < queues.size(); ++i)
+			if (inSameContext(queue, queues[i]))
+				v.push_back(queues[i]);
+		return v;
+	}
+
+
+	vector<CommandQueue> Hardware::createSubDevices(const CommandQueue & queue)
+	{
+		vector<CommandQueue> subQueues;
+		cl::Device device(getDevice(queue));
+
+		vector<cl_device_partition_property> partitions(device.getInfo<CL_DEVICE_PARTITION_PROPERTIES>());
+		bool byAffinity(find(partitions.begin(),
+		                     partitions.end(),
+		                     CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN) != partitions.end());
+		if (!byAffinity || !(device.getInfo<CL_DEVICE_PARTITION_AFFINITY_DOMAIN>() & CL_DEVICE_AFFINITY_DOMAIN_NUMA))
+		{
+			warningMessage("Hardware::createSubDevices() - " + getDeviceName(queue) +
+			               " does not support partitioning by NUMA nodes, the device is used as a whole");
+			subQueues.push_back(queue);
+			return subQueues;
+		}
+
+		cl_int status = 0;
+		vector<cl::Device> subDevices;
+		cl_device_partition_property partition[3] = {CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN,
+		                                             CL_DEVICE_AFFINITY_DOMAIN_NUMA,
+		                                             0};
+		status = device.createSubDevices(partition, &subDevices);
+		errorMessage(status, "acl::Device::createSubDevices()");
+
+		if (subDevices.size() < 2)
+		{
+			subQueues.push_back(queue);
+			return subQueues;
+		}
+
+		cl_context_properties cps[3];
+		cps[0] = CL_CONTEXT_PLATFORM;
+		cps[1] = (cl_context_properties)device.getInfo<CL_DEVICE_PLATFORM>();
+		cps[2] = 0;
+		cl::Context context(subDevices, cps, NULL, NULL, &status);
+		errorMessage(status, "acl::Context::Context()");
+
+		cl_command_queue_properties properties(queue->getInfo<CL_QUEUE_PROPERTIES>());
+		for (unsigned int i(0); i < subDevices.size(); ++i)
+		{
+			subQueues.push_back(CommandQueue(new cl::CommandQueue(context, subDevices[i], properties, &status)));
+			errorMessage(status, "acl::CommandQueue::CommandQueue()");
+			queues.push_back(subQueues.back());
+
+			devicesInfo += "\t" + subDevices[i].getInfo<CL_DEVICE_NAME>() +
+			               " (NUMA node " + numToStr(i) + ")\n";
+		}
+
+		return subQueues;
+	}
+
+
+	void Hardware::enableProfiling()
+	{
+		cl_int status = 0;
+		for (unsigned int i(0); i < queues.size(); ++i)
+		{
+			cl::Context context(getContext(queues[i]));
+			cl::Device device(getDevice(queues[i]));
+
+			// the other properties of the queue (e.g. out-of-order execution) are kept
+			cl_command_queue_properties properties(queues[i]->getInfo<CL_QUEUE_PROPERTIES>(&status));
+			errorMessage(status, "acl::CommandQueue::getInfo()");
+
+			status = queues[i]->finish();
+			errorMessage(status, "acl::CommandQueue::finish()");
+			*queues[i] = cl::CommandQueue(context, device, 
+			                              properties | CL_QUEUE_PROFILING_ENABLE, 
+			                              &status);
+			errorMessage(status, "acl::CommandQueue::CommandQueue()");
+		}
+	}
+
+
 	string Hardware::getDevicesInfo()
 	{
 		return devicesInfo;
@@ -195,6 +297,12 @@ namespace acl
 	}
 
 
+	size_t getMaxWorkGroupSize(const CommandQueue & queue)
+	{
+		return getDevice(queue).getInfo<CL_DEVICE_MAX_WORK_GROUP_SIZE>();
+	}
+
+
 	cl_uint getVectorWidth(const CommandQueue & queue, const TypeID typeID)
 	{
 		cl_uint width;
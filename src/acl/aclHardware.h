@@ -92,6 +92,12 @@ namespace acl
 	size_t getMaxItemSize(const CommandQueue & queue);
 
 
+	/// Returns the maximum number of work-items in a work-group
+	/// (CL_DEVICE_MAX_WORK_GROUP_SIZE).
+	/// \ingroup HardwareInformation
+	size_t getMaxWorkGroupSize(const CommandQueue & queue);
+
+
 	/// Returns the native ISA vector width. The vector width is defined as the
 	/// number of scalar elements that can be stored in the vector.
 	/// If the cl_khr_fp64 extension is not supported,
@@ -150,10 +156,26 @@ namespace acl
 			/// Warns if requested combination is not found.
 			void setDefaultQueue(const std::string & platform = "",
 			                     const std::string & device = "");
+			/// Queues of all devices, devices of one platform share the context
 			std::vector<CommandQueue> queues;
 			CommandQueue defaultQueue;
+			/// Creates an additional queue on the device of \p queue and appends it to \p queues.
+			/// Independent NumMethods can be launched on different queues, 
+			/// see SingleKernelNM::setQueue() and Kernel::setQueue()
+			CommandQueue createQueue(const CommandQueue & queue);
+			/// Returns all queues sharing the context with \p queue
+			std::vector<CommandQueue> getQueuesInContext(const CommandQueue & queue);
+			/// Partitions the device of \p queue into sub-devices, one per NUMA node
+			/// (CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN), and returns their queues.
+			/// The sub-devices share a new context, the queues are appended to \p queues.
+			/// Returns \p queue itself if the device has a single NUMA node
+			/// or does not support the partitioning, see asl::SlabDecomposition.
+			std::vector<CommandQueue> createSubDevices(const CommandQueue & queue);
 			std::string getDevicesInfo();
 			std::string getDefaultDeviceInfo();
+			/// Recreates all queues with CL_QUEUE_PROFILING_ENABLE, see KernelProfiler.
+			/// The queue objects are kept, so all holders of the queues are affected.
+			void enableProfiling();
 		private:
 			std::string devicesInfo;
 	};
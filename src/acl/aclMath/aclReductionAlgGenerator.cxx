@@ -54,139 +54,114 @@ namespace acl
 	{
 		return length % getLPerUnit(length,nUnits);
 	}
+
+	/// number of units with non-empty parts of the elements
+	unsigned int getNActiveUnits(unsigned int length, unsigned int nUnits)
+	{
+		return std::min(getNSaturatedUnits(length, nUnits) + 
+		                (getLLastUnit(length, nUnits) > 0 ? 1 : 0), 
+		                nUnits);
+	}
 	
-	template <typename ResType, enum ReductionOperatorType Op> class GroupReduction
+	VectorOfElements reductionOperation(VectorOfElements res, 
+	                                    VectorOfElements v, 
+	                                    acl::TypeID t, 
+	                                    ReductionOperatorType op)
 	{
-	};
+		switch (op)
+		{
+			case ROT_SUM: return res+=v;
+			case ROT_PRODUCT: return res*=v;
+			case ROT_MINIMUM: return res=min(res,v,t);
+			case ROT_MAXIMUM: return res=max(res,v,t);
+		}
+		return res;
+	}
 
-	template <typename ResType> class GroupReduction<ResType, ROT_SUM>
+	/// components of \p groupResACL corresponding to operation \p i 
+	inline VectorOfElementsData operationComponents(const VectorOfElementsData & groupResACL,
+	                                                unsigned int i,
+	                                                unsigned int nC)
 	{
-		public:
-			static void compute(std::vector<std::vector<ResType>> v, unsigned int l, asl::AVec<ResType> & res)
-		    {
-				for(unsigned int i(0); i<v.size(); ++i)
-				{
-					vector<ResType> & vv(v[i]);
-					ResType r(vv[0]);
-					for(unsigned int j(1); j<l; ++j)
-						r+=vv[j];
-					res[i]=r;
-				}				
-			}
-			static inline VectorOfElements op(VectorOfElements res, VectorOfElements v, acl::TypeID t)
-			{
-				return res+=v;
-			}
-	};
-//	template void GroupReduction<double, ROT_SUM>::compute(std::vector<std::vector<double>> v, 
-//	                                                      asl::AVec<double> & res); 
-//	template void GroupReduction<float, ROT_SUM>::compute(std::vector<std::vector<float>> v, 
-//	                                                     asl::AVec<float> & res); 
+		return subVE(groupResACL, i*nC, (i+1)*nC-1);
+	}
 	
-	template <typename ResType> class GroupReduction<ResType, ROT_PRODUCT>
+
+	template <typename ResType> 
+		void MultiReductionAlgGenerator<ResType>::compute()
 	{
-		public:
-			static void compute(std::vector<std::vector<ResType>> v, unsigned int l, asl::AVec<ResType> & res)
-		    {
-				for(unsigned int i(0); i<v.size(); ++i)
-				{
-					vector<ResType> & vv(v[i]);
-					ResType r(vv[0]);
-					for(unsigned int j(1); j<l; ++j)
-						r*=vv[j];
-					res[i]=r;
-				}				
-			}
-			static inline VectorOfElements op(VectorOfElements res, VectorOfElements v, acl::TypeID t)
-			{
-				return res*=v;
-			}
-	};
-//	template void GroupReduction<double, ROT_PRODUCT>::compute(std::vector<std::vector<double>> v, 
-//	                                                          asl::AVec<double> & res); 
-//	template void GroupReduction<float, ROT_PRODUCT>::compute(std::vector<std::vector<float>> v, 
-//	                                                         asl::AVec<float> & res); 
+		computeAsync();
+		requestResult();
+		getResult();
+	};	
+	template void MultiReductionAlgGenerator<double>::compute();
+	template void MultiReductionAlgGenerator<float>::compute();
+
 	
-	template <typename ResType> class GroupReduction<ResType, ROT_MINIMUM>
+	template <typename ResType> 
+		cl::Event MultiReductionAlgGenerator<ResType>::computeAsync()
 	{
-		public:
-			static void compute(std::vector<std::vector<ResType>> v, unsigned int l, asl::AVec<ResType> & res)
-		    {
-				for(unsigned int i(0); i<v.size(); ++i)
-				{
-					vector<ResType> & vv(v[i]);
-					ResType r(vv[0]);
-					for(unsigned int j(1); j<l; ++j)
-						r=std::min(r,vv[j]);
-					res[i]=r;
-				}				
-			}
-			static inline VectorOfElements op(VectorOfElements res, VectorOfElements v, acl::TypeID t)
-			{
-				return res=min(res,v,t);
-			}
-	};
-//	template void GroupReduction<double, ROT_MINIMUM>::compute(std::vector<std::vector<double>> v, 
-//	                                                          asl::AVec<double> & res); 
-//	template void GroupReduction<float, ROT_MINIMUM>::compute(std::vector<std::vector<float>> v, 
-//	                                                         asl::AVec<float> & res); 
-
-	template <typename ResType> class GroupReduction<ResType, ROT_MAXIMUM>
+		// the kernels are ordered by the events of groupResACL
+		if(kernel) 
+			kernel->computeAsync();
+		return finishKernel->computeAsync();
+	};	
+	template cl::Event MultiReductionAlgGenerator<double>::computeAsync();
+	template cl::Event MultiReductionAlgGenerator<float>::computeAsync();
+
+	
+	template <typename ResType> 
+		void MultiReductionAlgGenerator<ResType>::requestResult()
 	{
-		public:
-			static void compute(std::vector<std::vector<ResType>> v, unsigned int l, asl::AVec<ResType> & res)
-		    {
-				for(unsigned int i(0); i<v.size(); ++i)
-				{
-					vector<ResType> & vv(v[i]);
-					ResType r(vv[0]);
-					for(unsigned int j(1); j<l; ++j)
-						r=std::max(r,vv[j]);
-					res[i]=r;
-				}				
-			}
-			static inline VectorOfElements op(VectorOfElements res, VectorOfElements v, acl::TypeID t)
-			{
-				return res=max(res,v,t);
-			}			
-	};
-//	template void GroupReduction<double, ROT_MAXIMUM>::compute(std::vector<std::vector<double>> v, 
-//	                                                          asl::AVec<double> & res); 
-//	template void GroupReduction<float, ROT_MAXIMUM>::compute(std::vector<std::vector<float>> v, 
-//	                                                         asl::AVec<float> & res); 
-
-	template <typename ResType, enum ReductionOperatorType Op> 
-		void ReductionAlgGenerator<ResType, Op>::compute()
+		// resHost can not be overwritten by a pending readback
+		if (!readEvents.empty())
+		{
+			cl_int status(cl::WaitForEvents(readEvents));
+			errorMessage(status, "MultiReductionAlgGenerator::requestResult() - WaitForEvents()");
+			readEvents.clear();
+		}
+		for (unsigned int i(0); i < resACL.size(); ++i)
+			readEvents.push_back(copyAsync(*resACL[i], &resHost[i]));
+	};	
+	template void MultiReductionAlgGenerator<double>::requestResult();
+	template void MultiReductionAlgGenerator<float>::requestResult();
+
+	
+	template <typename ResType> 
+		const asl::AVec<ResType> & MultiReductionAlgGenerator<ResType>::getResult()
 	{
-		if(kernel) 
-			kernel->compute();
-		unsigned int nC(ve.size());
-		unsigned int veLength(ve[0]->getSize());
-		unsigned int nSaturatedUnits(getNSaturatedUnits(veLength, nGroups*nLocal));
-		unsigned int l(std::min(nSaturatedUnits+1,nGroups*nLocal));
-		for (unsigned int i(0); i < nC; ++i)
-			acl::copy(groupResACL[i], groupRes[i]);
-		GroupReduction<ResType, Op>::compute(groupRes, l, res.v());
+		if (readEvents.empty())
+			requestResult();
+		cl_int status(cl::WaitForEvents(readEvents));
+		errorMessage(status, "MultiReductionAlgGenerator::getResult() - WaitForEvents()");
+		readEvents.clear();
+
+		asl::AVec<ResType> r(resHost.size());
+		for (unsigned int i(0); i < resHost.size(); ++i)
+			r[i] = resHost[i];
+		res = r;
+		return res.v();
 	};	
-	template void ReductionAlgGenerator<double, ROT_SUM>::compute();
-	template void ReductionAlgGenerator<float, ROT_SUM>::compute();
-	template void ReductionAlgGenerator<double, ROT_PRODUCT>::compute();
-	template void ReductionAlgGenerator<float, ROT_PRODUCT>::compute();
-	template void ReductionAlgGenerator<double, ROT_MINIMUM>::compute();
-	template void ReductionAlgGenerator<float, ROT_MINIMUM>::compute();
-	template void ReductionAlgGenerator<double, ROT_MAXIMUM>::compute();
-	template void ReductionAlgGenerator<float, ROT_MAXIMUM>::compute();
+	template const asl::AVec<double> & MultiReductionAlgGenerator<double>::getResult();
+	template const asl::AVec<float> & MultiReductionAlgGenerator<float>::getResult();
+
 	
-	template <typename ResType, enum ReductionOperatorType Op> 
-		void generateKernelCPU(VectorOfElements ve, VectorOfElements groupResACL, Kernel & k)
+	void generateKernelCPU(VectorOfElements ve, 
+	                       const std::vector<ReductionOperatorType> & ops,
+	                       VectorOfElementsData groupResACL,
+	                       Kernel & k)
 	{		
 		auto nGroups(k.getGroupsNumber());
 		int veLength(ve[0]->getSize());
 		unsigned int nLocal(nLocalCPU(veLength,nGroups));	
 		unsigned int gSize(std::max(k.getSize(),nLocal));
+		unsigned int nC(ve.size());
 		auto type(getElementType(ve));
 		auto typeI(TYPE_SELECT[type]);
-		auto lVal(acl::generateVEPrivateVariable(ve.size(),type));
+		auto val(acl::generateVEPrivateVariable(nC,type));
+		std::vector<VectorOfElements> lVal(ops.size());
+		for (unsigned int i(0); i < ops.size(); ++i)
+			lVal[i] = acl::generateVEPrivateVariable(nC,type);
 		auto counter(acl::generateVEPrivateVariable(1,typeI));
 		auto counterEnd(acl::generateVEPrivateVariable(1,typeI));
 		int lPerGroup(getLPerUnit(veLength,nGroups));
@@ -197,33 +172,43 @@ namespace acl
 		                        generateVEConstant(lLastGroup), 
 		                        generateVEGroupID()==nSaturatedGroups, 
 		                        type));
-		k<<(lVal = select(excerpt(ve,lPerGroup*generateVEGroupID()), counterEnd>0,type));
+		k<<(val = select(excerpt(ve,lPerGroup*generateVEGroupID()), counterEnd>0,type));
+		for (unsigned int i(0); i < ops.size(); ++i)
+			k<<(lVal[i] = val);
 		// this line ensuers that the conputations will take place on the 1st item only
 		k<<(counterEnd = select(counterEnd, generateVEIndex(gSize)==0, type));
 		vector<Element> body;
-		body<<(GroupReduction<ResType, Op>::
-			               op(lVal,excerpt(ve, 
-			                               int(lPerGroup)*generateVEGroupID() + 
-			                               counter),type));
+		// the elements are computed once for all operations
+		body<<(val = excerpt(ve, int(lPerGroup)*generateVEGroupID() + counter));
+		for (unsigned int i(0); i < ops.size(); ++i)
+			body<<(reductionOperation(lVal[i], val, type, ops[i]));
 
 		auto loop(elementOperators::forLoop((counter = generateVEConstant(1))[0],
 		                                    (counter < counterEnd)[0],
 		                                    (counter += generateVEConstant(1))[0],
 		                                    body));
 		k.addExpression(loop);
-		k<<(excerpt(groupResACL,generateVEGroupID()) = lVal);
+		for (unsigned int i(0); i < ops.size(); ++i)
+			k<<(excerpt(operationComponents(groupResACL, i, nC),generateVEGroupID()) = lVal[i]);
 	}
 
-	template <typename ResType, enum ReductionOperatorType Op> 
-		void generateKernelGPU(VectorOfElements ve, VectorOfElements groupResACL, Kernel & k)
+	
+	void generateKernelGPU(VectorOfElements ve, 
+	                       const std::vector<ReductionOperatorType> & ops,
+	                       VectorOfElementsData groupResACL,
+	                       Kernel & k)
 	{		
 		auto nGroups(k.getGroupsNumber());
 		int veLength(ve[0]->getSize());
 		unsigned int nLocal(nLocalGPU(veLength,nGroups));
 		unsigned int gSize(std::max(k.getSize(),nLocal));
+		unsigned int nC(ve.size());
 		auto type(getElementType(ve));
 		auto typeI(TYPE_SELECT[type]);
-		auto lVal(acl::generateVEPrivateVariable(ve.size(),type));
+		auto val(acl::generateVEPrivateVariable(nC,type));
+		std::vector<VectorOfElements> lVal(ops.size());
+		for (unsigned int i(0); i < ops.size(); ++i)
+			lVal[i] = acl::generateVEPrivateVariable(nC,type);
 		auto counter(acl::generateVEPrivateVariable(1,typeI));
 		auto counterEnd(acl::generateVEPrivateVariable(1,typeI));
 		auto nUnits(nGroups*nLocal);
@@ -244,60 +229,131 @@ namespace acl
 			
 		// this line ensuers that the conputations will take place on first item only
 		k<<(counterEnd = select(counterEnd, generateVEIndex(gSize)<nLocal, type));
-		k<<(lVal = select(excerpt(ve,lPerUnit*unitID), counterEnd>0,type));
+		k<<(val = select(excerpt(ve,lPerUnit*unitID), counterEnd>0,type));
+		for (unsigned int i(0); i < ops.size(); ++i)
+			k<<(lVal[i] = val);
 		vector<Element> body;
-		body<<(GroupReduction<ResType, Op>::
-			               op(lVal,excerpt(ve, lPerUnit*unitID + counter),type));
+		// the elements are computed once for all operations
+		body<<(val = excerpt(ve, lPerUnit*unitID + counter));
+		for (unsigned int i(0); i < ops.size(); ++i)
+			body<<(reductionOperation(lVal[i], val, type, ops[i]));
 
 		auto loop(elementOperators::forLoop((counter = generateVEConstant(1))[0],
 		                                    (counter < counterEnd)[0],
 		                                    (counter += generateVEConstant(1))[0],
 		                                    body));
 		k.addExpression(loop);
-		k<<(excerpt(groupResACL,unitID) = lVal);
+		for (unsigned int i(0); i < ops.size(); ++i)
+			k<<(excerpt(operationComponents(groupResACL, i, nC),unitID) = lVal[i]);
+	}
+
+
+	template <typename ResType> 
+		void MultiReductionAlgGenerator<ResType>::generateFinishKernel(unsigned int nPartial)
+	{
+		KernelConfiguration kConf(KERNEL_BASIC);
+		kConf.local = true;
+		finishKernel = std::make_shared<Kernel>(kConf);
+		finishKernel->setGroupsNumber(1);
+
+		unsigned int nC(ve.size());
+		unsigned int nRes(nC*operations.size());
+		auto type(getElementType(ve));
+		auto typeI(TYPE_SELECT[type]);
+		CommandQueue queue(ve[0]->getQueue());
+
+		// the number of work-items is a power of two not exceeding nPartial,
+		// the group size limits and a half of the local memory
+		size_t maxItems(std::min(getMaxWorkGroupSize(queue), getMaxItemSize(queue)));
+		maxItems = std::min<size_t>(maxItems, 
+		                            getLocalMemorySize(queue) / 2 / (nRes * TYPE_SIZE[type]));
+		unsigned int nItems(1);
+		while (2 * nItems <= std::min<size_t>(nPartial, std::min<size_t>(maxItems, 256)))
+			nItems *= 2;
+
+		auto index(generateVEIndex(nItems));
+		auto r(acl::generateVEPrivateVariable(nRes,type));
+		auto counter(acl::generateVEPrivateVariable(1,typeI));
+		auto partial(generateVELocalArray(nItems, type, nRes));
+
+		// each work-item reduces the partial results index, index + nItems, ...
+		*finishKernel<<(r = excerpt(groupResACL, index));
+		vector<Element> body;
+		for (unsigned int i(0); i < operations.size(); ++i)
+			body<<(reductionOperation(subVE(r, i*nC, (i+1)*nC-1),
+			                          excerpt(operationComponents(groupResACL, i, nC), counter),
+			                          type,
+			                          operations[i]));
+		auto loop(elementOperators::forLoop((counter = index + nItems)[0],
+		                                    (counter < generateVEConstant(nPartial))[0],
+		                                    (counter += generateVEConstant(nItems))[0],
+		                                    body));
+		finishKernel->addExpression(loop);
+		*finishKernel<<(partial = r);
+		finishKernel->addExpression(elementOperators::barrier());
+
+		// tree reduction of the work-item results in the local memory
+		for (unsigned int s(nItems / 2); s > 0; s /= 2)
+		{
+			vector<Element> step;
+			for (unsigned int i(0); i < operations.size(); ++i)
+				step<<(reductionOperation(subVE(partial, i*nC, (i+1)*nC-1),
+				                          excerpt(subVE(partial, i*nC, (i+1)*nC-1), index + s),
+				                          type,
+				                          operations[i]));
+			finishKernel->addExpression(elementOperators::ifElse((index < s)[0], 
+			                                                     step, 
+			                                                     vector<Element>()));
+			finishKernel->addExpression(elementOperators::barrier());
+		}
+
+		vector<Element> store;
+		store<<(resACL = excerpt(partial, generateVEConstant(0)));
+		finishKernel->addExpression(elementOperators::ifElse((index == 0)[0], 
+		                                                     store, 
+		                                                     vector<Element>()));
+		finishKernel->setup();
 	}
+
 	
-	template <typename ResType, enum ReductionOperatorType Op> 
-		void ReductionAlgGenerator<ResType, Op>::generateAlg(Kernel & k)
+	template <typename ResType> 
+		void MultiReductionAlgGenerator<ResType>::generateAlg(Kernel & k)
 	{
 		if(!k.getConfiguration().local)
 			asl::errorMessage("ReductionAlgGenerator::generateAlg: The kernel should be local");
 
 		nGroups= k.getGroupsNumber();
 		unsigned int veLength(ve[0]->getSize());
-		nLocal=(getDeviceType(ve[0]->getQueue())== CL_DEVICE_TYPE_CPU ? 
+		CommandQueue queue(ve[0]->getQueue());
+		nLocal=(getDeviceType(queue)== CL_DEVICE_TYPE_CPU ? 
 		        nLocalCPU(veLength,nGroups) : nLocalGPU(veLength,nGroups));
-		for(unsigned int i(0); i<ve.size(); ++i)
-			groupRes[i]=std::vector<ResType>(nGroups*nLocal);
-		copy(generateVEData<ResType>(nGroups*nLocal,ve.size()),groupResACL);
+		unsigned int nRes(ve.size()*operations.size());
+		copy(generateVEData<ResType>(nGroups*nLocal,nRes,queue),groupResACL);
+		copy(generateVEData<ResType>(1u,nRes,queue),resACL);
+		resHost.resize(nRes);
 
-		
-		switch (getDeviceType(ve[0]->getQueue()))
+		switch (getDeviceType(queue))
 		{
 			case CL_DEVICE_TYPE_CPU:  
-				generateKernelCPU<ResType, Op>(ve,groupResACL,k);
+				generateKernelCPU(ve,operations,groupResACL,k);
 				k.setup();
 			break;
 			case CL_DEVICE_TYPE_GPU:  
-				generateKernelGPU<ResType, Op>(ve,groupResACL,k);
+				generateKernelGPU(ve,operations,groupResACL,k);
 				k.setup();
 			break;
 			default: errorMessage("ReductionAlgGenerator: device type " + 
 			                      numToStr(getDeviceType(k.getQueue())) + " is unknown!");
 		}
+
+		generateFinishKernel(getNActiveUnits(veLength, nGroups*nLocal));
 	}
 
-	template void ReductionAlgGenerator<double, ROT_SUM>::generateAlg(Kernel & k);
-	template void ReductionAlgGenerator<float, ROT_SUM>::generateAlg(Kernel & k);
-	template void ReductionAlgGenerator<double, ROT_PRODUCT>::generateAlg(Kernel & k);
-	template void ReductionAlgGenerator<float, ROT_PRODUCT>::generateAlg(Kernel & k);
-	template void ReductionAlgGenerator<double, ROT_MINIMUM>::generateAlg(Kernel & k);
-	template void ReductionAlgGenerator<float, ROT_MINIMUM>::generateAlg(Kernel & k);
-	template void ReductionAlgGenerator<double, ROT_MAXIMUM>::generateAlg(Kernel & k);
-	template void ReductionAlgGenerator<float, ROT_MAXIMUM>::generateAlg(Kernel & k);
-
-	template <typename ResType, enum ReductionOperatorType Op> 
-		void ReductionAlgGenerator<ResType, Op>::generateAlg()
+	template void MultiReductionAlgGenerator<double>::generateAlg(Kernel & k);
+	template void MultiReductionAlgGenerator<float>::generateAlg(Kernel & k);
+
+	template <typename ResType> 
+		void MultiReductionAlgGenerator<ResType>::generateAlg()
 	{
 		KernelConfiguration kConf(KERNEL_BASIC);
 		kConf.local = true;
@@ -308,22 +364,23 @@ namespace acl
 		
 		generateAlg(*kernel);
 	};	
-	template void ReductionAlgGenerator<double, ROT_SUM>::generateAlg();
-	template void ReductionAlgGenerator<float, ROT_SUM>::generateAlg();
-	template void ReductionAlgGenerator<double, ROT_PRODUCT>::generateAlg();
-	template void ReductionAlgGenerator<float, ROT_PRODUCT>::generateAlg();
-	template void ReductionAlgGenerator<double, ROT_MINIMUM>::generateAlg();
-	template void ReductionAlgGenerator<float, ROT_MINIMUM>::generateAlg();
-	template void ReductionAlgGenerator<double, ROT_MAXIMUM>::generateAlg();
-	template void ReductionAlgGenerator<float, ROT_MAXIMUM>::generateAlg();
-
-	template <typename ResType, enum ReductionOperatorType Op> 
-		ReductionAlgGenerator<ResType, Op>::ReductionAlgGenerator(VectorOfElements v):
+	template void MultiReductionAlgGenerator<double>::generateAlg();
+	template void MultiReductionAlgGenerator<float>::generateAlg();
+
+	template <typename ResType> 
+		MultiReductionAlgGenerator<ResType>::MultiReductionAlgGenerator(VectorOfElements v,
+		                                                                const std::vector<ReductionOperatorType> & ops):
 			ve(v),		 
-			res(asl::AVec<ResType>(ve.size())),
-			groupRes(ve.size())
+			operations(ops),
+			nGroups(0),
+			nLocal(0),
+			res(asl::AVec<ResType>(ve.size()*ops.size()))
 	{
 	}
+	template MultiReductionAlgGenerator<double>::MultiReductionAlgGenerator(VectorOfElements v,
+	                                                                        const std::vector<ReductionOperatorType> & ops);
+	template MultiReductionAlgGenerator<float>::MultiReductionAlgGenerator(VectorOfElements v,
+	                                                                       const std::vector<ReductionOperatorType> & ops);
 	
 	template <typename ResType> std::shared_ptr<ReductionAlgGenerator<ResType, ROT_SUM>> 
 		generateSumAlg(VectorOfElements v)
@@ -368,5 +425,20 @@ namespace acl
 		generateProductAlg<double>(VectorOfElements v);
 	template std::shared_ptr<ReductionAlgGenerator<float, ROT_PRODUCT>> 
 		generateProductAlg<float>(VectorOfElements v);
+
+	template <typename ResType> std::shared_ptr<MultiReductionAlgGenerator<ResType>> 
+		generateSumMinMaxAlg(VectorOfElements v)
+	{
+		std::vector<ReductionOperatorType> ops;
+		ops.push_back(ROT_SUM);
+		ops.push_back(ROT_MINIMUM);
+		ops.push_back(ROT_MAXIMUM);
+		return make_shared<MultiReductionAlgGenerator<ResType>>(v, ops);
+	}
+
+	template std::shared_ptr<MultiReductionAlgGenerator<double>> 
+		generateSumMinMaxAlg<double>(VectorOfElements v);
+	template std::shared_ptr<MultiReductionAlgGenerator<float>> 
+		generateSumMinMaxAlg<float>(VectorOfElements v);
 		
 } // namespace acl
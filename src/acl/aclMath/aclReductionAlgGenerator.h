@@ -27,6 +27,7 @@
 #include "aclVectorOfElementsDef.h"
 #include <math/aslVectors.h>
 #include <utilities/aslUValue.h>
+#include <acl/cl.hpp>
 
 
 namespace acl
@@ -34,31 +35,75 @@ namespace acl
 	class Kernel;
 	enum ReductionOperatorType {ROT_SUM, ROT_PRODUCT, ROT_MINIMUM, ROT_MAXIMUM};
 		
-	/// The class generates code corresponding to a reduction operation of elements 
+	/// The class generates code corresponding to several reduction operations of elements 
 	/**
 		 \ingroup ComplexDataTypes
+		 All operations are computed in one pass over the elements. The 
+		 reduction is finished on the device: the first kernel reduces parts
+		 of the elements into partial results, the second one reduces them into
+		 getResultACL(). The result can be used as an argument of other kernels
+		 without a host round-trip; it is read into \p res by compute() or 
+		 asynchronously by requestResult() and getResult().
+		 The components of the result are ordered by operations: the components 
+		 of \p ve reduced with the first operation, with the second one, etc.
 	 */
-	template <typename ResType, enum ReductionOperatorType Op> class ReductionAlgGenerator
+	template <typename ResType> class MultiReductionAlgGenerator
 	{
 		private:
 			VectorOfElements ve;
+			std::vector<ReductionOperatorType> operations;
 			unsigned int nGroups;
 			unsigned int nLocal;
 		public:
 		    asl::UValue<asl::AVec<ResType>> res;
 		private:
-			std::vector<std::vector<ResType>> groupRes;
+			/// partial results of the first kernel
 			VectorOfElementsData groupResACL;
+			/// final results, one element each
+			VectorOfElementsData resACL;
+			/// destination of the asynchronous readback
+			std::vector<ResType> resHost;
+			std::vector<cl::Event> readEvents;
 
 			shared_ptr<Kernel> kernel;
-			
+			shared_ptr<Kernel> finishKernel;
+
+			/// generates the kernel reducing \p nPartial partial results
+			void generateFinishKernel(unsigned int nPartial);
 		public:	
-			ReductionAlgGenerator(VectorOfElements v);
-			void compute();	
+			MultiReductionAlgGenerator(VectorOfElements v,
+			                           const std::vector<ReductionOperatorType> & ops);
+			/// Launches the reduction and reads the result into \p res
+			void compute();
+			/// Launches the reduction without reading the result back.
+			/// If the first kernel is supplied by generateAlg(Kernel & k) 
+			/// it has to be launched by the caller.
+			cl::Event computeAsync();
+			/// Starts the asynchronous readback of the result, see getResult()
+			void requestResult();
+			/// Waits for the readback started by requestResult() (starts it if 
+			/// there is no pending one), updates and returns \p res
+			const asl::AVec<ResType> & getResult();
+			/// Returns the result residing on the device, one single-element 
+			/// MemBlock per component; available after generateAlg(). Other 
+			/// kernels can access it as excerpt(getResultACL(), generateVEConstant(0))
+			inline const VectorOfElementsData & getResultACL() const;
 			void generateAlg(Kernel & k);
 			void generateAlg();
 	};
 
+	/// The class generates code corresponding to a reduction operation of elements 
+	/**
+		 \ingroup ComplexDataTypes
+		 \sa MultiReductionAlgGenerator
+	 */
+	template <typename ResType, enum ReductionOperatorType Op> class ReductionAlgGenerator:
+		public MultiReductionAlgGenerator<ResType>
+	{
+		public:	
+			inline ReductionAlgGenerator(VectorOfElements v);
+	};
+
 	template <typename ResType> std::shared_ptr<ReductionAlgGenerator<ResType, ROT_SUM>> 
 		generateSumAlg(VectorOfElements v);
 
@@ -70,6 +115,25 @@ namespace acl
 
 	template <typename ResType> std::shared_ptr<ReductionAlgGenerator<ResType, ROT_PRODUCT>> 
 		generateProductAlg(VectorOfElements v);
+
+	/// generates fused reduction, the result contains sums, minima and maxima of the components of \p v
+	template <typename ResType> std::shared_ptr<MultiReductionAlgGenerator<ResType>> 
+		generateSumMinMaxAlg(VectorOfElements v);
+
+//------------------------- Implementation -----------------
+
+	template <typename ResType> 
+		inline const VectorOfElementsData & MultiReductionAlgGenerator<ResType>::getResultACL() const
+	{
+		return resACL;
+	}
+
+
+	template <typename ResType, enum ReductionOperatorType Op> 
+		inline ReductionAlgGenerator<ResType, Op>::ReductionAlgGenerator(VectorOfElements v):
+			MultiReductionAlgGenerator<ResType>(v, std::vector<ReductionOperatorType>(1, Op))
+	{
+	}
 	
 
 }  //namespace acl
@@ -27,6 +27,7 @@
 
 #include "aclTypesList.h"
 #include "aclHardware.h"
+#include "DataTypes/aclSubvector.h"
 
 using namespace std;
 
@@ -38,7 +39,7 @@ namespace acl
 	                unsigned int size2,
 	                CommandQueue queue2)
 	{
-		return ((compatibleSizes(size1, size2)) && (onSameDevice(queue1, queue2)));
+		return ((compatibleSizes(size1, size2)) && (inSameContext(queue1, queue2)));
 	}
 
 
@@ -66,6 +67,12 @@ namespace acl
 	}
 
 
+	bool inSameContext(CommandQueue queue1, CommandQueue queue2)
+	{
+		return (onSameDevice(queue1, queue2) || (getContext(queue1)() == getContext(queue2)()));
+	}
+
+
 	bool onSameDevice(CommandQueue queue1, CommandQueue queue2)
 	{
 		return ((queue1 == queue2) || (queue1.get() == 0) || (queue2.get() == 0));
@@ -94,6 +101,18 @@ namespace acl
 		return (e->getTypeSignature(KERNEL_BASIC) != "");
 	}
 
+
+	bool isSubvector(Element e)
+	{
+		#define BOOST_TT_rep_expression(r, data, t) \
+			if (dynamic_cast<Subvector<t>*>(e.get()) != NULL) \
+				return true;
+		BOOST_PP_SEQ_FOR_EACH(BOOST_TT_rep_expression, ~, BOOST_TT_acl_types)
+		#undef BOOST_TT_rep_expression
+
+		return false;
+	}
+
 	
 	void addElementToKernelSource(Element e,
 	                              vector<Element> & arguments,
@@ -122,6 +141,57 @@ namespace acl
 	}
 
 
+	void addElementToWrittenArguments(Element e,
+	                                  vector<Element> & writtenArguments)
+	{
+		// all arguments and local declarations of the target (e.g. Array of an excerpt)
+		// are considered as written
+		addElementToKernelSource(e, writtenArguments, writtenArguments);
+	}
+
+
+	void addElementToReadArguments(Element e,
+	                               vector<Element> & readArguments)
+	{
+		addElementToKernelSource(e, readArguments, readArguments);
+	}
+
+
+	template <typename T> string numToLiteral(T a)
+	{
+		stringstream s;
+		s << a;
+		return a < 0 ? "(" + s.str() + ")" : s.str();
+	}
+
+	template <> string numToLiteral(cl_uint a)
+	{
+		return asl::numToStr(a) + "u";
+	}
+
+	template <> string numToLiteral(cl_long a)
+	{
+		return "(" + asl::numToStr(a) + "L)";
+	}
+
+	// max_digits10 significant digits are sufficient for the exact round trip
+	template <> string numToLiteral(cl_float a)
+	{
+		stringstream s;
+		s << scientific << setprecision(8) << a << "f";
+		return a < 0 ? "(" + s.str() + ")" : s.str();
+	}
+
+	template <> string numToLiteral(cl_double a)
+	{
+		stringstream s;
+		s << scientific << setprecision(16) << a;
+		return a < 0 ? "(" + s.str() + ")" : s.str();
+	}
+
+	template string numToLiteral(cl_int a);
+
+
 	unsigned int paddingBytes(unsigned int size, unsigned int typeSize, CommandQueue queue)
 	{
 		// second modulo is added in order to make padding = 0 in the case
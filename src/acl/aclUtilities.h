@@ -44,7 +44,7 @@ namespace acl
 	typedef std::shared_ptr<cl::CommandQueue> CommandQueue;
 	
 	/// determines whether two elements are compatible
-	/// i.e. have compatible sizes and reside on the same device
+	/// i.e. have compatible sizes and reside in the same context
 	bool compatible(unsigned int size1, CommandQueue queue1,
 	                unsigned int size2, CommandQueue queue2);
 	bool compatible(unsigned int size, CommandQueue queue, Element e);
@@ -66,6 +66,10 @@ namespace acl
 	unsigned int paddingElements(unsigned int size,
 	                             const KernelConfiguration & kernelConfig);
 	
+	/// checks whether both queues belong to the same context,
+	/// so their buffers and events can be shared
+	bool inSameContext(CommandQueue queue1, CommandQueue queue2);
+
 	/// checks whether both elements reside on the same device
 	bool onSameDevice(CommandQueue queue1, CommandQueue queue2);
 	bool onSameDevice(CommandQueue queue, Element e);
@@ -75,11 +79,25 @@ namespace acl
 
 	bool isArgument(Element e);
 
+	/// checks whether \p e is a Subvector, which shares the memory with its vector
+	bool isSubvector(Element e);
+
 	/// adds \p e either to \p arguments or to \p localDeclarations
 	void addElementToKernelSource(Element e,
 	                              std::vector<Element> & arguments,
 			                      std::vector<Element> & localDeclarations);
+
+	/// adds all arguments and local declarations of \p e to \p writtenArguments; \p e is an assignment target
+	void addElementToWrittenArguments(Element e,
+	                                  std::vector<Element> & writtenArguments);
+
+	/// adds all arguments and local declarations of \p e to \p readArguments; \p e is read
+	void addElementToReadArguments(Element e,
+	                               std::vector<Element> & readArguments);
 	
+	/// Returns OpenCL literal which reproduces the value \p a exactly
+	template <typename T> std::string numToLiteral(T a);
+
 	template <typename T> const std::string& typeToStr();
 	template <typename T> inline const std::string typeToStr(unsigned int i);
 
@@ -69,6 +69,26 @@ namespace asl
 	{
 		return generateDataContainerACL_SP(b, t, n, gN, acl::hardware.defaultQueue);
 	}
+
+
+	SPDataWithGhostNodesACLData generateDataContainerACLHalf_SP(const Block &b, 
+	                                                            unsigned int n, 
+	                                                            unsigned int gN,
+	                                                            acl::CommandQueue queue)
+	{
+		auto a(std::make_shared<DataWithGhostNodesACLData>(b,gN));
+		a->setContainer(acl::generateVEDataHalf(productOfElements(a->getBlock().getSize()),
+		                                        n,
+		                                        queue));
+		return a;
+	}
+
+	SPDataWithGhostNodesACLData generateDataContainerACLHalf_SP(const Block &b, 
+	                                                            unsigned int n, 
+	                                                            unsigned int gN)
+	{
+		return generateDataContainerACLHalf_SP(b, n, gN, acl::hardware.defaultQueue);
+	}
 	
 
 	SPAbstractDataWithGhostNodes generateDCFullSafe(SPAbstractDataWithGhostNodes d)
@@ -99,6 +99,24 @@ namespace asl
 	                                                        acl::TypeID t,
 	                                                        unsigned int n, 
 	                                                        unsigned int gN);
+
+	/// generates pointer to ACL Data field with \p n components stored in half precision and \p gN ghost nodes
+	/**
+		 \ingroup DataFields
+		 The values are computed in the precision of the kernel, see acl::ArrayHalf
+	*/
+	SPDataWithGhostNodesACLData generateDataContainerACLHalf_SP(const Block &b, 
+	                                                            unsigned int n, 
+	                                                            unsigned int gN, 
+	                                                            acl::CommandQueue queue);
+
+	/// generates pointer to ACL Data field with \p n components stored in half precision and \p gN ghost nodes
+	/**
+		 \ingroup DataFields
+	*/
+	SPDataWithGhostNodesACLData generateDataContainerACLHalf_SP(const Block &b, 
+	                                                            unsigned int n, 
+	                                                            unsigned int gN);
 	
 	///	 \ingroup DataFields
 	SPDataWrapperACL generateDataContainer_SP(const Block &b, const acl::VectorOfElements & a);	
@@ -0,0 +1,184 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "aslSlabDecomposition.h"
+#include <acl/acl.h>
+#include <acl/aclGenerators.h>
+#include <acl/aclUtilities.h>
+#include <acl/DataTypes/aclMemBlock.h>
+#include <acl/aclMath/aclVectorOfElements.h>
+#include <aslGenerators.h>
+#include <cstring>
+
+
+namespace asl
+{
+
+	SlabDecomposition::SlabDecomposition(const Block & b, 
+	                                     const std::vector<acl::CommandQueue> & q):
+		block(b),
+		queues(q)
+	{
+		if (queues.size() == 0)
+			errorMessage("SlabDecomposition::SlabDecomposition() - no queues are given");
+		for (unsigned int i(1); i < queues.size(); ++i)
+			if (!acl::inSameContext(queues[0], queues[i]))
+				errorMessage("SlabDecomposition::SlabDecomposition() - the queues do not share the context");
+
+		const int n(block.getSize()[0]);
+		if (n < (int)queues.size())
+			errorMessage("SlabDecomposition::SlabDecomposition() - the block is thinner than the number of slabs");
+
+		unsigned int totalUnits(0);
+		std::vector<unsigned int> units(queues.size());
+		for (unsigned int i(0); i < queues.size(); ++i)
+		{
+			units[i] = acl::getNComputeUnits(queues[i]);
+			totalUnits += units[i];
+		}
+
+		unsigned int accumulatedUnits(0);
+		offsets.push_back(0);
+		for (unsigned int i(0); i < queues.size(); ++i)
+		{
+			accumulatedUnits += units[i];
+			// each slab gets at least one layer
+			int end(std::max(offsets[i] + 1, 
+			                 std::min(int(n * (unsigned long)accumulatedUnits / totalUnits),
+			                          n - int(queues.size() - 1 - i))));
+			Block::DV size(block.getSize());
+			size[0] = end - offsets[i];
+			Block::V position(block.position);
+			position[0] += offsets[i] * block.dx;
+			slabs.push_back(Block(size, block.dx, position));
+			offsets.push_back(end);
+		}
+		offsets.pop_back();
+	}
+
+
+	SPSlabDecomposition generateSlabDecomposition(const Block & b, 
+	                                              const acl::CommandQueue & queue)
+	{
+		return std::make_shared<SlabDecomposition>(b, acl::hardware.createSubDevices(queue));
+	}
+
+
+	SlabData::SlabData(SPSlabDecomposition d, acl::TypeID t, unsigned int n, unsigned int gN):
+		decomposition(d),
+		ghostBorder(gN),
+		layerSize(offset(d->getBlock(), gN).c2iTransformVector[0])
+	{
+		for (unsigned int i(0); i < decomposition->getNSlabs(); ++i)
+		{
+			if (decomposition->getSlab(i).getSize()[0] < (int)ghostBorder)
+				errorMessage("SlabData::SlabData() - slab " + numToStr(i) +
+				             " is thinner than the ghost layer");
+			slabs.push_back(generateDataContainerACL_SP(decomposition->getSlab(i),
+			                                            t, n, gN,
+			                                            decomposition->getQueue(i)));
+			// first touch of the memory by the device of the slab: the kernel runs
+			// on its queue before any host access, so the pages are placed on its node
+			acl::initData(slabs[i]->getEContainer(), acl::generateVEConstantN(n, 0));
+		}
+	}
+
+
+	void SlabData::exchangeHalos()
+	{
+		const unsigned int haloSize(ghostBorder * layerSize);
+		for (unsigned int i(0); i + 1 < slabs.size(); ++i)
+		{
+			const unsigned int thickness(decomposition->getSlab(i).getSize()[0]);
+			acl::VectorOfElementsData left(slabs[i]->getDContainer());
+			acl::VectorOfElementsData right(slabs[i + 1]->getDContainer());
+			for (unsigned int j(0); j < left.size(); ++j)
+			{
+				// last internal layers of the left slab -> lower ghost layers of the right one
+				acl::copy(*left[j], thickness * layerSize, *right[j], 0, haloSize);
+				// first internal layers of the right slab -> upper ghost layers of the left one
+				acl::copy(*right[j], haloSize, *left[j], (thickness + ghostBorder) * layerSize, haloSize);
+			}
+		}
+	}
+
+
+	void SlabData::scatter(SPDataWithGhostNodesACLData global)
+	{
+		if (!(global->getInternalBlock().getSize() == decomposition->getBlock().getSize()) ||
+		    global->getGhostBorder() != ghostBorder ||
+		    global->getDContainer().size() != slabs[0]->getDContainer().size())
+			errorMessage("SlabData::scatter() - the data is not compatible with the slabs");
+
+		acl::VectorOfElementsData g(global->getDContainer());
+		for (unsigned int j(0); j < g.size(); ++j)
+		{
+			const unsigned int typeSize(g[j]->getElementSize());
+			if (typeSize != slabs[0]->getDContainer()[j]->getElementSize())
+				errorMessage("SlabData::scatter() - the data and the slabs have different element sizes");
+			std::shared_ptr<void> source(g[j]->map(0, g[j]->getSize(), CL_MAP_READ));
+			for (unsigned int i(0); i < slabs.size(); ++i)
+			{
+				acl::ElementData slab(slabs[i]->getDContainer()[j]);
+				std::shared_ptr<void> destination(slab->map(0, slab->getSize(), CL_MAP_WRITE_INVALIDATE_REGION));
+				memcpy(destination.get(), 
+				       (char*)source.get() + decomposition->getSlabOffset(i) * layerSize * typeSize,
+				       slab->getSize() * typeSize);
+			}
+		}
+	}
+
+
+	void SlabData::gather(SPDataWithGhostNodesACLData global)
+	{
+		if (!(global->getInternalBlock().getSize() == decomposition->getBlock().getSize()) ||
+		    global->getGhostBorder() != ghostBorder ||
+		    global->getDContainer().size() != slabs[0]->getDContainer().size())
+			errorMessage("SlabData::gather() - the data is not compatible with the slabs");
+
+		acl::VectorOfElementsData g(global->getDContainer());
+		for (unsigned int j(0); j < g.size(); ++j)
+		{
+			const unsigned int typeSize(g[j]->getElementSize());
+			if (typeSize != slabs[0]->getDContainer()[j]->getElementSize())
+				errorMessage("SlabData::gather() - the data and the slabs have different element sizes");
+			// the slabs cover the whole data
+			std::shared_ptr<void> destination(g[j]->map(0, g[j]->getSize(), CL_MAP_WRITE_INVALIDATE_REGION));
+			for (unsigned int i(0); i < slabs.size(); ++i)
+			{
+				// the ghost layers between slabs are skipped, the outer ones are taken
+				const unsigned int thickness(decomposition->getSlab(i).getSize()[0]);
+				const unsigned int first(i == 0 ? 0 : ghostBorder);
+				const unsigned int last(i + 1 == slabs.size() ? thickness + 2 * ghostBorder : 
+				                                                thickness + ghostBorder);
+				std::shared_ptr<void> source(slabs[i]->getDContainer()[j]->map(first * layerSize,
+				                                                               (last - first) * layerSize,
+				                                                               CL_MAP_READ));
+				memcpy((char*)destination.get() + (decomposition->getSlabOffset(i) + first) * layerSize * typeSize,
+				       source.get(),
+				       (last - first) * layerSize * typeSize);
+			}
+		}
+	}
+
+} //asl
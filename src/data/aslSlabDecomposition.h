@@ -0,0 +1,152 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ASLSLABDECOMPOSITION_H
+#define ASLSLABDECOMPOSITION_H
+
+#include "aslDataWithGhostNodes.h"
+#include <acl/aclHardware.h>
+
+namespace asl
+{
+
+	/// Decomposition of a Block into slabs computed on different devices
+	/**
+		 \ingroup DataFields
+		 The block is cut along the first coordinate, which is the slowest 
+		 varying index of the containers. So every slab including its ghost 
+		 layers and every halo is a contiguous range of a global container.
+		 The slab thicknesses are proportional to the numbers of compute units
+		 of the devices. The typical use is a multi-socket CPU partitioned 
+		 into NUMA sub-devices, see generateSlabDecomposition().
+	*/
+	class SlabDecomposition
+	{
+		private:
+			Block block;
+			std::vector<acl::CommandQueue> queues;
+			std::vector<Block> slabs;
+			/// position of the first layer of each slab within \p block
+			std::vector<int> offsets;
+		public:
+			/// Splits \p b into one slab per queue, all \p q have to share the context
+			SlabDecomposition(const Block & b, const std::vector<acl::CommandQueue> & q);
+			inline unsigned int getNSlabs() const;
+			inline const Block & getBlock() const;
+			/// Returns the (internal) block of slab \p i
+			inline const Block & getSlab(unsigned int i) const;
+			/// Returns the position of the first layer of slab \p i within the block
+			inline int getSlabOffset(unsigned int i) const;
+			inline const acl::CommandQueue & getQueue(unsigned int i) const;
+	};
+
+	typedef std::shared_ptr<SlabDecomposition> SPSlabDecomposition;
+
+	/// Decomposes \p b over the NUMA sub-devices of the device of \p queue
+	/// \relates SlabDecomposition
+	SPSlabDecomposition generateSlabDecomposition(const Block & b, 
+	                                              const acl::CommandQueue & queue = acl::hardware.defaultQueue);
+
+
+	/// Data field distributed over the slabs of a SlabDecomposition
+	/**
+		 \ingroup DataFields
+		 Each slab is a DataWithGhostNodesACLData residing on the queue of the slab,
+		 so NumMethods created with it are computed on that device. The ghost layers
+		 between neighbouring slabs are updated by exchangeHalos(). The buffers
+		 are zeroed at the construction by kernels on their own devices; this first 
+		 touch places them in the memory of the corresponding NUMA node.
+	*/
+	class SlabData
+	{
+		private:
+			SPSlabDecomposition decomposition;
+			std::vector<SPDataWithGhostNodesACLData> slabs;
+			unsigned int ghostBorder;
+			/// number of container elements in one layer of the first coordinate
+			unsigned int layerSize;
+		public:
+			/// Creates slabs with \p n components of type \p t and \p gN ghost nodes
+			SlabData(SPSlabDecomposition d, acl::TypeID t, unsigned int n, unsigned int gN = 1);
+			inline unsigned int getNSlabs() const;
+			inline SPDataWithGhostNodesACLData getSlab(unsigned int i) const;
+			inline SPSlabDecomposition getDecomposition() const;
+			/// Copies the internal layers of each slab adjacent to its neighbours 
+			/// into their ghost layers. The copies are asynchronous, 
+			/// subsequent kernels wait for them by the buffer events.
+			void exchangeHalos();
+			/// Distributes \p global including all ghost layers over the slabs.
+			/// \p global has to have the block of the decomposition, 
+			/// the same components and ghost nodes.
+			void scatter(SPDataWithGhostNodesACLData global);
+			/// Collects the internal layers of the slabs and the outer ghost layers into \p global
+			void gather(SPDataWithGhostNodesACLData global);
+	};
+
+	typedef std::shared_ptr<SlabData> SPSlabData;
+
+//--------------------------- Implementation --------------------------
+
+	inline unsigned int SlabDecomposition::getNSlabs() const
+	{
+		return slabs.size();
+	}
+
+	inline const Block & SlabDecomposition::getBlock() const
+	{
+		return block;
+	}
+
+	inline const Block & SlabDecomposition::getSlab(unsigned int i) const
+	{
+		return slabs[i];
+	}
+
+	inline int SlabDecomposition::getSlabOffset(unsigned int i) const
+	{
+		return offsets[i];
+	}
+
+	inline const acl::CommandQueue & SlabDecomposition::getQueue(unsigned int i) const
+	{
+		return queues[i];
+	}
+
+	inline unsigned int SlabData::getNSlabs() const
+	{
+		return slabs.size();
+	}
+
+	inline SPDataWithGhostNodesACLData SlabData::getSlab(unsigned int i) const
+	{
+		return slabs[i];
+	}
+
+	inline SPSlabDecomposition SlabData::getDecomposition() const
+	{
+		return decomposition;
+	}
+
+} //asl
+
+#endif // ASLSLABDECOMPOSITION_H
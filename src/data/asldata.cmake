@@ -29,6 +29,7 @@ set(asldata_PUBLIC_HEADERS
 	data/aslDataWrapper.h
 	data/aslDataWithGhostNodes.h
 	data/aslProbe.h
+	data/aslSlabDecomposition.h
 )
 
 set(asldata_SOURCES
@@ -38,4 +39,5 @@ set(asldata_SOURCES
 	data/aslDataWrapper.cxx
 	data/aslDataWithGhostNodes.cxx
 	data/aslProbe.cxx
+	data/aslSlabDecomposition.cxx
 )
@@ -32,6 +32,13 @@
 #include <aslGenerators.h>
 #include <math/aslTemplateVE.h>
 #include <math/aslDistanceFunctionAlg.h>
+#include <acl/Kernels/aclKernel.h>
+#include <acl/Kernels/aclStepRecorder.h>
+#include <acl/DataTypes/aclArray.h>
+#include <acl/DataTypes/aclConstant.h>
+#include <acl/DataTypes/aclPrivateVariable.h>
+#include <acl/DataTypes/aclIndex.h>
+#include <algorithm>
 
 namespace asl
 {
@@ -235,6 +242,140 @@ namespace asl
 			copy(res && (computationalDomain->getEContainer() > 0.), res);
 		return res;
 	}
+
+
+	void BCondWithMap::addMaskedExpressions(acl::Kernel & k,
+	                                        acl::Element condition,
+	                                        const vector<acl::Element> & statements)
+	{
+		// the condition is kept in the kernel, it masks the tail of the vectorized 
+		// launch over the whole block if the list is not used
+		k.addExpression(acl::elementOperators::ifElse(condition, statements, {}));
+		if(!pointsListFlag)
+			return;
+
+		PointsList pl;
+		pl.kernel = &k;
+		pl.condition = condition;
+		pl.n = 0;
+		pl.mapStamp = 0;
+		pointsLists.push_back(pl);
+		buildPointsList(pointsLists.back());
+	}
+
+
+	void BCondWithMap::buildPointsList(PointsList & pl)
+	{
+		using namespace acl;
+		using namespace acl::elementOperators;
+
+		unsigned int size(pl.kernel->getSize());
+		CommandQueue queue(pl.kernel->getQueue() ? pl.kernel->getQueue() : 
+		                                          hardware.defaultQueue);
+		// the list of the previous map is a good estimate of the new one
+		unsigned int capacity(pl.n > 0 ? pl.n + pl.n / 4 + 1 : size / 16 + 1);
+
+		Element counter(new Array<cl_uint>(1, queue));
+		Element zero(new Constant<cl_uint>(0));
+		Element one(new Constant<cl_uint>(1));
+		Element position(new PrivateVariable<cl_uint>());
+		Element index(new Index(size));
+		vector<cl_uint> n(1, 0);
+
+		// stream compaction: each point of the condition takes a position in the list;
+		// the list is resized and the compaction is repeated if it overflows
+		Element list;
+		for(unsigned int attempt(0); attempt < 2; ++attempt)
+		{
+			list.reset(new Array<cl_uint>(capacity, queue));
+			n[0] = 0;
+			copy(n, counter);
+
+			Element capacityE(new Constant<cl_uint>(capacity));
+			KernelConfiguration kConf(KERNEL_BASIC);
+			kConf.extensions.push_back("cl_khr_global_int32_base_atomics");
+			Kernel compaction(kConf);
+			compaction.setLabel("BCondWithMap points list");
+			compaction.addExpression(ifElse(pl.condition,
+			                                {operatorAssignment(position, atomic_add(excerpt(counter, zero), one)),
+			                                 ifElse(position < capacityE,
+			                                        {operatorAssignment(excerpt(list, position), index)},
+			                                        {})},
+			                                {}));
+			compaction.setup();
+			compaction.compute();
+			copy(counter, n);
+
+			if(n[0] <= capacity)
+				break;
+			capacity = n[0];
+		}
+
+		// sorted indices keep the memory access of the boundary kernel coalesced
+		vector<cl_uint> points(capacity);
+		copy(list, points);
+		sort(points.begin(), points.begin() + n[0]);
+		// a long enough list is reused: the kernel source and its program 
+		// stay the same when only the number of points changes
+		unsigned int listSize(max(n[0], 1u));
+		if(pl.list && pl.list->getSize() >= listSize)
+			listSize = pl.list->getSize();
+		else
+			pl.list.reset(new Array<cl_uint>(listSize, queue));
+		points.resize(listSize);
+		copy(points, pl.list);
+		pl.n = n[0];
+
+		pl.kernel->setIndexList(pl.list, pl.n);
+		pl.mapStamp = getMapStamp();
+	}
+
+
+	cl_ulong BCondWithMap::getMapStamp() const
+	{
+		cl_ulong stamp(0);
+		vector<SPAbstractDataWithGhostNodes> maps({map, computationalDomain});
+		for(unsigned int i(0); i < maps.size(); ++i)
+		{
+			if(!maps[i])
+				continue;
+			auto data(dynamic_pointer_cast<acl::MemBlock>(maps[i]->getEContainer()[0]));
+			// stamps grow with each write, the sum changes whenever one of them changes
+			if(data)
+				stamp += data->getContentStamp();
+		}
+		return stamp;
+	}
+
+
+	void BCondWithMap::updatePointsLists()
+	{
+		if(pointsLists.empty())
+			return;
+
+		acl::StepRecorder::hostAction([this]()
+		{
+			cl_ulong stamp(getMapStamp());
+			for(unsigned int i(0); i < pointsLists.size(); ++i)
+				if(pointsLists[i].mapStamp != stamp)
+					buildPointsList(pointsLists[i]);
+		});
+	}
+
+
+	void BCondWithMap::setPointsList(bool flag)
+	{
+		pointsListFlag = flag;
+	}
+
+
+	unsigned int BCondWithMap::getNPoints() const
+	{
+		unsigned int n(0);
+		for(unsigned int i(0); i < pointsLists.size(); ++i)
+			n += pointsLists[i].n;
+		return n;
+	}
 		
 	BCondSlice::BCondSlice(const Block & b):
 		block(b),
@@ -32,6 +32,7 @@
 namespace acl
 {
 	class ExpressionContainer;
+	class Kernel;
 }
 
 namespace asl
@@ -96,9 +97,29 @@ namespace asl
 		which can be interpreted as a computation map. The inteprretation law is:
 		- computation region: \f$ map(\vec r) > 0 \f$
 		- outside region: \f$ map(\vec r) \leq 0 \f$
+
+		With setPointsList() the kernels run only over the list of the 
+		points where their condition is true (see addMaskedExpressions()) 
+		instead of the whole block. The lists are compacted on the device 
+		at init() and rebuilt when the content of the map changes.
 	*/
 	class BCondWithMap:public NumMethod
 	{
+		private:
+			/// kernel launched over the points where \p condition is true
+			struct PointsList
+			{
+				acl::Kernel * kernel;
+				acl::Element condition;
+				acl::Element list;
+				unsigned int n;
+				/// content stamp of the map used for the list
+				cl_ulong mapStamp;
+			};
+			std::vector<PointsList> pointsLists;
+			void buildPointsList(PointsList & pl);
+			/// content stamp of the map, 0 if the map is not stored in a MemBlock
+			cl_ulong getMapStamp() const;
 		protected:
 			/// flag whether the point list to be generated or not
 			bool pointsListFlag;
@@ -138,6 +159,14 @@ namespace asl
 			acl::VectorOfElements isGhostNode();
 			/// returns expression corresponding to check if the current node is computation one
 			acl::VectorOfElements isComputationNode();
+			/// Adds \p statements executed in the points where \p condition is true to \p k;
+			/// with pointsListFlag the kernel is launched only over the list of these points.
+			/// \p condition should depend only on the maps
+			void addMaskedExpressions(acl::Kernel & k,
+			                          acl::Element condition,
+			                          const std::vector<acl::Element> & statements);
+			/// Rebuilds the lists of points if the map has changed, called by execute()
+			void updatePointsLists();
 			
 			/**
 			 \param m the map
@@ -177,6 +206,11 @@ namespace asl
 			             const VectorTemplate * const vt);			
 		public:
 			inline const VectorTemplate * getVT();			
+			/// Enables the launches over the lists of the boundary points; 
+			/// should be called before init()
+			void setPointsList(bool flag = true);
+			/// Returns total number of points in the lists
+			unsigned int getNPoints() const;
 	};
 
 	
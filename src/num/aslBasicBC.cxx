@@ -59,7 +59,7 @@ namespace asl
 
 	void BCConstantValue::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 	}
 
 
@@ -93,18 +93,18 @@ namespace asl
 		kk << (acl::assignmentSafe(vGhost, 
 		                           select(vGhost, value, isGhostNode(), type)));
 
-		kernel->addExpression(acl::elementOperators::
-		                      ifElse(acl::elementOperators::any((map->getEContainer() <= 0 && 
+		addMaskedExpressions(*kernel,
+		                     acl::elementOperators::any((map->getEContainer() <= 0 && 
 		                             map->getEContainer() > -.9999)[0]),
-		                             kk.expression, 
-		                             {} ));
+		                     kk.expression);
 
 		kernel->setup();
 	}
 
 	void BCConstantValueMap::execute()
 	{
-		kernel->compute();
+		updatePointsLists();
+		kernel->computeAsync();
 	}
 		
 	BCValuePFMap::BCValuePFMap(Data d, 
@@ -135,18 +135,18 @@ namespace asl
 		kk << (acl::assignmentSafe(vGhost, 
 		                           select(vGhost, val, isGhostNode(), type)));
 
-		kernel->addExpression(acl::elementOperators::
-		                      ifElse(acl::elementOperators::any((map->getEContainer() <= 0 && 
+		addMaskedExpressions(*kernel,
+		                     acl::elementOperators::any((map->getEContainer() <= 0 && 
 		                             map->getEContainer() > -.9999)[0]),
-		                             kk.expression, 
-		                             {} ));
+		                     kk.expression);
 
 		kernel->setup();
 	}
 
 	void BCValuePFMap::execute()
 	{
-		kernel->compute();
+		updatePointsLists();
+		kernel->computeAsync();
 	}
 
 		
@@ -222,18 +222,18 @@ namespace asl
 		                                      isGhostNode(0), 
 		                                      type)));
 		}
-		kernel->addExpression(acl::elementOperators::
-			                      ifElse(acl::elementOperators::any((isGhostNode() && 
+		addMaskedExpressions(*kernel,
+		                     acl::elementOperators::any((isGhostNode() && 
 			                                                         map->getEContainer() > -.9999)[0]),
-		                             kk.expression, 
-		                             {} ));
+		                     kk.expression);
 
 		kernel->setup();
 	}
 
 	void BCConstantValueMiddlePointMap::execute()
 	{
-		kernel->compute();
+		updatePointsLists();
+		kernel->computeAsync();
 	}
 
 		
@@ -260,7 +260,7 @@ namespace asl
 
 	void BCConstantGradient::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 	}
 
 	void BCConstantGradient::setValue(const acl::VectorOfElements & v)
@@ -349,11 +349,10 @@ namespace asl
 				                              isGhostNode(0) && counter>0.1, 
 				                              type)));
 		}
-		kernel->addExpression(acl::elementOperators::
-		                      ifElse(acl::elementOperators::any((map->getEContainer() <= 0 && 
+		addMaskedExpressions(*kernel,
+		                     acl::elementOperators::any((map->getEContainer() <= 0 && 
 		                             map->getEContainer() > -.9999)[0]),
-		                             kk.expression, 
-		                             {} ));
+		                     kk.expression);
 
 		kernel->setup();
 	}
@@ -430,7 +429,8 @@ namespace asl
 */
 	void BCConstantGradientMap::execute()
 	{
-		kernel->compute();
+		updatePointsLists();
+		kernel->computeAsync();
 	}
 
 		
@@ -454,7 +454,7 @@ namespace asl
 
 	void BCConstantSource::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 	}
 
 
@@ -486,7 +486,7 @@ namespace asl
 
 	void BCDirectCopier::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 	}
 
 	SPBCond generateBCConstantValue(SPAbstractDataWithGhostNodes d, 
@@ -75,7 +75,7 @@ namespace asl
 
 	void BCConstantValueMap::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 	}
 */
 /*
@@ -118,7 +118,7 @@ namespace asl
 
 	void BCValuePFMap::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 	}
 */
 		
@@ -211,11 +211,10 @@ namespace asl
 			                                    isComputationNode(0), 
 			                                    type)));
 		}
-		kernelCN->addExpression(acl::elementOperators::
-			                        ifElse(acl::elementOperators::any((isComputationNode() && 
+		addMaskedExpressions(*kernelCN,
+		                     acl::elementOperators::any((isComputationNode() && 
 			                                                           map->getEContainer() < .9999)[0]),
-			                               kkCN.expression, 
-			                               {} ));
+		                     kkCN.expression);
 		kernelCN->setup();
 
 		
@@ -254,18 +253,18 @@ namespace asl
 			                                    isGhostNode(0), 
 			                                    type)));
 		}
-		kernelGN->addExpression(acl::elementOperators::
-			                        ifElse(acl::elementOperators::any((isGhostNode() && 
+		addMaskedExpressions(*kernelGN,
+		                     acl::elementOperators::any((isGhostNode() && 
 			                                                           map->getEContainer() > -.9999)[0]),
-			                               kkGN.expression, 
-			                               {} ));
+		                     kkGN.expression);
 		kernelGN->setup();
 	}
 
 	void BCConstantGradientMap2::execute()
 	{
-		kernelCN->compute();
-		kernelGN->compute();
+		updatePointsLists();
+		kernelCN->computeAsync();
+		kernelGN->computeAsync();
 	}
 
 		
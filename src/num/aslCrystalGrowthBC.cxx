@@ -130,18 +130,18 @@ namespace asl
 		                                      isGhostNode(0), 
 		                                      type)));
 		}
-		kernel->addExpression(acl::elementOperators::
-		                      ifElse(acl::elementOperators::any((map->getEContainer() <= 0 && 
+		addMaskedExpressions(*kernel,
+		                     acl::elementOperators::any((map->getEContainer() <= 0 && 
 		                             map->getEContainer() > -.9999)[0]),
-		                             kk.expression, 
-		                             {} ));
+		                     kk.expression);
 
 		kernel->setup();
 	}
 
 	void BCLinearGrowthMap::execute()
 	{
-		kernel->compute();
+		updatePointsLists();
+		kernel->computeAsync();
 	}
 
 	BCLinearGrowthMap1::BCLinearGrowthMap1(Data d, 
@@ -235,18 +235,18 @@ namespace asl
 		kk << (acl::assignmentSafe(data->getEContainer(), 
 		                           select(dataTVE.getValue(0), vLocal, isGhostNode(0), type)));
 		
-		kernel->addExpression(acl::elementOperators::
-		                      ifElse(acl::elementOperators::any((isGhostNode() && 
+		addMaskedExpressions(*kernel,
+		                     acl::elementOperators::any((isGhostNode() && 
 		                             map->getEContainer() > -.9999)[0]),
-		                             kk.expression, 
-		                             {} ));
+		                     kk.expression);
 
 		kernel->setup();
 	}
 
 	void BCLinearGrowthMap1::execute()
 	{
-		kernel->compute();
+		updatePointsLists();
+		kernel->computeAsync();
 	}
 
 	BCLinearGrowthMap2::BCLinearGrowthMap2(Data d, 
@@ -342,11 +342,10 @@ namespace asl
 			                                    isComputationNode(0), 
 			                                    type)));
 		}
-		kernelCN->addExpression(acl::elementOperators::
-			                        ifElse(acl::elementOperators::any((isGhostNode() && 
+		addMaskedExpressions(*kernelCN,
+		                     acl::elementOperators::any((isGhostNode() && 
 			                                                           map->getEContainer() > -.9999)[0]),
-			                               kkCN.expression, 
-			                               {} ));
+		                     kkCN.expression);
 
 		kernelCN->setup();
 		
@@ -389,19 +388,19 @@ namespace asl
 			                                    isGhostNode(0), 
 			                                    type)));
 		}
-		kernelGN->addExpression(acl::elementOperators::
-			                        ifElse(acl::elementOperators::any((isGhostNode() && 
+		addMaskedExpressions(*kernelGN,
+		                     acl::elementOperators::any((isGhostNode() && 
 			                                                           map->getEContainer() > -.9999)[0]),
-			                               kkGN.expression, 
-			                               {} ));
+		                     kkGN.expression);
 
 		kernelGN->setup();
 	}
 
 	void BCLinearGrowthMap2::execute()
 	{
-		kernelCN->compute();
-		kernelGN->compute();
+		updatePointsLists();
+		kernelCN->computeAsync();
+		kernelGN->computeAsync();
 	}
 
 		
@@ -161,6 +161,11 @@ namespace asl
 		for (unsigned int i(0); i < cData.size(); ++i)
 			swapBuffers(cData[i]->getDContainer(), cInternalData[i]->getDContainer());
 	}
+
+	bool FDAdvectionDiffusion::hasProcessing() const
+	{
+		return true;
+	}
 		
 
 	void FDAdvectionDiffusion::setDiffusionCoefficient(acl::VectorOfElements dC, 
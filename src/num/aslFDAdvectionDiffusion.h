@@ -85,6 +85,7 @@ namespace asl
 
 			virtual void init0();
 			virtual void postProcessing();
+			virtual bool hasProcessing() const;
 		public:			
 			FDAdvectionDiffusion();
 			FDAdvectionDiffusion(Data c, 
@@ -103,6 +104,9 @@ namespace asl
 			void setDistributionFunction(Field f);
 			
 			inline Field getVelocity();
+			inline bool getCompressibilityCorrection() const;
+			/// returns true if the electric field terms are set
+			inline bool getElectricField() const;
 			inline Field getDistributionFunction();
 			inline std::vector<Data> & getData();
 			void addComponent(Data c, acl::VectorOfElements & dC);
@@ -148,6 +152,16 @@ namespace asl
 		return velocity;
 	}
 
+	inline bool FDAdvectionDiffusion::getCompressibilityCorrection() const
+	{
+		return compressibilityCorrectionFlag;
+	}
+
+	inline bool FDAdvectionDiffusion::getElectricField() const
+	{
+		return electricField;
+	}
+
 	inline FDAdvectionDiffusion::Field FDAdvectionDiffusion::getDistributionFunction()
 	{
 		return distributionFunction;
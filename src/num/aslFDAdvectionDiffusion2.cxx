@@ -119,7 +119,7 @@ namespace asl
 
 	void FDAdvectionDiffusion2::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 		for (unsigned int i(0); i < cData.size(); ++i)
 			swapBuffers(cData[i]->getDContainer(),cInternalData[i]->getDContainer());
 	}
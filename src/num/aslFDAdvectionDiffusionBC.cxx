@@ -115,13 +115,17 @@ namespace asl
 		                             kk.expression, 
 		                             {} ));
 */  
-		(*kernel)<<kk;
+		// the flux is imposed only in the ghost nodes
+		addMaskedExpressions(*kernel,
+		                     acl::elementOperators::any(isGhostNode()[0]),
+		                     kk.expression);
 		kernel->setup();
 	}
 
 	void BCConstantFluxMap::execute()
 	{
-		kernel->compute();
+		updatePointsLists();
+		kernel->computeAsync();
 	}
 
 
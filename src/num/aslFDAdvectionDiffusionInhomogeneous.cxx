@@ -79,7 +79,7 @@ namespace asl
 
 	void FDAdvectionDiffusionInhomogeneous::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 		for (unsigned int i(0); i < cData.size(); ++i)
 			swapBuffers(cData[i]->getDContainer(),cInternalData[i]->getDContainer());
 	}
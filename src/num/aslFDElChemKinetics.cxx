@@ -113,7 +113,7 @@ namespace asl
 
 	void FDBVKinetics::executeJ()
 	{
-		kernelJ->compute();
+		kernelJ->computeAsync();
 	};
 		
 	SPFDBVKinetics generateFDBVKinetics(SPDataWithGhostNodesACLData a0,
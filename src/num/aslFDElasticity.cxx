@@ -146,7 +146,7 @@ namespace asl
 
 	void FDElasticityIncompressibleStatic::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 		swapBuffers(displacementData->getDContainer(),
 		            displacementInternalData->getDContainer());
 		swapBuffers(pressure->getDContainer(),
@@ -236,7 +236,7 @@ namespace asl
 
 	void FDElasticityRelaxation::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 		swapBuffers(displacementData->getDContainer(),
 		            displacementInternalData->getDContainer());
 		swapBuffers(pressure->getDContainer(),
@@ -313,7 +313,7 @@ namespace asl
 
 	void FDElasticity2::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 		swapBuffers(displacementData->getDContainer(),displacementInternalData->getDContainer());
 	}
 	
@@ -71,7 +71,7 @@ namespace asl
 
 	void BCRigidWall::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 	}
 
 	SPBCond generateBCRigidWall(SPFDElasticityIncompressibleStatic nm, 
@@ -115,7 +115,7 @@ namespace asl
 
 	void BCRigidWallRelaxation::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 	}
 
 	SPBCond generateBCRigidWall(SPFDElasticityRelaxation nm, 
@@ -172,7 +172,7 @@ namespace asl
 
 	void BCFreeSurface::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 	}
 
 	BCFreeSurface2::BCFreeSurface2(SPFDElasticity2 nm):
@@ -201,7 +201,7 @@ namespace asl
 
 	void BCFreeSurface2::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 	}
 
 		
@@ -255,7 +255,7 @@ namespace asl
 
 	void BCImposedDisplacementVelocityValue::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 	}
 
 
@@ -287,7 +287,7 @@ namespace asl
 
 	void BCAccelerationSource2::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 	}
 		
 	BCZeroStressMap::BCZeroStressMap(SPAbstractDataWithGhostNodes d, 
@@ -407,11 +407,10 @@ namespace asl
 		
 		kk << (acl::assignmentSafe(displacement->getEContainer(), vU0Res));
 
-		kernel->addExpression(acl::elementOperators::
-		                      ifElse(acl::elementOperators::any((isGhostNode() && 
+		addMaskedExpressions(*kernel,
+		                     acl::elementOperators::any((isGhostNode() && 
 		                             map->getEContainer() > -.9999)[0]),
-		                             kk.expression, 
-		                             {} ));
+		                     kk.expression);
 		kernel->setup();
 //		cout<<kernel->getKernelSource()<<endl;
 
@@ -542,7 +541,8 @@ namespace asl
 
 	void BCZeroStressMap::execute()
 	{
-		kernel->compute();
+		updatePointsLists();
+		kernel->computeAsync();
 	}		
 		
 	SPNumMethod generateBCZeroStress(SPElasticityCommonA nm, 
@@ -116,6 +116,11 @@ namespace asl
 		for (unsigned int i(0); i < cData.size(); ++i)
 			swapBuffers(cData[i]->getDContainer(), cInternalData[i]->getDContainer());
 	}
+
+	bool FDMultiPhase::hasProcessing() const
+	{
+		return true;
+	}
 		
 
 	void FDMultiPhase::setDiffusionCoefficient(acl::VectorOfElements dC)
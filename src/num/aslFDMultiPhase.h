@@ -76,6 +76,7 @@ namespace asl
 
 			virtual void init0();
 			virtual void postProcessing();
+			virtual bool hasProcessing() const;
 		public:			
 			FDMultiPhase();
 			FDMultiPhase(Data c, 
@@ -137,7 +137,7 @@ namespace asl
 
 	void FDPoroElasticity::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 		swapBuffers(displacementData->getDContainer(),
 		            displacementInternalData->getDContainer());
 		swapBuffers(pressureData->getDContainer(), 
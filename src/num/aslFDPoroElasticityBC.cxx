@@ -77,7 +77,7 @@ namespace asl
 
 	void BCRigidWallPoroElasticity::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 	}
 
 	BCRigidWallDF::BCRigidWallDF(SPFDPoroElasticity nm, 
@@ -161,17 +161,17 @@ namespace asl
 			                                  type)));
 		}
 */
-		kernel->addExpression(acl::elementOperators::
-		                      ifElse(acl::elementOperators::any((isGhostNode() && 
+		addMaskedExpressions(*kernel,
+		                     acl::elementOperators::any((isGhostNode() && 
 		                             map->getEContainer() > -.9999)[0]),
-		                             kk.expression, 
-		                             {} ));
+		                     kk.expression);
 		kernel->setup();
 	}
 
 	void BCRigidWallDF::execute()
 	{
-		kernel->compute();
+		updatePointsLists();
+		kernel->computeAsync();
 	}		
 		
 	void addBCRigidWall(std::vector<SPNumMethod> & bcList,
@@ -165,6 +165,11 @@ namespace asl
 		for (unsigned int i(0); i < cData.size(); ++i)
 			swapBuffers(cData[i]->getDContainer(), cInternalData[i]->getDContainer());
 	}
+
+	bool FDStefanMaxwell::hasProcessing() const
+	{
+		return true;
+	}
 		
 
 	void FDStefanMaxwell::setDiffusionCoefficient(acl::VectorOfElements dC, 
@@ -329,6 +334,11 @@ namespace asl
 		            phiInternalData->getDContainer());
 	}
 
+	bool FDStefanMaxwellElectricField::hasProcessing() const
+	{
+		return true;
+	}
+
 	void FDStefanMaxwellElectricField::setPhiS(Field pS)
 	{
 		phiS=pS;
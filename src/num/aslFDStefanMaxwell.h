@@ -88,6 +88,7 @@ namespace asl
 
 			virtual void init0();
 			virtual void postProcessing();
+			virtual bool hasProcessing() const;
 		public:			
 			FDStefanMaxwell();
 			FDStefanMaxwell(Data c1,
@@ -173,6 +174,7 @@ namespace asl
 
 			virtual void init0();
 			virtual void postProcessing();
+			virtual bool hasProcessing() const;
 		public:			
 			FDStefanMaxwellElectricField(SPFDStefanMaxwell sm, Data phi);
 			void setPhiS(Field pS);
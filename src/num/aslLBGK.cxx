@@ -30,6 +30,7 @@
 
 #include <data/aslDataWithGhostNodes.h>
 #include <acl/Kernels/aclKernel.h>
+#include <acl/Kernels/aclParallelBuild.h>
 #include <acl/aclElementBase.h>
 #include <acl/DataTypes/aclMemBlock.h>
 #include <acl/DataTypes/aclIndex.h>
@@ -72,6 +73,25 @@ namespace asl
 	}
 
 
+	acl::VectorOfElements computeEquilibrium(acl::VectorOfElements rho,
+	                                         acl::VectorOfElements momentum,
+	                                         const VectorTemplate* vt,
+	                                         bool compressible)
+	{
+		unsigned int nv(vt->vectors.size());
+		acl::VectorOfElements aDotMomentum(a_i_dot_v(momentum, vt));
+		if (compressible)
+			return rho * acl::generateVEConstantN(nv, 1.) + 
+			       3. * aDotMomentum +
+			       4.5 * acl::productOfElements(aDotMomentum,aDotMomentum)/rho -
+			       1.5 * momentum*momentum/rho * acl::generateVEConstantN(nv, 1.);
+		return rho * acl::generateVEConstantN(nv, 1.) + 
+		       3. * aDotMomentum +
+		       4.5 * acl::productOfElements(aDotMomentum,aDotMomentum) -
+		       1.5 * momentum*momentum * acl::generateVEConstantN(nv, 1.);
+	}
+
+
 	acl::VectorOfElements generateInverceVector(acl::VectorOfElements f, const VectorTemplate* vt)
 	{
 		unsigned int nv(vt->vectors.size());
@@ -89,7 +109,9 @@ namespace asl
 		vectorTemplate(NULL),
 		flagComputeVelocity(true),
 		flagComputeRho(true),
-		flagCompressible(true)
+		flagCompressible(true),
+		flagHalfPrecisionStorage(false),
+		flagInPlaceStreaming(false)
 	{
 	}
 
@@ -103,7 +125,9 @@ namespace asl
 		viscosity(nu),
 		flagComputeVelocity(true),
 		flagComputeRho(true),
-		flagCompressible(true)
+		flagCompressible(true),
+		flagHalfPrecisionStorage(false),
+		flagInPlaceStreaming(false)
 	{
 		createData(v->getInternalBlock(),
 		           v->getEContainer()[0]->getQueue(),
@@ -120,12 +144,29 @@ namespace asl
 		viscosity(nu),
 		flagComputeVelocity(compVel),
 		flagComputeRho(compRho),
-		flagCompressible(true)
+		flagCompressible(true),
+		flagHalfPrecisionStorage(false),
+		flagInPlaceStreaming(false)
 	{
 		createData(b,queue,viscosity[0]->getTypeID());
 		createCopyKernels();
 	}
 
+	LBGK::LBGK(const acl::KernelConfiguration & kernelConfig,
+	           Param nu, 
+	           const VectorTemplate* vT,
+	           bool compVel, bool compRho):
+		SingleKernelNM(kernelConfig),
+		vectorTemplate(vT),
+		viscosity(nu),
+		flagComputeVelocity(compVel),
+		flagComputeRho(compRho),
+		flagCompressible(true),
+		flagHalfPrecisionStorage(false),
+		flagInPlaceStreaming(false)
+	{
+	}
+
 	void LBGK::createData(Block b, acl::CommandQueue queue, acl::TypeID type)
 	{
 		unsigned int nv(vectorTemplate->vectors.size());
@@ -139,13 +180,21 @@ namespace asl
 		unsigned int maxIncrement(maxComponent(*fShiftsIncrement));
 
 		unsigned int length(productOfElements(offset(b).getSize()));
-		unsigned int poolLength(2*length+4*maxIncrement);
+		// the in-place shifts oscillate around the middle of the pool
+		unsigned int poolLength(flagInPlaceStreaming ? 
+		                        length+2*maxIncrement : 2*length+4*maxIncrement);
 
 		for(unsigned int i(0); i<nv; ++i){
-			(*fShifts)[i]= ((*fShiftsIncrement)[i] >0 ? 0 : poolLength-length);
+			if (flagInPlaceStreaming)
+				(*fShifts)[i]=maxIncrement;
+			else
+				(*fShifts)[i]= ((*fShiftsIncrement)[i] >0 ? 0 : poolLength-length);
 		}
 				
-		copy(acl::generateVEData(poolLength, type, nv, queue),fPool);
+		if (flagHalfPrecisionStorage)
+			copy(acl::generateVEDataHalf(poolLength, nv, queue),fPool);
+		else
+			copy(acl::generateVEData(poolLength, type, nv, queue),fPool);
 
 		acl::VectorOfElements container(generateVESubElements(fPool,
 		                                                 length,
@@ -157,8 +206,27 @@ namespace asl
 			rho=generateDataContainerACL_SP(b, type, 1u, 1u, queue);
 	}
 
+	LBGK::Data LBGK::getF(const acl::VectorOfElementsData & pool)
+	{
+		if (fPool.size() == 0)
+			errorMessage("LBGK::getF() - the method has no pool of the distribution functions");
+		if (pool.size() != fPool.size() || pool[0]->getSize() != fPool[0]->getSize())
+			errorMessage("LBGK::getF() - the pool does not match the own one");
+
+		unsigned int length(productOfElements(f->getBlock().getSize()));
+		acl::VectorOfElements container(generateVESubElements(pool,
+		                                                 length,
+		                                                 acl::generateVEVariableSP(fShifts)));
+		return generateDataContainer_SP(f->getInternalBlock(), container, 1u);
+	}
+
 	void LBGK::createCopyKernels()
 	{
+		copyKernels.clear();
+		// no pool in the derived classes with own storage
+		if (flagInPlaceStreaming || fPool.size() == 0)
+			return;
+
 		unsigned int nv(fPool.size());
 		unsigned int length(f->getEContainer()[0]->getSize());
 		unsigned int poolLength(fPool[0]->getSize());
@@ -166,9 +234,11 @@ namespace asl
 		acl::Element ind(new acl::Index(length));
 		acl::Element backShift(new acl::Constant<cl_int>(poolLength-length));
 		
+		acl::ParallelBuild parallelBuild;
 		copyKernels.resize(nv);
 		for(unsigned int i(0); i<nv; ++i){
 			copyKernels[i].reset(new acl::Kernel(acl::KERNEL_SIMDUA));
+			copyKernels[i]->setLabel("LBGK copyKernel[" + numToStr(i) + "]");
 			using namespace acl::elementOperators;
 			using acl::elementOperators::operator+;
 			if((*fShiftsIncrement)[i]>0)
@@ -180,12 +250,50 @@ namespace asl
 				                operatorAssignmentSafe(excerpt(fPool[i],backShift+ind),
 				                					   f->getEContainer()[i]));
 
+			if(kernelsQueue)
+				copyKernels[i]->setQueue(kernelsQueue);
 			copyKernels[i]->setup();
 		}		
+		parallelBuild.build();
+	}
+
+	void LBGK::setHalfPrecisionStorage(bool flag)
+	{
+		if (flag == flagHalfPrecisionStorage)
+			return;
+		if (flag && viscosity[0]->getTypeID() != acl::TYPE_FLOAT)
+			errorMessage("LBGK::setHalfPrecisionStorage() - half precision storage is supported only for single precision computations");
+
+		flagHalfPrecisionStorage = flag;
+		createData(v->getInternalBlock(), 
+		           v->getEContainer()[0]->getQueue(), 
+		           viscosity[0]->getTypeID());
+		createCopyKernels();
+	}
+
+	void LBGK::setInPlaceStreaming(bool flag)
+	{
+		if (flag == flagInPlaceStreaming)
+			return;
+
+		flagInPlaceStreaming = flag;
+		createData(v->getInternalBlock(), 
+		           v->getEContainer()[0]->getQueue(), 
+		           viscosity[0]->getTypeID());
+		createCopyKernels();
+	}
+
+	void LBGK::setQueue(const acl::CommandQueue & queue)
+	{
+		SingleKernelNM::setQueue(queue);
+		kernelsQueue = queue;
+		for(unsigned int i(0); i<copyKernels.size(); ++i)
+			copyKernels[i]->setQueue(queue);
 	}
 
 	void LBGK::init0()
 	{
+		kernel->setLabel("LBGK collision");
 		unsigned int nv(vectorTemplate->vectors.size());
 		acl::TypeID typeID(viscosity[0]->getTypeID());
 
@@ -196,46 +304,65 @@ namespace asl
 		acl::VectorOfElements pRho(generateVEPrivateVariable(1u, typeID));
 
 		acl::VectorOfElements momentum(generateVEPrivateVariable(nd,typeID));
-		acl::VectorOfElements aDotMomentum(a_i_dot_v(momentum,vectorTemplate));
 		
 		acl::VectorOfElements w(generateVEPrivateVariable(1u, typeID));
-		(*kernel)<<(fOld=f->getEContainer());
+		(*kernel)<<(fOld=getFSource());
 		(*kernel)<<(w= 1./(3. * viscosity + .5));
 		(*kernel)<<(momentum = computeMomentum(fOld,vectorTemplate));
 		(*kernel)<<(pRho = computeRho(fOld,vectorTemplate));
 		// valid for both compressible and incompresible
 		if(omega.size()>0)
 			(*kernel)<< (momentum += (2./w)* crossProduct(omega, momentum));
+		// velocity shift of the equilibrium: the fields get the momentum 
+		// in the middle of the step, the equilibrium the one shifted by tau force
+		if(force.size()>0)
+			(*kernel)<< (momentum += .5 * force);
 
 		if(flagComputeRho)
-			(*kernel)<<	acl::assignmentSafe(rho->getEContainer(), pRho);
+			(*kernel)<<	acl::assignmentSafe(getNodeElements(rho), pRho);
 		if(flagComputeVelocity)
 		{
 			if (flagCompressible)
-				(*kernel)<<	acl::assignmentSafe(v->getEContainer(), momentum/pRho);
+				(*kernel)<<	acl::assignmentSafe(getNodeElements(v), momentum/pRho);
 			else
-				(*kernel)<<	acl::assignmentSafe(v->getEContainer(), momentum);
+				(*kernel)<<	acl::assignmentSafe(getNodeElements(v), momentum);
 		}
 		
-		if (flagCompressible)
-			(*kernel)<<(fEq=pRho * acl::generateVEConstantN(nv, 1.) + 
-			                3. * aDotMomentum +
-				            4.5 * acl::productOfElements(aDotMomentum,aDotMomentum)/pRho -
-		    		    	1.5 * momentum*momentum/pRho * acl::generateVEConstantN(nv, 1.)
-		        		);
-		else
-			(*kernel)<<(fEq=pRho * acl::generateVEConstantN(nv, 1.) + 
-			                3. * aDotMomentum +
-				            4.5 * acl::productOfElements(aDotMomentum,aDotMomentum) -
-		    		    	1.5 * momentum*momentum * acl::generateVEConstantN(nv, 1.)
-		        		);
+		if(force.size()>0)
+			(*kernel)<< (momentum += (1./w - .5) * force);
+		(*kernel)<<(fEq=computeEquilibrium(pRho, momentum, vectorTemplate, flagCompressible));
 			
 		auto fNew(fOld*(1.-w)+ w*fEq);
-		(*kernel)<<(assignmentSafe(f->getEContainer(),fNew));		
+		(*kernel)<<(assignmentSafe(getFDestination(),fNew));		
+	}
+
+	acl::VectorOfElements LBGK::getFSource()
+	{
+		return f->getEContainer();
+	}
+
+	acl::VectorOfElements LBGK::getFDestination()
+	{
+		// with the in-place streaming each cell writes only to the locations it 
+		// reads: the post-collision values are stored in the opposite directions
+		if (flagInPlaceStreaming)
+			return generateInverceVector(f->getEContainer(), vectorTemplate);
+		return f->getEContainer();
+	}
+
+	acl::VectorOfElements LBGK::getNodeElements(DataD field)
+	{
+		return field->getEContainer();
 	}
 
 	void LBGK:: preProcessing()
 	{
+		if (flagInPlaceStreaming)
+		{
+			(*fShifts)+=(*fShiftsIncrement);
+			return;
+		}
+
 		unsigned int nv(fShifts->getSize());
 		unsigned int length(f->getEContainer()[0]->getSize());
 		unsigned int poolLength(fPool[0]->getSize());
@@ -243,17 +370,48 @@ namespace asl
 			if((*fShifts)[i]+length+(*fShiftsIncrement)[i]>poolLength || 
 			   (*fShifts)[i]+(*fShiftsIncrement)[i]<0)
 			{
-				copyKernels[i]->compute();
+				copyKernels[i]->computeAsync();
 				(*fShifts)[i]=(*fShiftsIncrement)[i] >0 ? 0 : poolLength-length;
 			}
 		(*fShifts)+=(*fShiftsIncrement);
 	}
 
+	void LBGK::postProcessing()
+	{
+		if (!flagInPlaceStreaming)
+			return;
+
+		// restores the direction order of getF(); the shifts alternate between 
+		// the middle of the pool and the middle shifted against the stream
+		unsigned int nv(vectorTemplate->vectors.size());
+		for(unsigned int i(0); i<nv; ++i)
+		{
+			unsigned int j(vectorTemplate->invertVectors[i]);
+			if(i < j)
+			{
+				acl::swapBuffers(*fPool[i], *fPool[j]);
+				swap((*fShifts)[i], (*fShifts)[j]);
+			}
+		}
+	}
+
+	bool LBGK::hasProcessing() const
+	{
+		return true;
+	}
+
 	void LBGK::setOmega(LBGK::Param w)
 	{
 		copy(w,omega);
 	}
 
+	void LBGK::setForce(LBGK::Param f)
+	{
+		if(f.size() != v->getEContainer().size())
+			errorMessage("LBGK::setForce - the force should have as many components as the velocity");
+		copy(f,force);
+	}
+
 	LBGKUtilities::LBGKUtilities(SPLBGK lbgk):
 		num(lbgk)
 	{
@@ -297,6 +455,7 @@ namespace asl
 
 	void LBGKTurbulence::init0()
 	{
+		kernel->setLabel("LBGKTurbulence collision");
 		unsigned int nv(vectorTemplate->vectors.size());
 		acl::TypeID typeID(viscosity[0]->getTypeID());
 
@@ -307,10 +466,9 @@ namespace asl
 		acl::VectorOfElements pRho(generateVEPrivateVariable(1u, typeID));
 
 		acl::VectorOfElements momentum(generateVEPrivateVariable(nd,typeID));
-		acl::VectorOfElements aDotMomentum(a_i_dot_v(momentum,vectorTemplate));
 		
 		acl::VectorOfElements w(generateVEPrivateVariable(1u, typeID));
-		(*kernel)<<(fOld=f->getEContainer());
+		(*kernel)<<(fOld=getFSource());
 // Turbulence
 		auto fL2(fOld*fOld);
 		auto fmfEqL2((fOld-fEq)*(fOld-fEq));
@@ -327,31 +485,26 @@ namespace asl
 		// valid for both compressible and incompresible
 		if(omega.size()>0)
 			(*kernel)<< (momentum += (2./w)* crossProduct(omega, momentum));
+		// velocity shift of the equilibrium: the fields get the momentum 
+		// in the middle of the step, the equilibrium the one shifted by tau force
+		if(force.size()>0)
+			(*kernel)<< (momentum += .5 * force);
 
 		if(flagComputeRho)
-			(*kernel)<<	acl::assignmentSafe(rho->getEContainer(), pRho);
+			(*kernel)<<	acl::assignmentSafe(getNodeElements(rho), pRho);
 		if(flagComputeVelocity)
 		{
 			if (flagCompressible)
-				(*kernel)<<	acl::assignmentSafe(v->getEContainer(), momentum/pRho);
+				(*kernel)<<	acl::assignmentSafe(getNodeElements(v), momentum/pRho);
 			else
-				(*kernel)<<	acl::assignmentSafe(v->getEContainer(), momentum);
+				(*kernel)<<	acl::assignmentSafe(getNodeElements(v), momentum);
 		}
 		
-		if (flagCompressible)
-			(*kernel)<<(fEq=pRho * acl::generateVEConstantN(nv, 1.) + 
-			                3. * aDotMomentum +
-				            4.5 * acl::productOfElements(aDotMomentum,aDotMomentum)/pRho -
-		    		    	1.5 * momentum*momentum/pRho * acl::generateVEConstantN(nv, 1.)
-		        		);
-		else
-			(*kernel)<<(fEq=pRho * acl::generateVEConstantN(nv, 1.) + 
-			                3. * aDotMomentum +
-				            4.5 * acl::productOfElements(aDotMomentum,aDotMomentum) -
-		    		    	1.5 * momentum*momentum * acl::generateVEConstantN(nv, 1.)
-		        		);
+		if(force.size()>0)
+			(*kernel)<< (momentum += (1./w - .5) * force);
+		(*kernel)<<(fEq=computeEquilibrium(pRho, momentum, vectorTemplate, flagCompressible));
 		auto fNew(fOld*(1.-w)+ w*fEq);
-		(*kernel)<<(assignmentSafe(f->getEContainer(),fNew));		
+		(*kernel)<<(assignmentSafe(getFDestination(),fNew));		
 	}
 		
 } //asl
@@ -61,6 +61,18 @@ namespace asl
 	*/
 	acl::VectorOfElements computeMomentum(acl::VectorOfElements f, const VectorTemplate* vt);
 
+	/// returns VectorOfElements with the equilibrium distribution functions
+	/**	
+		\relates LBGK
+
+		 \p momentum is \f$ \rho \vec v \f$ in the compressible case
+		 and \f$ \vec v \f$ in the incompressible one
+	*/
+	acl::VectorOfElements computeEquilibrium(acl::VectorOfElements rho,
+	                                         acl::VectorOfElements momentum,
+	                                         const VectorTemplate* vt,
+	                                         bool compressible = true);
+
 	/// generates Vector Of Elements with inverce components according to \p vt
 	acl::VectorOfElements generateInverceVector(acl::VectorOfElements f, const VectorTemplate* vt);
 
@@ -73,6 +85,14 @@ namespace asl
 	/**
 		 \ingroup TransportProcesses
 		 \ingroup NumMethods		 
+
+		 The streaming is performed by shifts of the distribution functions 
+		 within a pool twice as long as the block, the pool is periodically 
+		 rewound by copy kernels. With setInPlaceStreaming() a single copy 
+		 of the distribution functions is kept (AA pattern): the collision 
+		 writes the result of each direction to the opposite one, the 
+		 opposite directions are swapped after the step. getF() provides 
+		 the same view of the distribution functions in both schemes.
 	*/
 	class LBGK: public SingleKernelNM
 	{
@@ -92,6 +112,8 @@ namespace asl
 			std::shared_ptr<AVec<int>> fShiftsIncrement;
 
 			std::vector<acl::SPKernel> copyKernels;
+			/// the queue set by setQueue(), the copy kernels created later use it as well
+			acl::CommandQueue kernelsQueue;
 
 			Param viscosity;
 			Param deltat;
@@ -101,12 +123,27 @@ namespace asl
 			bool flagComputeVelocity;
 			bool flagComputeRho;
 			bool flagCompressible;
+			bool flagHalfPrecisionStorage;
+			bool flagInPlaceStreaming;
 			
-			void createData(Block b, acl::CommandQueue queue, acl::TypeID type);
+			virtual void createData(Block b, acl::CommandQueue queue, acl::TypeID type);
 			void createCopyKernels();
+			/// returns the distribution functions of the current node read by the collision
+			virtual acl::VectorOfElements getFSource();
+			/// returns the elements the post-collision distribution functions are written to
+			virtual acl::VectorOfElements getFDestination();
+			/// returns the elements of \p field (velocity or density) of the current node
+			virtual acl::VectorOfElements getNodeElements(DataD field);
 			/// contains classical moving procedure
 			virtual void preProcessing();
+			/// swaps the opposite directions in the in-place streaming
+			virtual void postProcessing();
+			virtual bool hasProcessing() const;
 			virtual void init0();
+			/// initializes the parameters only, the data are created by the derived class
+			LBGK(const acl::KernelConfiguration & kernelConfig,
+			     Param nu, const VectorTemplate* vT, 
+			     bool compVel, bool compRho);
 			
 		public:			
 			LBGK();
@@ -114,20 +151,49 @@ namespace asl
 			LBGK(Block b, Param nu, const VectorTemplate* vT, 
 			     bool compVel=true, bool compRho=true, 
 			     acl::CommandQueue queue = acl::hardware.defaultQueue);
+			/// sets the queue of the main and the copy kernels
+			virtual void setQueue(const acl::CommandQueue & queue);
 			void setViscosity(Param nu);
 			double getViscosity(unsigned int i = 0);
+			inline const Param & getViscosityParam() const;
 			/// sets angular velocity for Coriolis term in noninertial reference frame
 			void setOmega(Param w);
+			inline const Param & getOmega() const;
+			/// sets uniform body force density in lattice units, e.g. a pressure gradient 
+			/// driving a flow; should be called before init()
+			void setForce(Param f);
+			inline const Param & getForce() const;
 			void setVectorTemplate(const VectorTemplate* vT);
 			inline const VectorTemplate* getVectorTemplate() const;
 
 
 			inline Data getF();
+			/// returns pool of the distribution functions, getF() is a view of it
+			inline const acl::VectorOfElementsData & getFPool() const;
+			/// returns the distribution functions stored in \p pool at the same 
+			/// positions as getF() in getFPool(), e.g. for a second copy of them
+			Data getF(const acl::VectorOfElementsData & pool);
 			inline DataD getRho();
 			inline DataD getVelocity();
 
 			inline void setCompressible(bool flag = true);
 			inline const bool & getCompressible() const;
+			/// stores the distribution functions in half precision
+			/**
+				 The collision is computed in single precision, the memory traffic 
+				 of the streaming is halved. Should be called before init(), 
+				 the existing values of the distribution functions are lost.
+			*/
+			void setHalfPrecisionStorage(bool flag = true);
+			inline const bool & getHalfPrecisionStorage() const;
+			/// keeps a single copy of the distribution functions (AA pattern)
+			/**
+				 Halves the memory of the distribution functions and removes 
+				 the copy kernels. Should be called before init(), 
+				 the existing values of the distribution functions are lost.
+			*/
+			void setInPlaceStreaming(bool flag = true);
+			inline const bool & getInPlaceStreaming() const;
 	};
 
 	typedef std::shared_ptr<LBGK> SPLBGK;	
@@ -180,6 +246,11 @@ namespace asl
 		return f;
 	}
 
+	inline const acl::VectorOfElementsData & LBGK::getFPool() const
+	{
+		return fPool;
+	}
+
 	inline LBGK::DataD LBGK::getRho()
 	{
 		return rho;
@@ -190,6 +261,21 @@ namespace asl
 		return v;
 	}
 	
+	inline const LBGK::Param & LBGK::getViscosityParam() const
+	{
+		return viscosity;
+	}
+
+	inline const LBGK::Param & LBGK::getOmega() const
+	{
+		return omega;
+	}
+
+	inline const LBGK::Param & LBGK::getForce() const
+	{
+		return force;
+	}
+
 	inline const VectorTemplate* LBGK::getVectorTemplate() const
 	{
 		return vectorTemplate;
@@ -204,6 +290,16 @@ namespace asl
 	{
 		return flagCompressible;
 	}
+
+	inline const bool & LBGK::getHalfPrecisionStorage() const
+	{
+		return flagHalfPrecisionStorage;
+	}
+
+	inline const bool & LBGK::getInPlaceStreaming() const
+	{
+		return flagInPlaceStreaming;
+	}
 		
 } // asl
 #endif // ASLLBGK_H
@@ -79,7 +79,7 @@ namespace asl
 
 	void BCLBGKCommon::execute()
 	{
-		km->compute();
+		km->computeAsync();
 	}
 
 		
@@ -244,11 +244,10 @@ namespace asl
 			kk << (acl::assignmentSafe(vGhost, select(vGhost, vBulk, isBoundary, type)));
 		}		
 
-		kernel->addExpression(acl::elementOperators::
-		                      ifElse(acl::elementOperators::any((map->getEContainer() <= 0 && 
+		addMaskedExpressions(*kernel,
+		                     acl::elementOperators::any((map->getEContainer() <= 0 && 
 		                             map->getEContainer() > -.9999)[0]),
-		                             kk.expression, 
-		                             {} ));
+		                     kk.expression);
 
 		kernel->setup();
 	}
@@ -256,7 +255,8 @@ namespace asl
 
 	void BCNoSlipMap::execute()
 	{
-		kernel->compute();
+		updatePointsLists();
+		kernel->computeAsync();
 	}		
 
 	BCVelocityMap::BCVelocityMap(SPLBGK nm, 
@@ -338,11 +338,10 @@ namespace asl
 			                                  type)));
 		}
 
-		kernel->addExpression(acl::elementOperators::
-		                      ifElse(acl::elementOperators::any((map->getEContainer() <= 0 && 
+		addMaskedExpressions(*kernel,
+		                     acl::elementOperators::any((map->getEContainer() <= 0 && 
 		                             map->getEContainer() > -.9999)[0]),
-		                             kk.expression, 
-		                             {} ));
+		                     kk.expression);
 
 		kernel->setup();
 	}
@@ -350,7 +349,8 @@ namespace asl
 
 	void BCVelocityMap::execute()
 	{
-		kernel->compute();
+		updatePointsLists();
+		kernel->computeAsync();
 	}		
 
 	BCConstantPressureVelocityMap::BCConstantPressureVelocityMap(SPLBGK nm, 
@@ -422,11 +422,10 @@ namespace asl
 			                                  type)));
 		}
 
-		kernel->addExpression(acl::elementOperators::
-		                      ifElse(acl::elementOperators::any((map->getEContainer() <= 0 && 
+		addMaskedExpressions(*kernel,
+		                     acl::elementOperators::any((map->getEContainer() <= 0 && 
 		                             map->getEContainer() > -.9999)[0]),
-		                             kk.expression, 
-		                             {} ));
+		                     kk.expression);
 
 		kernel->setup();
 	}
@@ -434,7 +433,8 @@ namespace asl
 
 	void BCConstantPressureVelocityMap::execute()
 	{
-		kernel->compute();
+		updatePointsLists();
+		kernel->computeAsync();
 	}		
 
 
@@ -505,11 +505,10 @@ namespace asl
 			                                  type)));
 		}
 
-		kernel->addExpression(acl::elementOperators::
-		                      ifElse(acl::elementOperators::any((map->getEContainer() <= 0 && 
+		addMaskedExpressions(*kernel,
+		                     acl::elementOperators::any((map->getEContainer() <= 0 && 
 		                             map->getEContainer() > -.9999)[0]),
-		                             kk.expression, 
-		                             {} ));
+		                     kk.expression);
 
 		kernel->setup();
 	}
@@ -517,7 +516,8 @@ namespace asl
 
 	void BCTransportLimitedDepositionMap::execute()
 	{
-		kernel->compute();
+		updatePointsLists();
+		kernel->computeAsync();
 	}		
 
 	BCKineticsLimitedDepositionMap::
@@ -589,11 +589,10 @@ namespace asl
 			                                  type)));
 		}
 
-		kernel->addExpression(acl::elementOperators::
-		                      ifElse(acl::elementOperators::any((map->getEContainer() <= 0 && 
+		addMaskedExpressions(*kernel,
+		                     acl::elementOperators::any((map->getEContainer() <= 0 && 
 		                             map->getEContainer() > -.9999)[0]),
-		                             kk.expression, 
-		                             {} ));
+		                     kk.expression);
 
 		kernel->setup();
 	}
@@ -601,7 +600,8 @@ namespace asl
 
 	void BCKineticsLimitedDepositionMap::execute()
 	{
-		kernel->compute();
+		updatePointsLists();
+		kernel->computeAsync();
 	}		
 
 	ComputeSurfaceFluxMap::ComputeSurfaceFluxMap(SPLBGK nm,
@@ -656,10 +656,9 @@ namespace asl
 
 		kk << (acl::assignmentSafe(fluxField->getEContainer(),flux));
 
-		kernel->addExpression(acl::elementOperators::
-		                      ifElse(acl::elementOperators::any((fabs(map->getEContainer()) < .9999)[0]),
-		                             kk.expression, 
-		                             {} ));
+		addMaskedExpressions(*kernel,
+		                     acl::elementOperators::any((fabs(map->getEContainer()) < .9999)[0]),
+		                     kk.expression);
 
 		kernel->setup();
 	}
@@ -667,7 +666,8 @@ namespace asl
 
 	void ComputeSurfaceFluxMap::execute()
 	{
-		kernel->compute();
+		updatePointsLists();
+		kernel->computeAsync();
 	}
 
 
@@ -727,10 +727,9 @@ namespace asl
 
 		kk << (acl::assignmentSafe(forceField->getEContainer(),force));
 
-		kernel->addExpression(acl::elementOperators::
-		                      ifElse(acl::elementOperators::any((fabs(map->getEContainer()) < .9999)[0]),
-		                             kk.expression, 
-		                             {} ));
+		addMaskedExpressions(*kernel,
+		                     acl::elementOperators::any((fabs(map->getEContainer()) < .9999)[0]),
+		                     kk.expression);
 
 		kernel->setup();
 	}
@@ -738,7 +737,8 @@ namespace asl
 
 	void ComputeSurfaceForceMap::execute()
 	{
-		kernel->compute();
+		updatePointsLists();
+		kernel->computeAsync();
 	}		
 		
 
@@ -0,0 +1,392 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+
+#include "aslLBGKMultiBlock.h"
+#include "aslGenerators.h"
+#include <aslGeomInc.h>
+#include <acl/aclGenerators.h>
+#include <acl/acl.h>
+#include <acl/DataTypes/aclArray.h>
+#include <acl/Kernels/aclKernel.h>
+#include <acl/aclMath/aclVectorOfElements.h>
+#include <data/aslDataWithGhostNodes.h>
+#include <math/aslTemplates.h>
+
+namespace asl
+{
+
+	/// coordinates of the point \p p within a block of the \p size
+	inline AVec<int> indexToCoordinates(unsigned int p, const AVec<int> & size)
+	{
+		unsigned int nd(nD(size));
+		AVec<int> c(nd);
+		for (int d(nd - 1); d >= 0; --d)
+		{
+			c[d] = p % size[d];
+			p /= size[d];
+		}
+		return c;
+	}
+
+	template <typename T> void loadWeights(const vector<double> & w, acl::Element e)
+	{
+		vector<T> wT(w.begin(), w.end());
+		acl::copy(wT, e);
+	}
+
+	inline acl::VectorOfElementsData loadIndices(vector<cl_int> & ind, acl::CommandQueue queue)
+	{
+		acl::VectorOfElementsData res(1);
+		res[0].reset(new acl::Array<cl_int>(ind.size(), queue));
+		acl::copy(ind, res[0]);
+		return res;
+	}
+
+
+	LBGKMultiBlock::LBGKMultiBlock(Block b, Param nu, const VectorTemplate* vT, 
+	                               bool compVel, bool compRho, 
+	                               acl::CommandQueue queue_):
+		coarse(new LBGK(b, nu, vT, compVel, compRho, queue_)),
+		viscosity(nu),
+		vectorTemplate(vT),
+		flagComputeVelocity(compVel),
+		flagComputeRho(compRho),
+		flagStarted(false),
+		flagInitialized(false),
+		queue(queue_)
+	{
+	}
+
+	unsigned int LBGKMultiBlock::addRefinementBox(AVec<int> a0, AVec<int> aE)
+	{
+		if (flagInitialized)
+			errorMessage("LBGKMultiBlock::addRefinementBox - the refined blocks should be added before init()");
+		const Block & b(coarse->getVelocity()->getInternalBlock());
+		const AVec<int> & size(b.getSize());
+		unsigned int nd(nD(b));
+		if (nD(a0) != nd || nD(aE) != nd)
+			errorMessage("LBGKMultiBlock::addRefinementBox - dimensions of the box do not match the block");
+		for (unsigned int d(0); d < nd; ++d)
+			if (a0[d] < 1 || aE[d] > size[d] - 2 || aE[d] < a0[d])
+				errorMessage("LBGKMultiBlock::addRefinementBox - the box should be within the block and stay one cell apart from its borders");
+		for (unsigned int i(0); i < boxes0.size(); ++i)
+		{
+			bool overlap(true);
+			for (unsigned int d(0); d < nd; ++d)
+				overlap = overlap && a0[d] <= boxesE[i][d] && boxes0[i][d] <= aE[d];
+			if (overlap)
+				errorMessage("LBGKMultiBlock::addRefinementBox - the box overlaps the refined block " + numToStr(i));
+		}
+
+		// convective scaling: dx and dt are halved, the viscosity in lattice units is doubled
+		Block fineBlock(2 * (aE - a0 + AVec<int>(nd, 1)), 
+		                b.dx * .5, 
+		                b.position + b.dx * (AVec<>(a0) - AVec<>(nd, .25)));
+		fine.push_back(SPLBGK(new LBGK(fineBlock, 
+		                               2. * viscosity, 
+		                               vectorTemplate, 
+		                               flagComputeVelocity, 
+		                               flagComputeRho, 
+		                               queue)));
+		boxes0.push_back(a0);
+		boxesE.push_back(aE);
+		fineBCs.resize(fine.size());
+		return fine.size() - 1;
+	}
+
+	unsigned int LBGKMultiBlock::addRefinementBand(SPDistanceFunction df, double width)
+	{
+		using namespace acl::elementOperators;
+		const Block & b(coarse->getVelocity()->getInternalBlock());
+		Block ext(offset(b));
+		unsigned int nd(nD(b));
+		unsigned int length(productOfElements(ext.getSize()));
+
+		auto map(generateDataContainer_SP(b, df, 1u, viscosity[0]->getTypeID()));
+		acl::VectorOfElements mask(acl::generateVEData(length, acl::TYPE_INT, 1u, queue));
+		acl::initData(mask, select(acl::generateVEConstant(1), 
+		                           fabs(map->getEContainer()) < width, 
+		                           acl::TYPE_INT));
+		vector<cl_int> inBand;
+		acl::copy(mask[0], inBand);
+
+		AVec<int> a0(b.getSize());
+		AVec<int> aE(nd, -1);
+		for (unsigned int p(0); p < length; ++p)
+		{
+			if (inBand[p] == 0)
+				continue;
+			AVec<int> c(indexToCoordinates(p, ext.getSize()) - AVec<int>(nd, 1));
+			for (unsigned int d(0); d < nd; ++d)
+			{
+				a0[d] = std::min(a0[d], c[d] - 1);
+				aE[d] = std::max(aE[d], c[d] + 1);
+			}
+		}
+		if (aE[0] < 0)
+			errorMessage("LBGKMultiBlock::addRefinementBand - the band does not cross the block");
+		// the clamped block gets its ghost values from the coarse nodes next to the 
+		// border instead of the boundary conditions of the coarse block
+		bool clamped(false);
+		for (unsigned int d(0); d < nd; ++d)
+		{
+			clamped = clamped || a0[d] < 1 || aE[d] > b.getSize()[d] - 2;
+			a0[d] = std::max(a0[d], 1);
+			aE[d] = std::min(aE[d], b.getSize()[d] - 2);
+		}
+		if (clamped)
+			warningMessage("LBGKMultiBlock::addRefinementBand - the band reaches the borders of the block, the refined block is cut one cell apart from them");
+		return addRefinementBox(a0, aE);
+	}
+
+	void LBGKMultiBlock::addCoarseBC(SPNumMethod bc)
+	{
+		coarseBCs.push_back(bc);
+	}
+
+	void LBGKMultiBlock::addFineBC(unsigned int i, SPNumMethod bc)
+	{
+		if (i >= fine.size())
+			errorMessage("LBGKMultiBlock::addFineBC - there is no such refined block");
+		fineBCs[i].push_back(bc);
+	}
+
+	void LBGKMultiBlock::buildInterface(unsigned int iF)
+	{
+		using namespace acl::elementOperators;
+		Interface & itf(interfaces[iF]);
+		
+		unsigned int nd(nD(boxes0[iF]));
+		unsigned int nv(vectorTemplate->vectors.size());
+		unsigned int nCorners(1 << nd);
+		acl::TypeID type(viscosity[0]->getTypeID());
+		const AVec<int> & a0(boxes0[iF]);
+		const AVec<int> & aE(boxesE[iF]);
+
+		Block extC(offset(coarse->getVelocity()->getInternalBlock()));
+		Block extF(offset(fine[iF]->getVelocity()->getInternalBlock()));
+		const AVec<int> & sizeF(extF.getSize());
+		const AVec<int> & stridesC(extC.c2iTransformVector);
+		const AVec<int> & stridesF(extF.c2iTransformVector);
+
+		// the fine ghost nodes and their coarse neighbours:
+		// the fine node j lies at the coarse coordinate a0 - 1/4 + j/2
+		vector<cl_int> ghostsH;
+		vector<vector<cl_int> > neighboursH(nCorners);
+		vector<vector<double> > weightsH(nCorners);
+		unsigned int lengthF(productOfElements(sizeF));
+		for (unsigned int p(0); p < lengthF; ++p)
+		{
+			AVec<int> e(indexToCoordinates(p, sizeF));
+			bool ghost(false);
+			for (unsigned int d(0); d < nd; ++d)
+				ghost = ghost || e[d] == 0 || e[d] == sizeF[d] - 1;
+			if (!ghost)
+				continue;
+
+			ghostsH.push_back(p);
+			AVec<int> q0(nd);
+			AVec<> t(nd);
+			for (unsigned int d(0); d < nd; ++d)
+			{
+				// 4 q = 4 a0 - 1 + 2 j, j = e - 1
+				int q4(4 * a0[d] + 2 * e[d] - 3);
+				q0[d] = (q4 - (q4 % 4 + 4) % 4) / 4;
+				t[d] = .25 * (q4 - 4 * q0[d]);
+			}
+			for (unsigned int k(0); k < nCorners; ++k)
+			{
+				AVec<int> c(q0);
+				double w(1.);
+				for (unsigned int d(0); d < nd; ++d)
+				{
+					bool upper((k >> d) & 1);
+					c[d] += upper;
+					w *= upper ? t[d] : 1. - t[d];
+				}
+				neighboursH[k].push_back((c + AVec<int>(nd, 1)) * stridesC);
+				weightsH[k].push_back(w);
+			}
+		}
+
+		unsigned int nGhosts(ghostsH.size());
+		acl::copy(loadIndices(ghostsH, queue), itf.ghosts);
+		itf.coarseNeighbours.clear();
+		acl::copy(acl::generateVEData(nGhosts, type, nCorners, queue), itf.weights);
+		for (unsigned int k(0); k < nCorners; ++k)
+		{
+			itf.coarseNeighbours.push_back(loadIndices(neighboursH[k], queue));
+			if (type == acl::TYPE_DOUBLE)
+				loadWeights<cl_double>(weightsH[k], itf.weights[k]);
+			else
+				loadWeights<cl_float>(weightsH[k], itf.weights[k]);
+		}
+		acl::copy(acl::generateVEData(nGhosts, type, nv, queue), itf.fBefore);
+		acl::copy(acl::generateVEData(nGhosts, type, nv, queue), itf.fAfter);
+
+		// the coarse nodes covered by the fine block and their 2^nd children
+		AVec<int> sizeCovered(aE - a0 + AVec<int>(nd, 1));
+		unsigned int nCovered(productOfElements(sizeCovered));
+		vector<cl_int> coveredH(nCovered);
+		vector<vector<cl_int> > childrenH(nCorners, vector<cl_int>(nCovered));
+		for (unsigned int p(0); p < nCovered; ++p)
+		{
+			AVec<int> c(indexToCoordinates(p, sizeCovered));
+			coveredH[p] = (c + a0 + AVec<int>(nd, 1)) * stridesC;
+			for (unsigned int k(0); k < nCorners; ++k)
+			{
+				AVec<int> j(2 * c + AVec<int>(nd, 1));
+				for (unsigned int d(0); d < nd; ++d)
+					j[d] += (k >> d) & 1;
+				childrenH[k][p] = j * stridesF;
+			}
+		}
+		acl::copy(loadIndices(coveredH, queue), itf.covered);
+		itf.children.clear();
+		for (unsigned int k(0); k < nCorners; ++k)
+			itf.children.push_back(loadIndices(childrenH[k], queue));
+
+		// the non-equilibrium parts are proportional to tau dt
+		acl::VectorOfElements tauC(3. * viscosity + .5);
+		acl::VectorOfElements tauF(6. * viscosity + .5);
+		acl::VectorOfElements sCF((tauF - 1.) / (2. * (tauC - 1.)));
+		bool compressible(coarse->getCompressible());
+
+		acl::VectorOfElements fI(acl::generateVEPrivateVariable(nv, type));
+		acl::VectorOfElements fEq(acl::generateVEPrivateVariable(nv, type));
+		acl::VectorOfElements pRho(acl::generateVEPrivateVariable(1u, type));
+		acl::VectorOfElements momentum(acl::generateVEPrivateVariable(nd, type));
+
+		acl::VectorOfElements coarseF(coarse->getF()->getEContainer());
+		acl::VectorOfElements fineF(fine[iF]->getF()->getEContainer());
+
+		itf.interpolation.reset(new acl::Kernel(acl::KERNEL_BASIC));
+		itf.interpolation->setLabel("LBGKMultiBlock interpolation");
+		acl::VectorOfElements sum(acl::excerpt(coarseF, itf.coarseNeighbours[0]) * 
+		                          acl::subVE(itf.weights, 0));
+		for (unsigned int k(1); k < nCorners; ++k)
+			acl::copy(sum + acl::excerpt(coarseF, itf.coarseNeighbours[k]) * 
+			           acl::subVE(itf.weights, k), sum);
+		(*itf.interpolation) << (fI = sum);
+		(*itf.interpolation) << (pRho = computeRho(fI, vectorTemplate));
+		(*itf.interpolation) << (momentum = computeMomentum(fI, vectorTemplate));
+		(*itf.interpolation) << (fEq = computeEquilibrium(pRho, momentum, 
+		                                                  vectorTemplate, 
+		                                                  compressible));
+		(*itf.interpolation) << (itf.fAfter = fEq + (fI - fEq) * sCF);
+
+		acl::VectorOfElements fineGhosts(acl::excerpt(fineF, itf.ghosts));
+		itf.fillBefore.reset(new acl::Kernel(acl::KERNEL_BASIC));
+		itf.fillBefore->setLabel("LBGKMultiBlock ghost nodes");
+		(*itf.fillBefore) << (fineGhosts = itf.fBefore);
+		itf.fillMiddle.reset(new acl::Kernel(acl::KERNEL_BASIC));
+		itf.fillMiddle->setLabel("LBGKMultiBlock ghost nodes");
+		(*itf.fillMiddle) << (fineGhosts = .5 * (acl::VectorOfElements(itf.fBefore) + itf.fAfter));
+
+		itf.restriction.reset(new acl::Kernel(acl::KERNEL_BASIC));
+		itf.restriction->setLabel("LBGKMultiBlock restriction");
+		acl::VectorOfElements average(acl::excerpt(fineF, itf.children[0]));
+		for (unsigned int k(1); k < nCorners; ++k)
+			acl::copy(average + acl::excerpt(fineF, itf.children[k]), average);
+		(*itf.restriction) << (fI = average * (1. / nCorners));
+		(*itf.restriction) << (pRho = computeRho(fI, vectorTemplate));
+		(*itf.restriction) << (momentum = computeMomentum(fI, vectorTemplate));
+		(*itf.restriction) << (fEq = computeEquilibrium(pRho, momentum, 
+		                                                vectorTemplate, 
+		                                                compressible));
+		(*itf.restriction) << (acl::excerpt(coarseF, itf.covered) = 
+		                       fEq + (fI - fEq) / sCF);
+
+		itf.interpolation->setup();
+		itf.fillBefore->setup();
+		itf.fillMiddle->setup();
+		itf.restriction->setup();
+	}
+
+	void LBGKMultiBlock::init()
+	{
+		coarse->init();
+		for (unsigned int i(0); i < fine.size(); ++i)
+			fine[i]->init();
+		initAll(coarseBCs);
+		for (unsigned int i(0); i < fineBCs.size(); ++i)
+			initAll(fineBCs[i]);
+
+		interfaces.resize(fine.size());
+		for (unsigned int i(0); i < fine.size(); ++i)
+			buildInterface(i);
+		flagStarted = false;
+		flagInitialized = true;
+	}
+
+	void LBGKMultiBlock::execute()
+	{
+		// the values of the coarse step before the first one
+		if (!flagStarted)
+		{
+			for (unsigned int i(0); i < interfaces.size(); ++i)
+			{
+				interfaces[i].interpolation->compute();
+				for (unsigned int j(0); j < interfaces[i].fAfter.size(); ++j)
+					acl::swapBuffers(*interfaces[i].fBefore[j], 
+					                 *interfaces[i].fAfter[j]);
+			}
+			flagStarted = true;
+		}
+
+		coarse->execute();
+		executeAll(coarseBCs);
+
+		for (unsigned int i(0); i < interfaces.size(); ++i)
+		{
+			Interface & itf(interfaces[i]);
+			itf.interpolation->compute();
+			
+			itf.fillBefore->compute();
+			fine[i]->execute();
+			executeAll(fineBCs[i]);
+
+			itf.fillMiddle->compute();
+			fine[i]->execute();
+			executeAll(fineBCs[i]);
+
+			itf.restriction->compute();
+			// the coarse nodes used by the interpolation can be covered by the fine 
+			// block, the values for the next step are taken after the restriction
+			itf.interpolation->compute();
+			for (unsigned int j(0); j < itf.fAfter.size(); ++j)
+				acl::swapBuffers(*itf.fBefore[j], *itf.fAfter[j]);
+		}
+	}
+
+	unsigned int LBGKMultiBlock::getNUpdates() const
+	{
+		unsigned int n(productOfElements(coarse->getVelocity()->getInternalBlock().getSize()));
+		for (unsigned int i(0); i < fine.size(); ++i)
+			n += 2 * productOfElements(fine[i]->getVelocity()->getInternalBlock().getSize());
+		return n;
+	}
+
+} //asl
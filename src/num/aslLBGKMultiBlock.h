@@ -0,0 +1,152 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef ASLLBGKMULTIBLOCK_H
+#define ASLLBGKMULTIBLOCK_H
+
+#include "aslLBGK.h"
+
+namespace asl
+{
+	class DistanceFunction;
+	typedef std::shared_ptr<DistanceFunction> SPDistanceFunction;
+
+	/// Lattice Boltzmann method on a coarse block with refined inner blocks
+	/**
+		 \ingroup TransportProcesses
+		 \ingroup NumMethods		 
+
+		 The refined blocks have twice the resolution of the coarse one and 
+		 make two time steps per coarse step (convective scaling: the 
+		 viscosity in lattice units is doubled). A refinement box is given 
+		 by the first and the last coarse cells it covers, the fine nodes are 
+		 placed at a quarter of the coarse step around the coarse ones.
+
+		 Within execute():
+		 - the coarse step is made;
+		 - the ghost nodes of the fine blocks are interpolated from the 
+		   coarse distribution functions before and after the coarse step 
+		   (linearly in space and time), the non-equilibrium parts are rescaled 
+		   by \f$ (\tau_f-1)/(2(\tau_c-1)) \f$;
+		 - two fine steps are made;
+		 - the coarse nodes covered by the fine blocks are restricted from the 
+		   fine ones with the inverse rescaling, the ghost values of the next 
+		   step are interpolated after the restriction.
+
+		 The boundary conditions of each block are given by addCoarseBC() and 
+		 addFineBC(), they are executed after each step of their block. The 
+		 relaxation times of both levels should differ from 1. The refinement 
+		 boxes may not overlap and should stay at least one cell apart 
+		 from the borders of the coarse block.
+	*/
+	class LBGKMultiBlock: public NumMethod
+	{
+		public:
+			typedef LBGK::Param Param;
+		private:
+			/// connection of a fine block with the coarse one
+			struct Interface
+			{
+				/// fine ghost nodes
+				acl::VectorOfElementsData ghosts;
+				/// coarse neighbours of the fine ghost nodes and their weights
+				std::vector<acl::VectorOfElementsData> coarseNeighbours;
+				acl::VectorOfElementsData weights;
+				/// interpolated values before and after the coarse step
+				acl::VectorOfElementsData fBefore;
+				acl::VectorOfElementsData fAfter;
+				/// coarse nodes covered by the fine block and their fine children
+				acl::VectorOfElementsData covered;
+				std::vector<acl::VectorOfElementsData> children;
+				acl::SPKernel interpolation;
+				acl::SPKernel fillBefore;
+				acl::SPKernel fillMiddle;
+				acl::SPKernel restriction;
+			};
+
+			SPLBGK coarse;
+			std::vector<SPLBGK> fine;
+			std::vector<AVec<int> > boxes0;
+			std::vector<AVec<int> > boxesE;
+			std::vector<Interface> interfaces;
+			std::vector<SPNumMethod> coarseBCs;
+			std::vector<std::vector<SPNumMethod> > fineBCs;
+
+			Param viscosity;
+			const VectorTemplate* vectorTemplate;
+			bool flagComputeVelocity;
+			bool flagComputeRho;
+			/// whether the coarse values before the first step are stored
+			bool flagStarted;
+			/// whether init() has been called, no blocks can be added afterwards
+			bool flagInitialized;
+			acl::CommandQueue queue;
+
+			void buildInterface(unsigned int i);
+		public:
+			LBGKMultiBlock(Block b, Param nu, const VectorTemplate* vT, 
+			               bool compVel=true, bool compRho=true, 
+			               acl::CommandQueue queue = acl::hardware.defaultQueue);
+			/// Adds refined block covering coarse cells from \p a0 to \p aE (internal indices)
+			/// and returns its number. Should be called before init()
+			unsigned int addRefinementBox(AVec<int> a0, AVec<int> aE);
+			/// Adds refined block covering the band \f$ |df| < width \f$
+			/// (bounding box of the band with one cell margin); the band should stay 
+			/// clear of the borders, the box is cut one cell apart from them
+			unsigned int addRefinementBand(SPDistanceFunction df, double width);
+			/// Adds boundary condition of the coarse block
+			void addCoarseBC(SPNumMethod bc);
+			/// Adds boundary condition of the fine block \p i
+			void addFineBC(unsigned int i, SPNumMethod bc);
+			virtual void init();
+			virtual void execute();
+
+			inline SPLBGK getCoarse();
+			inline SPLBGK getFine(unsigned int i);
+			inline unsigned int getNFine() const;
+			/// returns number of cell updates within a coarse step
+			unsigned int getNUpdates() const;
+	};
+
+	typedef std::shared_ptr<LBGKMultiBlock> SPLBGKMultiBlock;	
+
+// ------------------------- Implementation ------------------------
+
+	inline SPLBGK LBGKMultiBlock::getCoarse()
+	{
+		return coarse;
+	}
+
+	inline SPLBGK LBGKMultiBlock::getFine(unsigned int i)
+	{
+		return fine[i];
+	}
+
+	inline unsigned int LBGKMultiBlock::getNFine() const
+	{
+		return fine.size();
+	}
+		
+} // asl
+#endif // ASLLBGKMULTIBLOCK_H
@@ -0,0 +1,224 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include "aslLBGKSparse.h"
+#include "aslGenerators.h"
+#include <aslGeomInc.h>
+#include <acl/aclGenerators.h>
+#include <acl/acl.h>
+#include <acl/DataTypes/aclArray.h>
+#include <acl/Kernels/aclKernel.h>
+#include <acl/Kernels/aclKernelConfigurationTemplates.h>
+#include <acl/aclMath/aclVectorOfElements.h>
+#include <data/aslDataWithGhostNodes.h>
+#include <math/aslTemplates.h>
+
+namespace asl
+{
+
+	LBGKSparse::LBGKSparse(SPAbstractDataWithGhostNodes map_,
+	                       Param nu, 
+	                       const VectorTemplate* vT,
+	                       bool compVel, bool compRho,
+	                       acl::CommandQueue queue):
+		LBGK(acl::KERNEL_BASIC, nu, vT, compVel, compRho),
+		map(map_),
+		nNodes(0)
+	{
+		if (map->getGhostBorder() != 1)
+			errorMessage("LBGKSparse - the map should have one ghost node");
+		periodic.assign(nD(map->getInternalBlock()), false);
+		createData(map->getInternalBlock(), queue, viscosity[0]->getTypeID());
+	}
+
+	LBGKSparse::LBGKSparse(const Block & b,
+	                       SPDistanceFunction df,
+	                       Param nu, 
+	                       const VectorTemplate* vT,
+	                       bool compVel, bool compRho,
+	                       acl::CommandQueue queue):
+		LBGKSparse(generateDataContainer_SP(b, df, 1u, nu[0]->getTypeID()), 
+		           nu, vT, compVel, compRho, queue)
+	{
+	}
+
+	void LBGKSparse::createData(Block b, acl::CommandQueue queue, acl::TypeID type)
+	{
+		if (flagInPlaceStreaming)
+			errorMessage("LBGKSparse - the in-place streaming is not supported");
+
+		Block ext(offset(b));
+		const AVec<int> & size(ext.getSize());
+		const AVec<int> & strides(ext.c2iTransformVector);
+		unsigned int nd(nD(b));
+		unsigned int length(productOfElements(size));
+		if (map->getEContainer()[0]->getSize() != length)
+			errorMessage("LBGKSparse - the map does not match the block");
+
+		// classification of the nodes is computed on the device
+		acl::VectorOfElements mask(acl::generateVEData(length, acl::TYPE_INT, 1u, queue));
+		acl::initData(mask, select(acl::generateVEConstant(1), 
+		                           map->getEContainer() > 0., 
+		                           acl::TYPE_INT));
+		vector<cl_int> isFluid;
+		acl::copy(mask[0], isFluid);
+
+		// the ghost nodes are never fluid, the borders of the block act as walls
+		// unless they are periodic
+		vector<cl_uint> nodesH;
+		vector<int> compact(length, -1);
+		for (unsigned int p(0); p < length; ++p)
+		{
+			bool fluid(isFluid[p] != 0);
+			for (unsigned int d(0); d < nd; ++d)
+			{
+				int c((p / strides[d]) % size[d]);
+				fluid = fluid && c > 0 && c < size[d] - 1;
+			}
+			if (fluid)
+			{
+				compact[p] = nodesH.size();
+				nodesH.push_back(p);
+			}
+		}
+		nNodes = nodesH.size();
+		if (nNodes == 0)
+			errorMessage("LBGKSparse - the map contains no fluid nodes");
+
+		nodes.reset(new acl::Array<cl_uint>(nNodes, queue));
+		acl::copy(nodesH, nodes);
+
+		// f_i of a node comes from the node shifted against a_i or, 
+		// if that one is solid, from the opposite direction of the node itself
+		unsigned int nv(vectorTemplate->vectors.size());
+		neighbours.resize(nv);
+		vector<cl_uint> neighboursH(nNodes);
+		for (unsigned int i(0); i < nv; ++i)
+		{
+			unsigned int iInv(vectorTemplate->invertVectors[i]);
+			if (iInv == i)
+			{
+				neighbours[i].reset();
+				continue;
+			}
+			for (unsigned int k(0); k < nNodes; ++k)
+			{
+				int p(0);
+				for (unsigned int d(0); d < nd; ++d)
+				{
+					int c((nodesH[k] / strides[d]) % size[d] - vectorTemplate->vectors[i][d]);
+					// the ghost node of a periodic direction is the internal node of the opposite border
+					if (periodic[d] && c == 0)
+						c = size[d] - 2;
+					else if (periodic[d] && c == size[d] - 1)
+						c = 1;
+					p += c * strides[d];
+				}
+				int source(compact[p]);
+				neighboursH[k] = source < 0 ? iInv * nNodes + k : i * nNodes + source;
+			}
+			neighbours[i].reset(new acl::Array<cl_uint>(nNodes, queue));
+			acl::copy(neighboursH, neighbours[i]);
+		}
+
+		if (flagHalfPrecisionStorage)
+		{
+			fFlat = acl::generateVEDataHalf(nv * nNodes, 1u, queue)[0];
+			fFlatNew = acl::generateVEDataHalf(nv * nNodes, 1u, queue)[0];
+		}
+		else
+		{
+			fFlat = acl::generateVEData(nv * nNodes, type, 1u, queue)[0];
+			fFlatNew = acl::generateVEData(nv * nNodes, type, 1u, queue)[0];
+		}
+
+		acl::VectorOfElements container(nv);
+		for (unsigned int i(0); i < nv; ++i)
+			container[i] = acl::generateSubElement(fFlat, nNodes, i * nNodes);
+		AVec<int> nodesSize(1, nNodes);
+		f = generateDataContainer_SP(Block(nodesSize), container, 0u);
+
+		if (!v) 
+			v = generateDataContainerACL_SP(b, type, nd, 1u, queue);
+		if (!rho)
+			rho = generateDataContainerACL_SP(b, type, 1u, 1u, queue);
+	}
+
+	acl::VectorOfElements LBGKSparse::getFSource()
+	{
+		using namespace acl::elementOperators;
+		unsigned int nv(vectorTemplate->vectors.size());
+		acl::VectorOfElements res(nv);
+		for (unsigned int i(0); i < nv; ++i)
+			res[i] = neighbours[i] ? excerpt(fFlat, neighbours[i]) : f->getEContainer()[i];
+		return res;
+	}
+
+	acl::VectorOfElements LBGKSparse::getFDestination()
+	{
+		unsigned int nv(vectorTemplate->vectors.size());
+		acl::VectorOfElements res(nv);
+		for (unsigned int i(0); i < nv; ++i)
+			res[i] = acl::generateSubElement(fFlatNew, nNodes, i * nNodes);
+		return res;
+	}
+
+	acl::VectorOfElements LBGKSparse::getNodeElements(DataD field)
+	{
+		using namespace acl::elementOperators;
+		acl::VectorOfElements container(field->getEContainer());
+		acl::VectorOfElements res(container.size());
+		for (unsigned int i(0); i < container.size(); ++i)
+			res[i] = excerpt(container[i], nodes);
+		return res;
+	}
+
+	void LBGKSparse::setPeriodic(unsigned int d, bool flag)
+	{
+		if (d >= periodic.size())
+			errorMessage("LBGKSparse::setPeriodic - wrong direction");
+		if (periodic[d] == flag)
+			return;
+		periodic[d] = flag;
+		createData(v->getInternalBlock(), 
+		           v->getEContainer()[0]->getQueue(), 
+		           viscosity[0]->getTypeID());
+	}
+
+	void LBGKSparse::init0()
+	{
+		LBGK::init0();
+		kernel->setLabel("LBGKSparse collision");
+	}
+
+	void LBGKSparse::preProcessing()
+	{
+	}
+
+	void LBGKSparse::postProcessing()
+	{
+		acl::swapBuffers(*fFlat, *fFlatNew);
+	}
+
+} //asl
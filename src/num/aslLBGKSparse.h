@@ -0,0 +1,107 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef ASLLBGKSPARSE_H
+#define ASLLBGKSPARSE_H
+
+#include "aslLBGK.h"
+
+namespace asl
+{
+	class DistanceFunction;
+	typedef std::shared_ptr<DistanceFunction> SPDistanceFunction;
+
+	/// Lattice Boltzmann method storing only the fluid nodes
+	/**
+		 \ingroup TransportProcesses
+		 \ingroup NumMethods		 
+
+		 The fluid nodes (\f$ map > 0 \f$ within the internal block) are 
+		 enumerated at the construction. The distribution functions are stored 
+		 only for them in a compact array, the streaming reads the neighbours 
+		 through a precomputed table. The table folds in the no-slip condition 
+		 (halfway bounce-back) on the solid nodes and on the borders of the block,
+		 so no separate BC is needed for them. The memory and the computation time 
+		 scale with the number of fluid nodes; suited for porous and highly 
+		 occluded geometries.
+
+		 getVelocity() and getRho() are dense fields of the block, the solid 
+		 nodes keep their values. getF() is a one-dimensional field of the fluid
+		 nodes, so LBGKUtilities can initialize it; the boundary conditions 
+		 of the dense LBGK can not be applied to it. There are no inlets and 
+		 outlets: the flow through a sample is driven by a body force 
+		 (setForce()) with the borders across the flow made periodic 
+		 (setPeriodic()).
+	*/
+	class LBGKSparse: public LBGK
+	{
+		protected:
+			SPAbstractDataWithGhostNodes map;
+			/// distribution functions of all directions, one after another
+			acl::ElementData fFlat;
+			/// target of the collision, swapped with \p fFlat after the step
+			acl::ElementData fFlatNew;
+			/// positions of the fluid nodes in the fields of the block
+			acl::Element nodes;
+			/// for each direction the positions in \p fFlat the nodes stream from
+			acl::VectorOfElements neighbours;
+			unsigned int nNodes;
+			/// directions in which the opposite borders of the block are connected
+			std::vector<bool> periodic;
+
+			virtual void createData(Block b, acl::CommandQueue queue, acl::TypeID type);
+			virtual acl::VectorOfElements getFSource();
+			virtual acl::VectorOfElements getFDestination();
+			virtual acl::VectorOfElements getNodeElements(DataD field);
+			virtual void preProcessing();
+			virtual void postProcessing();
+			virtual void init0();
+
+		public:
+			/// \p map defines the fluid nodes, it should have one ghost node
+			LBGKSparse(SPAbstractDataWithGhostNodes map, Param nu, const VectorTemplate* vT, 
+			           bool compVel=true, bool compRho=true, 
+			           acl::CommandQueue queue = acl::hardware.defaultQueue);
+			/// \p df defines the fluid nodes of the block \p b
+			LBGKSparse(const Block & b, SPDistanceFunction df, Param nu, const VectorTemplate* vT, 
+			           bool compVel=true, bool compRho=true, 
+			           acl::CommandQueue queue = acl::hardware.defaultQueue);
+			/// Connects the opposite borders of the block in the direction \p d 
+			/// instead of the walls; should be called before init()
+			void setPeriodic(unsigned int d, bool flag = true);
+			/// returns number of the fluid nodes
+			inline unsigned int getNNodes() const;
+	};
+
+	typedef std::shared_ptr<LBGKSparse> SPLBGKSparse;	
+
+// ------------------------- Implementation ------------------------
+
+	inline unsigned int LBGKSparse::getNNodes() const
+	{
+		return nNodes;
+	}
+		
+} // asl
+#endif // ASLLBGKSPARSE_H
@@ -221,7 +221,7 @@ namespace asl
 
 	void LevelSet::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 		swapBuffers(distanceField->getDContainer(),
 		            distanceFieldInternalData->getDContainer());
 	}
@@ -25,6 +25,7 @@
 #define ASLNUMMETHOD_H
 
 #include <acl/aclStdIncludes.h>
+#include <acl/Kernels/aclParallelBuild.h>
 #include <memory>
 
 namespace asl
@@ -44,6 +45,7 @@ namespace asl
 	typedef std::shared_ptr<NumMethod> SPNumMethod;
 
 
+	/// Initializes all numerical methods of \p v, the kernels are built concurrently
 	template <class T> inline void initAll(std::vector<T*> &v);
 	template <class T> inline void initAll(std::vector<std::shared_ptr<T> > & v);
 	
@@ -66,14 +68,18 @@ namespace asl
 
 	template <class T> void initAll(std::vector<T*> &v)
 	{
+		acl::ParallelBuild parallelBuild;
 		for (unsigned int i(0); i < v.size(); ++i)
 			v[i]->init();
+		parallelBuild.build();
 	}
 
 	template <class T> void initAll(std::vector<std::shared_ptr<T> > &v)
 	{
+		acl::ParallelBuild parallelBuild;
 		for (unsigned int i(0); i < v.size(); ++i)
 			v[i]->init();
+		parallelBuild.build();
 	}
 
 	
@@ -0,0 +1,79 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "aslNumMethodsFusion.h"
+#include "aslSingleKernelNM.h"
+#include <acl/Kernels/aclKernel.h>
+#include <acl/Kernels/aclKernelFusion.h>
+
+using namespace std;
+
+namespace asl
+{
+
+	NumMethodsFusion::NumMethodsFusion()
+	{
+	}
+
+	void NumMethodsFusion::init(bool buildKernels)
+	{
+		steps.clear();
+		for (unsigned int i(0); i < nmList.size(); ++i)
+		{
+			if (buildKernels)
+				nmList[i]->init0();
+			// the processing of a fused method would be reordered 
+			// against the kernels of its neighbours
+			if (nmList[i]->hasProcessing())
+			{
+				nmList[i]->kernel->setup();
+				steps.push_back(make_pair(nmList[i], acl::SPKernelFusion()));
+				continue;
+			}
+			if (steps.empty() || !steps.back().second)
+				steps.push_back(make_pair(SPSingleKernelNM(), 
+				                          acl::SPKernelFusion(new acl::KernelFusion)));
+			steps.back().second->addKernel(nmList[i]->kernel);
+		}
+		for (unsigned int i(0); i < steps.size(); ++i)
+			if (steps[i].second)
+				steps[i].second->setup();
+	}
+
+	void NumMethodsFusion::execute()
+	{
+		for (unsigned int i(0); i < steps.size(); ++i)
+		{
+			if (steps[i].first)
+				steps[i].first->execute();
+			else
+				steps[i].second->computeAsync();
+		}
+	}
+
+	void NumMethodsFusion::addNM(const vector<SPSingleKernelNM> & nm)
+	{
+		nmList.insert(nmList.end(), nm.begin(), nm.end());
+	}
+
+} // asl
@@ -0,0 +1,81 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ASLNUMMETHODSFUSION_H
+#define ASLNUMMETHODSFUSION_H
+
+#include <memory>
+#include <vector>
+#include <utility>
+
+namespace acl
+{
+	class KernelFusion;
+	typedef std::shared_ptr<KernelFusion> SPKernelFusion;
+}
+
+namespace asl
+{
+	class SingleKernelNM;
+	typedef std::shared_ptr<SingleKernelNM> SPSingleKernelNM;
+	/// Fuses consecutive methods over the same block into common kernels
+	/**
+		 \ingroup Numerics
+		 A typical time step, e.g. LBGK followed by boundary conditions and 
+		 a time continuation, is executed by as few kernels as the data 
+		 dependencies allow, see acl::KernelFusion. The methods are
+		 executed in the order they are added. The methods with host-side 
+		 pre- or postprocessing (SingleKernelNM::hasProcessing()), e.g. 
+		 the buffer swaps of FDAdvectionDiffusion, are executed separately,
+		 so their kernels see the state the sequential execution would give.
+	*/
+	class NumMethodsFusion
+	{
+		private:
+			std::vector<SPSingleKernelNM> nmList;
+			/// sequence of the execution: either a method executed separately
+			/// or a fusion of the consecutive methods without processing
+			std::vector<std::pair<SPSingleKernelNM, acl::SPKernelFusion> > steps;
+		public:
+			NumMethodsFusion();
+			
+			/// Executes the numerical procedures
+			void execute();
+			/// Builds the necesery internal data and kernels
+			/** \param buildKernels defines whether to call init0 or not*/
+			void init(bool buildKernels);
+			
+			inline void addNM(SPSingleKernelNM nm);
+			void addNM(const std::vector<SPSingleKernelNM> & nm);
+	};
+
+//---------------------------- Implementation ---------------------------
+
+	inline void NumMethodsFusion::addNM(SPSingleKernelNM nm)
+	{
+		nmList.push_back(nm);
+	}
+	
+}	//asl
+
+#endif //ASLNUMMETHODSFUSION_H
@@ -24,6 +24,7 @@
 #include "aslNumMethodsMerger.h"
 #include "aslSingleKernelNM.h"
 #include <acl/Kernels/aclKernelMerger.h>
+#include <acl/Kernels/aclStepRecorder.h>
 
 using namespace std;
 
@@ -47,10 +48,12 @@ namespace asl
 
 	void NumMethodsMerger::execute()
 	{
-		km->compute();
-		for(unsigned int i(0); i<nmList.size();++i){
-			nmList[i]->postProcessing();
-		}
+		km->computeAsync();
+		acl::StepRecorder::hostAction([this]()
+		{
+			for(unsigned int i(0); i<nmList.size();++i)
+				nmList[i]->postProcessing();
+		});
 	}
 
 	void NumMethodsMerger::addNM(const vector<SPSingleKernelNM> &nm)
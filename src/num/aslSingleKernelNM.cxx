@@ -25,7 +25,13 @@
 #include <data/aslDataWithGhostNodes.h>
 #include <acl/aclMath/aclVectorOfElements.h>
 #include <acl/Kernels/aclKernel.h>
+#include <acl/Kernels/aclStepRecorder.h>
 #include <acl/acl.h>
+#include <typeinfo>
+#ifdef __GNUG__
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
 
 
 namespace asl
@@ -39,17 +45,56 @@ namespace asl
 	{
 	}
 
+	/// Returns the class name of \p nm without namespace, used as a label of the kernel
+	std::string className(const NumMethod & nm)
+	{
+		std::string name(typeid(nm).name());
+#ifdef __GNUG__
+		int status(0);
+		char * demangled(abi::__cxa_demangle(name.c_str(), NULL, NULL, &status));
+		if (status == 0)
+			name = demangled;
+		free(demangled);
+#endif
+		if (name.compare(0, 5, "asl::") == 0)
+			name.erase(0, 5);
+		return name;
+	}
+
 	void SingleKernelNM::init()
 	{
+		// init0() can replace the label
+		kernel->setLabel(className(*this));
 		init0();
 		kernel->setup();
 	}
 
+	void SingleKernelNM::setQueue(const acl::CommandQueue & queue)
+	{
+		kernel->setQueue(queue);
+	}
+
+	void SingleKernelNM::setTiling(SPAbstractDataWithGhostNodes field,
+	                               const std::vector<unsigned int> & tileSize)
+	{
+		const AVec<int> & size(field->getBlock().getSize());
+		kernel->setTiling(std::vector<unsigned int>(&size[0], &size[0] + size.getSize()), tileSize);
+	}
+
+	void SingleKernelNM::setMarching(SPAbstractDataWithGhostNodes field,
+	                                 const std::vector<unsigned int> & tileSize)
+	{
+		setTiling(field, tileSize);
+		kernel->setMarching();
+	}
+
 	void SingleKernelNM::execute()
 	{
-		preProcessing();
-		kernel->compute();
-		postProcessing();
+		// the host-side parts depend on the state and are repeated 
+		// by each replay of a recorded step, see acl::StepRecorder
+		acl::StepRecorder::hostAction([this](){preProcessing();});
+		kernel->computeAsync();
+		acl::StepRecorder::hostAction([this](){postProcessing();});
 	}
 
 	void SingleKernelNM::preProcessing()
@@ -60,6 +105,11 @@ namespace asl
 	{
 	}
 
+	bool SingleKernelNM::hasProcessing() const
+	{
+		return false;
+	}
+
 	SingleKernelMapNM::SingleKernelMapNM(const acl::KernelConfiguration & kernelCongig):
 		SingleKernelNM(kernelCongig)
 	{
@@ -26,8 +26,14 @@
 
 #include "aslNumMethod.h"
 
+namespace cl
+{
+	class CommandQueue;
+}
+
 namespace acl
 {
+	typedef std::shared_ptr<cl::CommandQueue> CommandQueue;
 	class ExpressionContainer;
 	class Kernel;
 	class KernelConfiguration;
@@ -47,10 +53,13 @@ namespace asl
 	{
 		protected: 
 			acl::SPKernel kernel;
-			/// the function executed before kernel->compute()
+			/// the function executed before kernel->computeAsync()
 			virtual void preProcessing();
-			/// the function executed after kernel->compute()
+			/// the function executed after kernel->computeAsync()
 			virtual void postProcessing();
+			/// returns true if preProcessing() or postProcessing() do something;
+			/// such methods are not fused with others, see NumMethodsFusion
+			virtual bool hasProcessing() const;
 			/// full initialisation but without kernel->setup()
 			virtual void init0()=0;
 
@@ -59,9 +68,25 @@ namespace asl
 			virtual void execute();
 			/// Builds the necesery internal data and kernels
 			virtual void init();
+			/// Sets the queue the kernels are launched on, see acl::Kernel::setQueue().
+			/// Independent methods can run concurrently on different queues;
+			/// dependencies through common data are resolved by events.
+			virtual void setQueue(const acl::CommandQueue & queue);
+			/// Enables tiled execution of the stencil reads, see acl::StencilTiling.
+			/// The grid of the kernel is the one of \p field including the ghost nodes;
+			/// empty \p tileSize selects the default tile. Should be called before init()
+			void setTiling(SPAbstractDataWithGhostNodes field,
+			               const std::vector<unsigned int> & tileSize = std::vector<unsigned int>());
+			/// Enables the marching execution (acl::KernelConfiguration::marching): 
+			/// each work-item owns a column of the grid of \p field and marches along 
+			/// its first dimension keeping the stencil planes in registers. 
+			/// Should be called before init()
+			void setMarching(SPAbstractDataWithGhostNodes field,
+			                 const std::vector<unsigned int> & tileSize = std::vector<unsigned int>());
 			virtual ~SingleKernelNM();
 
 			friend class NumMethodsMerger;
+			friend class NumMethodsFusion;
 	};
 
 	class SingleKernelMapNM:public SingleKernelNM
@@ -0,0 +1,414 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+
+#include "aslTemporalBlocking.h"
+#include "aslLBGK.h"
+#include "aslLBGKSparse.h"
+#include "aslFDAdvectionDiffusion.h"
+#include "aslGenerators.h"
+#include <acl/aclGenerators.h>
+#include <acl/acl.h>
+#include <acl/DataTypes/aclArray.h>
+#include <acl/Kernels/aclKernel.h>
+#include <acl/Kernels/aclStepRecorder.h>
+#include <acl/aclMath/aclVectorOfElements.h>
+#include <data/aslDataWithGhostNodes.h>
+#include <algorithm>
+
+namespace asl
+{
+
+	TemporalBlocking::TemporalBlocking(const Block & b, 
+	                                   TileGenerator gen, 
+	                                   unsigned int k, 
+	                                   const AVec<int> & tileSize_):
+		block(b),
+		generator(gen),
+		nSteps(k),
+		tileSize(tileSize_)
+	{
+		if (nSteps < 1)
+			errorMessage("TemporalBlocking - the number of steps should be positive");
+		if (nD(tileSize) != nD(block))
+			errorMessage("TemporalBlocking - dimensions of the tile do not match the block");
+		for (unsigned int d(0); d < nD(tileSize); ++d)
+			if (tileSize[d] < 1)
+				errorMessage("TemporalBlocking - the tile size should be positive");
+	}
+
+	/// allocates buffers of the same types and sizes as \p a, 
+	/// the half precision storage included
+	static acl::VectorOfElementsData cloneStorage(const acl::VectorOfElementsData & a)
+	{
+		acl::VectorOfElementsData res(a.size());
+		for (unsigned int i(0); i < a.size(); ++i)
+		{
+			if (a[i]->getElementSize() < acl::TYPE_SIZE[a[i]->getTypeID()])
+				res[i] = acl::generateVEDataHalf(a[i]->getSize(), 1u, a[i]->getQueue())[0];
+			else
+				res[i] = acl::generateElementArray(a[i]->getTypeID(), a[i]->getSize(), a[i]->getQueue());
+		}
+		return res;
+	}
+
+	static void checkField(TemporalBlocking::Field f, const Block & block)
+	{
+		if (f->getGhostBorder() != 1)
+			errorMessage("TemporalBlocking::addField - the field should have one ghost node");
+		if (f->getInternalBlock().getSize() != block.getSize())
+			errorMessage("TemporalBlocking::addField - the field does not match the block");
+	}
+
+	void TemporalBlocking::addField(Field f, bool in, bool out)
+	{
+		checkField(f, block);
+		if (in && out)
+		{
+			SPDataWithGhostNodesACLData fD(dynamic_pointer_cast<DataWithGhostNodesACLData>(f));
+			if (!fD)
+				errorMessage("TemporalBlocking::addField - the second copy of the field can not be allocated");
+			acl::VectorOfElementsData sNew(cloneStorage(fD->getDContainer()));
+			SPDataWithGhostNodesACLData fNew(new DataWithGhostNodesACLData(fD->getInternalBlock(), 1));
+			fNew->setContainer(sNew);
+			addField(f, fNew, fD->getDContainer(), sNew);
+			return;
+		}
+		fields.push_back(f);
+		fieldsNew.push_back(Field());
+		storage.push_back(acl::VectorOfElementsData());
+		storageNew.push_back(acl::VectorOfElementsData());
+		fieldsIn.push_back(in);
+		fieldsOut.push_back(out);
+	}
+
+	void TemporalBlocking::addField(Field f, 
+	                                Field fNew, 
+	                                const acl::VectorOfElementsData & s, 
+	                                const acl::VectorOfElementsData & sNew)
+	{
+		checkField(f, block);
+		checkField(fNew, block);
+		fields.push_back(f);
+		fieldsNew.push_back(fNew);
+		storage.push_back(s);
+		storageNew.push_back(sNew);
+		fieldsIn.push_back(true);
+		fieldsOut.push_back(true);
+	}
+
+	void TemporalBlocking::buildTile(const AVec<int> & c0, const AVec<int> & cE)
+	{
+		using namespace acl::elementOperators;
+		unsigned int nd(nD(block));
+		const AVec<int> & size(block.getSize());
+		int halo(nSteps - 1);
+
+		// the tile is clipped by the global block, its ghost nodes are 
+		// the global ones there and the boundary conditions are applied
+		AVec<int> s0(nd);
+		AVec<int> sE(nd);
+		std::vector<SlicesNames> sides;
+		for (unsigned int d(0); d < nd; ++d)
+		{
+			s0[d] = std::max(c0[d] - halo, 0);
+			sE[d] = std::min(cE[d] + halo, size[d] - 1);
+			if (s0[d] == 0)
+				sides.push_back(SlicesNames(2 * d));
+			if (sE[d] == size[d] - 1)
+				sides.push_back(SlicesNames(2 * d + 1));
+		}
+		AVec<int> shape(sE - s0 + AVec<int>(nd, 1));
+
+		TileData td;
+		td.problem = problems.size();
+		for (unsigned int i(0); i < problemKeys.size(); ++i)
+			if (problemKeys[i].first == shape && problemKeys[i].second == sides)
+				td.problem = i;
+		if (td.problem == problems.size())
+		{
+			Block tileBlock(shape, block.dx, block.position + block.dx * AVec<>(s0));
+			problems.push_back(generator(tileBlock, sides));
+			problemKeys.push_back(make_pair(shape, sides));
+			if (problems.back().fields.size() != fields.size())
+				errorMessage("TemporalBlocking - the tile fields do not match the global ones");
+		}
+		Tile & tile(problems[td.problem]);
+
+		Block extT(offset(Block(shape, block.dx)));
+		Block extG(offset(block));
+		const AVec<int> & sizeT(extT.getSize());
+		const AVec<int> & stridesT(extT.c2iTransformVector);
+		const AVec<int> & stridesG(extG.c2iTransformVector);
+		unsigned int lengthT(productOfElements(sizeT));
+		vector<cl_int> nodesTileH(lengthT);
+		vector<cl_int> nodesGlobalH(lengthT);
+		vector<cl_int> coreTileH;
+		vector<cl_int> coreGlobalH;
+		for (unsigned int p(0); p < lengthT; ++p)
+		{
+			bool core(true);
+			int pG(0);
+			for (unsigned int d(0); d < nd; ++d)
+			{
+				int e((p / stridesT[d]) % sizeT[d]);
+				int g(e - 1 + s0[d]);
+				// the ghost nodes of the global block belong to the border tiles
+				core = core && (g >= c0[d] || (c0[d] == 0 && g == -1)) && 
+				               (g <= cE[d] || (cE[d] == size[d] - 1 && g == size[d]));
+				pG += (g + 1) * stridesG[d];
+			}
+			nodesTileH[p] = p;
+			nodesGlobalH[p] = pG;
+			if (core)
+			{
+				coreTileH.push_back(p);
+				coreGlobalH.push_back(pG);
+			}
+		}
+
+		acl::CommandQueue queue(fields[0]->getEContainer()[0]->getQueue());
+		acl::copy(acl::generateVEData<cl_int>(lengthT, 1u, queue), td.nodesTile);
+		acl::copy(acl::generateVEData<cl_int>(lengthT, 1u, queue), td.nodesGlobal);
+		acl::copy(acl::generateVEData<cl_int>(coreTileH.size(), 1u, queue), td.coreTile);
+		acl::copy(acl::generateVEData<cl_int>(coreGlobalH.size(), 1u, queue), td.coreGlobal);
+		acl::copy(nodesTileH, td.nodesTile[0]);
+		acl::copy(nodesGlobalH, td.nodesGlobal[0]);
+		acl::copy(coreTileH, td.coreTile[0]);
+		acl::copy(coreGlobalH, td.coreGlobal[0]);
+
+		td.copyIn.reset(new acl::Kernel(acl::KERNEL_BASIC));
+		td.copyIn->setLabel("TemporalBlocking copy in");
+		td.copyOut.reset(new acl::Kernel(acl::KERNEL_BASIC));
+		td.copyOut->setLabel("TemporalBlocking copy out");
+		for (unsigned int i(0); i < fields.size(); ++i)
+		{
+			acl::VectorOfElements fT(tile.fields[i]->getEContainer());
+			acl::VectorOfElements fG(fields[i]->getEContainer());
+			if (fieldsIn[i])
+				(*td.copyIn) << (acl::excerpt(fT, td.nodesTile) = 
+				                 acl::excerpt(fG, td.nodesGlobal));
+			// the fields which are not read by the tiles are written directly
+			if (fieldsIn[i] && fieldsOut[i])
+				(*td.copyOut) << (acl::excerpt(acl::VectorOfElements(fieldsNew[i]->getEContainer()), 
+				                               td.coreGlobal) = 
+				                  acl::excerpt(fT, td.coreTile));
+			else if (fieldsOut[i])
+				(*td.copyOut) << (acl::excerpt(fG, td.coreGlobal) = 
+				                  acl::excerpt(fT, td.coreTile));
+		}
+
+		tiles.push_back(td);
+	}
+
+	void TemporalBlocking::init()
+	{
+		if (std::find(fieldsIn.begin(), fieldsIn.end(), true) == fieldsIn.end() ||
+		    std::find(fieldsOut.begin(), fieldsOut.end(), true) == fieldsOut.end())
+			errorMessage("TemporalBlocking::init - no fields are copied to or from the tiles");
+
+		unsigned int nd(nD(block));
+		const AVec<int> & size(block.getSize());
+
+		AVec<int> nTiles(nd);
+		for (unsigned int d(0); d < nd; ++d)
+			nTiles[d] = (size[d] + tileSize[d] - 1) / tileSize[d];
+
+		tiles.clear();
+		problems.clear();
+		problemKeys.clear();
+		unsigned int n(productOfElements(nTiles));
+		for (unsigned int i(0); i < n; ++i)
+		{
+			AVec<int> c0(nd);
+			unsigned int rest(i);
+			for (int d(nd - 1); d >= 0; --d)
+			{
+				c0[d] = (rest % nTiles[d]) * tileSize[d];
+				rest /= nTiles[d];
+			}
+			AVec<int> cE(c0 + tileSize - AVec<int>(nd, 1));
+			for (unsigned int d(0); d < nd; ++d)
+				cE[d] = std::min(cE[d], size[d] - 1);
+			buildTile(c0, cE);
+		}
+
+		acl::ParallelBuild parallelBuild;
+		for (unsigned int i(0); i < problems.size(); ++i)
+			for (unsigned int j(0); j < problems[i].step.size(); ++j)
+				problems[i].step[j]->init();
+		for (unsigned int i(0); i < tiles.size(); ++i)
+		{
+			tiles[i].copyIn->setup();
+			tiles[i].copyOut->setup();
+		}
+		parallelBuild.build();
+	}
+
+	void TemporalBlocking::execute()
+	{
+		// the global fields are not changed within the pass, 
+		// the cores are collected in the second copy
+		for (unsigned int i(0); i < tiles.size(); ++i)
+		{
+			TileData & td(tiles[i]);
+			td.copyIn->computeAsync();
+			for (unsigned int j(0); j < nSteps; ++j)
+				executeAll(problems[td.problem].step);
+			td.copyOut->computeAsync();
+		}
+		acl::StepRecorder::hostAction([this]()
+		{
+			for (unsigned int i(0); i < storage.size(); ++i)
+				if (storage[i].size() > 0)
+					acl::swapBuffers(storage[i], storageNew[i]);
+		});
+	}
+
+
+	/// returns true if \p a does not depend on the node
+	static bool isUniform(const acl::VectorOfElements & a)
+	{
+		for (unsigned int i(0); i < a.size(); ++i)
+			if (a[i]->getSize() > 0)
+				return false;
+		return true;
+	}
+
+	SPTemporalBlocking generateTemporalBlocking(SPLBGK lbgk, 
+	                                            unsigned int k,
+	                                            const AVec<int> & tileSize,
+	                                            TileBCGenerator<LBGK> bc)
+	{
+		if (dynamic_pointer_cast<LBGKTurbulence>(lbgk))
+			errorMessage("generateTemporalBlocking - LBGKTurbulence is not supported");
+		if (dynamic_pointer_cast<LBGKSparse>(lbgk))
+			errorMessage("generateTemporalBlocking - LBGKSparse is not supported");
+		// the parameters are shared by all tiles, so they should not be fields
+		if (!isUniform(lbgk->getViscosityParam()))
+			errorMessage("generateTemporalBlocking - the viscosity field is not supported");
+		if (!isUniform(lbgk->getOmega()))
+			errorMessage("generateTemporalBlocking - the angular velocity field is not supported");
+
+		acl::CommandQueue queue(lbgk->getVelocity()->getEContainer()[0]->getQueue());
+		auto generator([lbgk, bc, queue](const Block & b, 
+		                                 const std::vector<SlicesNames> & sides)
+		{
+			SPLBGK nm(new LBGK(b, 
+			                   lbgk->getViscosityParam(), 
+			                   lbgk->getVectorTemplate(), 
+			                   true, true, 
+			                   queue));
+			nm->setCompressible(lbgk->getCompressible());
+			nm->setHalfPrecisionStorage(lbgk->getHalfPrecisionStorage());
+			nm->setInPlaceStreaming(lbgk->getInPlaceStreaming());
+			if (lbgk->getOmega().size() > 0)
+				nm->setOmega(lbgk->getOmega());
+
+			TemporalBlocking::Tile tile;
+			tile.fields.push_back(nm->getF());
+			tile.fields.push_back(nm->getRho());
+			tile.fields.push_back(nm->getVelocity());
+			tile.step.push_back(nm);
+			if (bc && !sides.empty())
+			{
+				std::vector<SPNumMethod> bcs(bc(nm, sides));
+				tile.step.insert(tile.step.end(), bcs.begin(), bcs.end());
+			}
+			return tile;
+		});
+
+		SPTemporalBlocking res(new TemporalBlocking(lbgk->getVelocity()->getInternalBlock(), 
+		                                            generator, k, tileSize));
+		// the second copy of the distribution functions is a second pool
+		acl::VectorOfElementsData poolNew(cloneStorage(lbgk->getFPool()));
+		res->addField(lbgk->getF(), lbgk->getF(poolNew), lbgk->getFPool(), poolNew);
+		res->addField(lbgk->getRho(), false, true);
+		res->addField(lbgk->getVelocity(), false, true);
+		return res;
+	}
+
+
+	SPTemporalBlocking generateTemporalBlocking(SPFDAdvectionDiffusion nm, 
+	                                            unsigned int k,
+	                                            const AVec<int> & tileSize,
+	                                            TileBCGenerator<FDAdvectionDiffusion> bc)
+	{
+		if (nm->getDistributionFunction())
+			errorMessage("generateTemporalBlocking - the advection by distribution function is not supported");
+		if (nm->getElectricField())
+			errorMessage("generateTemporalBlocking - the electric field terms are not supported");
+		for (unsigned int i(0); i < nm->getData().size(); ++i)
+			if (!isUniform(nm->getDiffusionCoefficient(i)))
+				errorMessage("generateTemporalBlocking - the diffusion coefficient field is not supported");
+
+		std::vector<FDAdvectionDiffusion::Data> & c(nm->getData());
+		acl::CommandQueue queue(c[0]->getEContainer()[0]->getQueue());
+		auto generator([nm, bc, queue](const Block & b, 
+		                               const std::vector<SlicesNames> & sides)
+		{
+			std::vector<FDAdvectionDiffusion::Data> & c(nm->getData());
+			TemporalBlocking::Tile tile;
+			SPFDAdvectionDiffusion tileNM;
+			for (unsigned int i(0); i < c.size(); ++i)
+			{
+				auto cT(generateDataContainerACL_SP(b, 
+				                                    c[i]->getEContainer()[0]->getTypeID(),
+				                                    c[i]->getEContainer().size(),
+				                                    1u, queue));
+				acl::VectorOfElements dC(nm->getDiffusionCoefficient(i));
+				if (i == 0)
+					tileNM.reset(new FDAdvectionDiffusion(cT, dC, nm->getVectorTemplate()));
+				else
+					tileNM->addComponent(cT, dC);
+				tile.fields.push_back(cT);
+			}
+			if (nm->getVelocity())
+			{
+				auto vT(generateDataContainerACL_SP(b, 
+				                                    nm->getVelocity()->getEContainer()[0]->getTypeID(),
+				                                    nm->getVelocity()->getEContainer().size(),
+				                                    1u, queue));
+				tileNM->setVelocity(vT, nm->getCompressibilityCorrection());
+				tile.fields.push_back(vT);
+			}
+			tile.step.push_back(tileNM);
+			if (bc && !sides.empty())
+			{
+				std::vector<SPNumMethod> bcs(bc(tileNM, sides));
+				tile.step.insert(tile.step.end(), bcs.begin(), bcs.end());
+			}
+			return tile;
+		});
+
+		SPTemporalBlocking res(new TemporalBlocking(c[0]->getInternalBlock(), 
+		                                            generator, k, tileSize));
+		for (unsigned int i(0); i < c.size(); ++i)
+			res->addField(c[i]);
+		if (nm->getVelocity())
+			res->addField(nm->getVelocity(), true, false);
+		return res;
+	}
+
+} //asl
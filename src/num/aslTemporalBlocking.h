@@ -0,0 +1,209 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef ASLTEMPORALBLOCKING_H
+#define ASLTEMPORALBLOCKING_H
+
+#include "aslNumMethod.h"
+#include "aslBCond.h"
+#include <math/aslVectors.h>
+#include <functional>
+
+namespace acl
+{
+	class Kernel;
+	typedef std::shared_ptr<Kernel> SPKernel;
+}
+
+namespace asl
+{
+	class LBGK;
+	class FDAdvectionDiffusion;
+
+	/// Executes several time steps of a method tile by tile
+	/**
+		 \ingroup NumMethods
+
+		 The internal block is split into tiles of size \p tileSize. A tile is 
+		 extended by \p k - 1 nodes plus the ghost nodes, that is an overlapped 
+		 halo of depth \p k. The tiles of the same size and with the same sides 
+		 on the borders share one scratch problem generated by the TileGenerator,
+		 so the generated methods should not depend on the position of the block.
+		 execute() makes \p k time steps: for each tile the tile with its halo 
+		 is copied from the global fields into the scratch problem, the \p k steps 
+		 are made while it stays in the cache and the core is written into 
+		 a second copy of the global fields. The buffers of the two copies are 
+		 swapped after all tiles, so all halos are taken from the state before 
+		 the pass and no copy-back sweep is needed. The halo nodes are computed 
+		 redundantly and become invalid from outside, one layer per step. 
+		 The cores of the tiles on the borders of the block include 
+		 the ghost nodes there.
+
+		 The stencils of the method should have a radius of 1. The sides of a 
+		 tile lying on the borders of the global block are passed to the 
+		 generator: the boundary conditions of those sides are the part of 
+		 the tile step. Only boundary conditions depending on the neighbouring 
+		 nodes (e.g. constant value, no-slip) are reproduced exactly.
+
+		 The fields are given by addField() in the order of Tile::fields.
+
+		 \code
+		 auto tb(generateTemporalBlocking(lbgk, 4, makeAVec(16, 16, 16), 
+		         [](SPLBGK nm, const std::vector<SlicesNames> & sides)
+		         {
+		             return std::vector<SPNumMethod>({generateBCNoSlip(nm, sides)});
+		         }));
+		 tb->init();
+		 tb->execute();
+		 \endcode
+	*/
+	class TemporalBlocking: public NumMethod
+	{
+		public:
+			typedef SPAbstractDataWithGhostNodes Field;
+			/// problem of a tile
+			struct Tile
+			{
+				/// tile counterparts of the global fields
+				std::vector<Field> fields;
+				/// methods making one time step, e.g. the solver and its boundary conditions
+				std::vector<SPNumMethod> step;
+			};
+			/// generates the problem on the block \p b, 
+			/// \p sides are its sides lying on the borders of the global block
+			typedef std::function<Tile(const Block & b, 
+			                           const std::vector<SlicesNames> & sides)> TileGenerator;
+		private:
+			struct TileData
+			{
+				/// number of the scratch problem
+				unsigned int problem;
+				/// indices of all nodes of the tile within the tile and the global block
+				acl::VectorOfElementsData nodesTile;
+				acl::VectorOfElementsData nodesGlobal;
+				/// indices of the core nodes within the tile and the global block
+				acl::VectorOfElementsData coreTile;
+				acl::VectorOfElementsData coreGlobal;
+				acl::SPKernel copyIn;
+				acl::SPKernel copyOut;
+			};
+
+			Block block;
+			TileGenerator generator;
+			unsigned int nSteps;
+			AVec<int> tileSize;
+
+			std::vector<Field> fields;
+			/// second copies of the fields copied in both directions and 
+			/// the storages of both copies, which are swapped after each pass
+			std::vector<Field> fieldsNew;
+			std::vector<acl::VectorOfElementsData> storage;
+			std::vector<acl::VectorOfElementsData> storageNew;
+			std::vector<bool> fieldsIn;
+			std::vector<bool> fieldsOut;
+			std::vector<TileData> tiles;
+			/// scratch problems and their tile sizes and sides
+			std::vector<Tile> problems;
+			std::vector<std::pair<AVec<int>, std::vector<SlicesNames> > > problemKeys;
+
+			void buildTile(const AVec<int> & c0, const AVec<int> & cE);
+		public:
+			TemporalBlocking(const Block & b, 
+			                 TileGenerator gen, 
+			                 unsigned int k, 
+			                 const AVec<int> & tileSize);
+			/// Adds global field
+			/** 
+				 \param in the field is copied to the tiles (the state and the parameters)
+				 \param out the field is copied from the tiles (the state and the results)
+
+				 The second copy of a field copied in both directions is allocated, 
+				 such a field should be a DataWithGhostNodesACLData.
+			*/
+			void addField(Field f, bool in = true, bool out = true);
+			/// Adds global field copied in both directions with its second copy
+			/**
+				 \p f and \p fNew are views of \p s and \p sNew respectively, 
+				 e.g. the distribution functions of LBGK and their pool
+			*/
+			void addField(Field f, 
+			              Field fNew, 
+			              const acl::VectorOfElementsData & s, 
+			              const acl::VectorOfElementsData & sNew);
+			virtual void init();
+			/// Makes getNSteps() time steps
+			virtual void execute();
+			inline unsigned int getNSteps() const;
+			inline unsigned int getNTiles() const;
+	};
+
+	typedef std::shared_ptr<TemporalBlocking> SPTemporalBlocking;
+
+	/// generates the boundary conditions of a tile method on the \p sides of its block
+	template <class NM> using TileBCGenerator = 
+		std::function<std::vector<SPNumMethod>(std::shared_ptr<NM> nm, 
+		                                       const std::vector<SlicesNames> & sides)>;
+
+	/// Temporal blocking of \p lbgk
+	/**
+		 \ingroup NumMethods
+
+		 The tiles are LBGK methods with the viscosity, the angular velocity, 
+		 the vector template and the storage flags of \p lbgk; the distribution 
+		 functions, the density and the velocity of \p lbgk are updated. 
+		 \p lbgk itself is not executed. LBGKTurbulence, LBGKSparse and 
+		 the viscosity or the angular velocity given by fields are not supported.
+	*/
+	SPTemporalBlocking generateTemporalBlocking(std::shared_ptr<LBGK> lbgk, 
+	                                            unsigned int k,
+	                                            const AVec<int> & tileSize,
+	                                            TileBCGenerator<LBGK> bc);
+
+	/// Temporal blocking of \p nm
+	/**
+		 \ingroup NumMethods
+
+		 The tiles are FDAdvectionDiffusion methods with the components, 
+		 the diffusion coefficients and the velocity of \p nm; the electric 
+		 field terms and the diffusion coefficients given by fields are not supported.
+	*/
+	SPTemporalBlocking generateTemporalBlocking(std::shared_ptr<FDAdvectionDiffusion> nm, 
+	                                            unsigned int k,
+	                                            const AVec<int> & tileSize,
+	                                            TileBCGenerator<FDAdvectionDiffusion> bc);
+
+// ------------------------- Implementation ------------------------
+
+	inline unsigned int TemporalBlocking::getNSteps() const
+	{
+		return nSteps;
+	}
+
+	inline unsigned int TemporalBlocking::getNTiles() const
+	{
+		return tiles.size();
+	}
+
+} // asl
+#endif // ASLTEMPORALBLOCKING_H
@@ -127,7 +127,7 @@ namespace asl
 			
 	void TimeContinPLagrange::execute()
 	{
-		kernels[nStorages]->compute();
+		kernels[nStorages]->computeAsync();
 		nStorages++;
 		nStorages=nStorages % (order+1);
 	}	
@@ -198,7 +198,7 @@ namespace asl
 			
 	void TimeContinPLagrangeFraction::execute()
 	{
-		kernels[nStorages]->compute();
+		kernels[nStorages]->computeAsync();
 		nStorages++;
 		nStorages=nStorages % (order+1);
 	}	
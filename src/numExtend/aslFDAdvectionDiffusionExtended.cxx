@@ -118,7 +118,7 @@ namespace asl
 
 	void FDAdvectionDiffusionExtended::execute()
 	{
-		kernel->compute();
+		kernel->computeAsync();
 		for (unsigned int i(0); i < cData.size(); ++i)
 			swapBuffers(cData[i]->getDContainer(),cInternalData[i]->getDContainer());
 	}
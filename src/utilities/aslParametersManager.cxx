@@ -23,6 +23,9 @@
 #include "aslParametersManager.h"
 #include "../aslUtilities.h"
 #include "../acl/aclHardware.h"
+#include "../acl/Kernels/aclProgramCache.h"
+#include "../acl/Kernels/aclKernelTuner.h"
+#include "../acl/DataTypes/aclMemoryPool.h"
 #include "math/aslVectorsDynamicLength.h"
 #include <iostream>
 #include <fstream>
@@ -403,7 +406,13 @@ namespace asl
 			("parameters,p", value<string>(), "Path to the parameters file")
 			("generate,g", value<string>(),
 			 "Generate default parameters file, write it and exit")
-			("check,c", "Check parameters for consistency and exit");
+			("check,c", "Check parameters for consistency and exit")
+			("program-cache", value<string>(),
+			 "Directory for caching of compiled OpenCL programs")
+			("tuning-database", value<string>(),
+			 "File of the kernel auto-tuning results; enables the auto-tuning")
+			("memory-limit", value<double>(),
+			 "Maximal size of the device memory used by the simulation, MB");
 
 		positional_options_description positional;
 
@@ -501,6 +510,15 @@ namespace asl
 			acl::hardware.setDefaultQueue(vm["platform"].as<string>(),
 			                              vm["device"].as<string>());
 
+			if (vm.count("program-cache"))
+				acl::programCache.setDirectory(vm["program-cache"].as<string>());
+
+			if (vm.count("tuning-database"))
+				acl::kernelTuner.setDatabase(vm["tuning-database"].as<string>());
+
+			if (vm.count("memory-limit"))
+				acl::memoryPool.setLimit(vm["memory-limit"].as<double>() * 1048576.);
+
 			// Place it after(!) notify(vm);
 			if (vm.count("check"))
 			{
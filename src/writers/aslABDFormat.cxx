@@ -64,8 +64,9 @@ namespace asl {
 
 	ABDFileIn & operator >>(ABDFileIn & f, AbstractData &a)
 	{
-		std::shared_ptr<double> d(acl::map<double>(a.getDContainer()[0]));
 		unsigned int s(a.getDContainer()[0]->getSize());
+		// the whole content is replaced
+		std::shared_ptr<double> d(acl::map<double>(a.getDContainer()[0], 0, s, CL_MAP_WRITE_INVALIDATE_REGION));
 		f>>std::make_pair(d.get(),s);
 		return f;
 	}
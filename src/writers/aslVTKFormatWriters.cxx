@@ -66,15 +66,29 @@ namespace asl
 		{
 			// compose a long vtk vector array and then feed it below
 			vtkSmartPointer<vtkDataArray> vtkArray;
-			switch (vectorFields[i].second[0]->getTypeID()) 
+			// fields stored in half precision are converted by acl::copy()
+			if (vectorFields[i].second[0]->getElementSize() == sizeof(cl_half))
+			{
+				unsigned int n(vectorFields[i].second[0]->getSize());
+				unsigned int nc(vectorFields[i].second.size());
+				vector<vector<cl_float>> p(nc, vector<cl_float>(n));
+				for (unsigned int c(0); c < nc; ++c)
+					acl::copy(*vectorFields[i].second[c], &p[c][0]);
+				if (nc == 2)
+					vtkArray = castVTKDataArray2in3(&p[0][0], &p[1][0], n, vectorFields[i].first);
+				if (nc == 3)
+					vtkArray = castVTKDataArray(&p[2][0], &p[1][0], &p[0][0], n, vectorFields[i].first);
+			}
+			else switch (vectorFields[i].second[0]->getTypeID()) 
 			{
 				#define BOOST_TT_rep_expression(r, data, t) \
 					case acl::typeToTypeID<t>(): \
 					{ \
+						unsigned int n(vectorFields[i].second[0]->getSize()); \
 						if (vectorFields[i].second.size() == 2) \
 						{   \
-							auto p0(acl::map<t>(vectorFields[i].second[0])); \
-							auto p1(acl::map<t>(vectorFields[i].second[1])); \
+							auto p0(acl::map<t>(vectorFields[i].second[0], 0, n, CL_MAP_READ)); \
+							auto p1(acl::map<t>(vectorFields[i].second[1], 0, n, CL_MAP_READ)); \
 							vtkArray = castVTKDataArray2in3(p0.get(), \
 												            p1.get(), \
 												            vectorFields[i].second[0]->getSize(), \
@@ -82,9 +96,9 @@ namespace asl
 						}   \
 						if (vectorFields[i].second.size() == 3) \
 						{   \
-							auto p0(acl::map<t>(vectorFields[i].second[2])); \
-							auto p1(acl::map<t>(vectorFields[i].second[1])); \
-							auto p2(acl::map<t>(vectorFields[i].second[0])); \
+							auto p0(acl::map<t>(vectorFields[i].second[2], 0, n, CL_MAP_READ)); \
+							auto p1(acl::map<t>(vectorFields[i].second[1], 0, n, CL_MAP_READ)); \
+							auto p2(acl::map<t>(vectorFields[i].second[0], 0, n, CL_MAP_READ)); \
 							vtkArray = castVTKDataArray(p0.get(), \
 												        p1.get(), \
 												        p2.get(), \
@@ -35,12 +35,22 @@
 #include "acl/DataTypes/aclPrivateVariable.h"
 #include "acl/DataTypes/aclPrivateArray.h"
 #include "acl/DataTypes/aclArray.h"
+#include "acl/DataTypes/aclArrayHalf.h"
+#include "acl/aclHardware.h"
 #include "acl/DataTypes/aclSubvector.h"
 #include "acl/DataTypes/aclLocalArray.h"
 #include "acl/Operators/aclElementFor.h"
 #include "acl/Operators/aclElementIfElse.h"
 #include "acl/Operators/aclElementExcerpt.h"
 #include "acl/Kernels/aclKernel.h"
+#include "acl/Kernels/aclProgramCache.h"
+#include "acl/Kernels/aclParallelBuild.h"
+#include "acl/Kernels/aclKernelProfiler.h"
+#include "acl/Kernels/aclExpressionOptimizer.h"
+#include "acl/Kernels/aclKernelTuner.h"
+#include "acl/Kernels/aclStencilTiling.h"
+#include "acl/Kernels/aclStepRecorder.h"
+#include "acl/DataTypes/aclMemoryPool.h"
 #include "aslUtilities.h"
 #include <math.h>
 #include <initializer_list>
@@ -264,6 +274,36 @@ bool testVariable()
 	return status;		
 }
 
+bool testStableVariable()
+{
+	cout << "Test of stable Variable..." << flush;
+
+	Element vec0(new Array<cl_float> (10));
+	shared_ptr<Variable<cl_float> > a(new Variable<cl_float> (1.));
+	a->setStable();
+	
+	vector<cl_float> output(10, 1);
+
+	Kernel k;
+
+	k.addExpression(elementOperators::operatorAssignment(vec0, a));	
+	k.setup();
+
+	k.compute();
+	copy(vec0, output);
+	bool status(output[2] == 1.);
+
+	// the value is a literal, the change rebuilds the kernel
+	a->setValue(0.1);
+	k.compute();
+	copy(vec0, output);
+	status &= output[2] == 0.1f;
+	status &= k.getKernelSource().find("1.00000001e-01f") != string::npos;
+	errorMessage(status);
+
+	return status;		
+}
+
 bool testVariableReference()
 {
 	cout << "Test of VariableReference functionality..." << flush;
@@ -417,6 +457,619 @@ bool testLocalArray()
 }
 
 
+bool testComputeAsync()
+{
+	cout << "Test of asynchronous Kernel execution..." << flush;
+
+	Element vec0(new Array<cl_float>(10));
+	Element vec1(new Array<cl_float>(10));
+	Element c(new Constant<cl_float>(2.));
+
+	vector<cl_float> output(10, 0);
+
+	Kernel k0;
+	Kernel k1;
+	{
+		using namespace elementOperators;
+		k0.addExpression(operatorAssignment(vec0, c));
+		k1.addExpression(operatorAssignment(vec1, vec0 + c));
+	}
+	k0.setup();
+	k1.setup();
+
+	// k1 depends on the result of k0, no explicit synchronization
+	k0.computeAsync();
+	k1.computeAsync();
+	copy(vec1, output);
+
+	bool status(output[5] == 4);
+	errorMessage(status);
+
+	return status;
+}
+
+
+bool testProgramCache()
+{
+	cout << "Test of ProgramCache..." << flush;
+
+	Element vec0(new Array<cl_float>(10));
+	Element c(new Constant<cl_float>(3.));
+
+	vector<cl_float> output(10, 0);
+
+	Kernel k0;
+	Kernel k1;
+	{
+		using namespace elementOperators;
+		k0.addExpression(operatorAssignment(vec0, c));
+		k1.addExpression(operatorAssignment(vec0, c));
+	}
+	k0.setup();
+	unsigned int nBuilds(programCache.getNBuilds());
+	// k1 has the same source as k0 and has to reuse its program
+	k1.setup();
+	k1.compute();
+	copy(vec0, output);
+
+	bool status(programCache.getNBuilds() == nBuilds && 
+	            k0.getKernelSource() == k1.getKernelSource() &&
+	            output[7] == 3);
+	errorMessage(status);
+
+	return status;
+}
+
+
+bool testParallelBuild()
+{
+	cout << "Test of ParallelBuild..." << flush;
+
+	Element vec0(new Array<cl_float>(10));
+	Element vec1(new Array<cl_float>(10));
+	Element c(new Constant<cl_float>(5.));
+
+	vector<cl_float> output(10, 0);
+
+	Kernel k0;
+	Kernel k1;
+	{
+		using namespace elementOperators;
+		k0.addExpression(operatorAssignment(vec0, c));
+		k1.addExpression(operatorAssignment(vec1, vec0 * c));
+	}
+	ParallelBuild parallelBuild;
+	k0.setup();
+	k1.setup();
+	parallelBuild.build();
+
+	k0.compute();
+	k1.compute();
+	copy(vec1, output);
+
+	bool status(output[1] == 25);
+	errorMessage(status);
+
+	return status;
+}
+
+
+bool testArgumentsSettings()
+{
+	cout << "Test of caching of Kernel arguments..." << flush;
+
+	shared_ptr<Array<cl_float> > vec0(new Array<cl_float>(10));
+	shared_ptr<Array<cl_float> > vec1(new Array<cl_float>(10));
+	shared_ptr<Array<cl_float> > vec2(new Array<cl_float>(10));
+	shared_ptr<Variable<cl_float> > a(new Variable<cl_float>(2.));
+
+	vector<cl_float> input(10, 3);
+	vector<cl_float> output(10, 0);
+	copy(input, vec1);
+	copy(input, vec2);
+
+	Kernel k;
+	{
+		using namespace elementOperators;
+		k.addExpression(operatorAssignment(vec0, Element(a) * vec1));
+	}
+	k.setup();
+
+	k.compute();
+	unsigned int nFirst(k.getNArgumentsSettings());
+	k.compute();
+	bool status(k.getNArgumentsSettings() == nFirst);
+
+	a->setValue(4.);
+	k.compute();
+	status &= k.getNArgumentsSettings() == nFirst + 1;
+
+	swapBuffers(*vec1, *vec2);
+	k.compute();
+	status &= k.getNArgumentsSettings() == nFirst + 2;
+	copy(vec0, output);
+
+	status &= output[4] == 12;
+	errorMessage(status);
+
+	return status;
+}
+
+
+bool testKernelProfiler()
+{
+	cout << "Test of KernelProfiler..." << flush;
+
+	Element vec0(new Array<cl_float>(10));
+	Element vec1(new Array<cl_float>(10));
+
+	kernelProfiler.enable();
+	kernelProfiler.reset();
+
+	Kernel k;
+	k.setLabel("test kernel");
+	{
+		using namespace elementOperators;
+		k.addExpression(operatorAssignment(vec0, vec1));
+	}
+	k.setup();
+	for (unsigned int i = 0; i < 3; ++i)
+		k.computeAsync();
+
+	vector<KernelProfiler::Record> records(kernelProfiler.getRecords());
+	bool status(records.size() == 1 &&
+	            records[0].label == "test kernel" &&
+	            records[0].launches == 3 &&
+	            records[0].bytesRead == 10 * sizeof(cl_float) &&
+	            records[0].bytesWritten == 10 * sizeof(cl_float));
+
+	// the read-modify-write argument is accounted in both directions
+	Kernel kRMW;
+	{
+		using namespace elementOperators;
+		kRMW.addExpression(operatorAssignment(vec0, vec0 + vec1));
+	}
+	kRMW.setup();
+	status &= kRMW.getBytesRead() == 20 * sizeof(cl_float) &&
+	          kRMW.getBytesWritten() == 10 * sizeof(cl_float);
+	errorMessage(status);
+
+	return status;
+}
+
+
+bool testMultiQueue()
+{
+	cout << "Test of execution on several queues..." << flush;
+
+	CommandQueue queue1(hardware.createQueue(hardware.defaultQueue));
+
+	shared_ptr<Array<cl_float> > vec0(new Array<cl_float>(10));
+	Element vec1(new Array<cl_float>(10));
+	Element c(new Constant<cl_float>(2.));
+
+	vector<cl_float> output(10, 0);
+
+	Kernel k0;
+	Kernel k1;
+	{
+		using namespace elementOperators;
+		k0.addExpression(operatorAssignment(vec0, c));
+		k1.addExpression(operatorAssignment(vec1, vec0 + c));
+	}
+	k1.setQueue(queue1);
+	k0.setup();
+	k1.setup();
+
+	// k1 runs on the second queue and waits for k0 through the events of vec0
+	k0.computeAsync();
+	vec0->migrate(queue1);
+	k1.computeAsync();
+	copy(vec1, output);
+
+	bool status(output[5] == 4 && k1.getQueue().get() == queue1.get());
+	errorMessage(status);
+
+	return status;
+}
+
+
+bool testExpressionOptimizer()
+{
+	cout << "Test of ExpressionOptimizer..." << flush;
+
+	Element vec0(new Array<cl_float>(10));
+	Element vec1(new Array<cl_float>(10));
+	Element vec2(new Array<cl_float>(10));
+	Element one(new Constant<cl_float>(1.));
+	Element c(new Constant<cl_float>(2.));
+
+	Kernel k0;
+	Kernel k;
+	Kernel kReference;
+	{
+		using namespace elementOperators;
+		k0.addExpression(operatorAssignment(vec0, one));
+		// (vec0 * 1 + 2 * 2) is folded into (vec0 + 4.) and computed once
+		Element s(vec0 * one + c * c);
+		k.addExpression(operatorAssignment(vec1, s * s));
+		k.addExpression(operatorAssignment(vec2, powI(powI(s, 2), 1)));
+		kReference.addExpression(operatorAssignment(vec2, s * s));
+	}
+	k0.setup();
+	k.setup();
+	ExpressionOptimizer::setEnabled(false);
+	kReference.setup();
+	ExpressionOptimizer::setEnabled(true);
+
+	k0.compute();
+	k.compute();
+	vector<cl_float> output1(10), output2(10);
+	copy(vec1, output1);
+	copy(vec2, output2);
+	kReference.compute();
+	vector<cl_float> reference(10);
+	copy(vec2, reference);
+
+	bool status(output1[5] == 25 && output2[5] == 25 && reference[5] == 25 &&
+	            k.getNEliminatedNodes() > 0 &&
+	            kReference.getNEliminatedNodes() == 0 &&
+	            k.getKernelSource().find("pv_cse") != string::npos);
+	errorMessage(status);
+
+	return status;
+}
+
+
+bool testMemoryPool()
+{
+	cout << "Test of MemoryPool..." << flush;
+
+	const MemoryPool::Statistics & statistics(memoryPool.getStatistics());
+	unsigned long long hits(statistics.hits);
+	Element c(new Constant<cl_float>(2.));
+	{
+		Element vec0(new Array<cl_float>(100));
+		Kernel k;
+		{
+			using namespace elementOperators;
+			k.addExpression(operatorAssignment(vec0, c));
+		}
+		k.setup();
+		k.computeAsync();
+	}
+
+	// reuses the buffer of vec0 after the kernel writing it
+	vector<cl_float> input(100, 3.);
+	Element vec1(new Array<cl_float>(100, &input[0]));
+	vector<cl_float> output(100);
+	copy(vec1, output);
+
+	bool status(statistics.hits == hits + 1 && 
+	            output[99] == 3 &&
+	            statistics.bytesLive <= statistics.bytesPeak &&
+	            MemoryPool::sizeClass(100, 128) == 128 &&
+	            MemoryPool::sizeClass(1000, 4) == 1024);
+	errorMessage(status);
+
+	return status;
+}
+
+
+bool testZeroCopy()
+{
+	cout << "Test of zero-copy buffers..." << flush;
+
+	Element vec0(new Array<cl_float>(10));
+	Element c(new Constant<cl_float>(2.));
+	vector<cl_float> input(10, 3.);
+	copy(input, vec0);
+
+	Kernel k;
+	{
+		using namespace elementOperators;
+		k.addExpression(operatorAssignment(vec0, vec0 + c));
+	}
+	k.setup();
+	k.compute();
+
+	vector<cl_float> output(10);
+	copy(vec0, output);
+
+	bool cpu(getDeviceType(hardware.defaultQueue) == CL_DEVICE_TYPE_CPU);
+	bool status(output[9] == 5 &&
+	            static_pointer_cast<MemBlock>(vec0)->isHostVisible() == cpu);
+	errorMessage(status);
+
+	return status;
+}
+
+
+bool testPartialMap()
+{
+	cout << "Test of partial mapping..." << flush;
+
+	ElementData vec0(new Array<cl_float>(10));
+	vector<cl_float> input(10);
+	for (unsigned int i(0); i < 10; ++i)
+		input[i] = i;
+	copy(input, vec0);
+
+	bool status(true);
+	{
+		shared_ptr<cl_float> p(acl::map<cl_float>(vec0, 4, 3, CL_MAP_READ));
+		status &= p.get()[0] == 4 && p.get()[2] == 6;
+	}
+	{
+		shared_ptr<cl_float> p(acl::map<cl_float>(vec0, 8, 2, CL_MAP_WRITE_INVALIDATE_REGION));
+		p.get()[0] = 20;
+		p.get()[1] = 21;
+	}
+
+	vector<cl_float> output(10);
+	copy(vec0, output);
+	status &= output[7] == 7 && output[8] == 20 && output[9] == 21;
+	errorMessage(status);
+
+	return status;
+}
+
+
+/// Computes the 7-point stencil on the internal points of the 8x8x8 grid by a 
+/// plain kernel and by \p k configured by the caller, returns whether they agree
+bool compareLaplace(Kernel & k)
+{
+	const unsigned int n(512);
+	const int first(73);
+	const unsigned int size(366);
+	Element a(new Array<cl_float>(n));
+	Element b0(new Array<cl_float>(n));
+	Element b1(new Array<cl_float>(n));
+	vector<cl_float> input(n);
+	for (unsigned int i(0); i < n; ++i)
+		input[i] = (i * 37) % 11;
+	copy(input, a);
+	copy(input, b0);
+	copy(input, b1);
+
+	using namespace elementOperators;
+	Element center(generateSubElement(a, size, first));
+	Element laplace(Element(new Constant<cl_float>(-6.)) * center);
+	const int shifts[] = {-64, -8, -1, 1, 8, 64};
+	for (unsigned int i(0); i < 6; ++i)
+		laplace = laplace + generateShiftedElement(center, shifts[i]);
+
+	Kernel k0;
+	k0.addExpression(operatorAssignment(generateSubElement(b0, size, first), laplace));
+	k.addExpression(operatorAssignment(generateSubElement(b1, size, first), laplace));
+	k0.setup();
+	k.setup();
+	k0.compute();
+	k.compute();
+
+	vector<cl_float> output0;
+	vector<cl_float> output1;
+	copy(b0, output0);
+	copy(b1, output1);
+
+	bool status(true);
+	for (unsigned int i(0); i < n; ++i)
+		status &= fabs(output0[i] - output1[i]) < 1e-5;
+	return status;
+}
+
+
+bool testStencilTiling()
+{
+	cout << "Test of StencilTiling..." << flush;
+
+	Kernel k;
+	k.setTiling({8, 8, 8}, {2, 4, 4});
+	bool status(compareLaplace(k));
+	if (StencilTiling::isSupported(hardware.defaultQueue))
+		status &= k.isTiled() && k.getKernelSource().find("__local") != string::npos;
+	errorMessage(status);
+
+	return status;
+}
+
+
+bool testMarching()
+{
+	cout << "Test of marching kernels..." << flush;
+
+	Kernel k;
+	k.setTiling({8, 8, 8}, {1, 2, 4});
+	k.setMarching();
+	bool status(compareLaplace(k) && 
+	            k.isTiled() && k.getKernelSource().find("__local") == string::npos);
+	errorMessage(status);
+
+	return status;
+}
+
+
+bool testStepRecorder()
+{
+	cout << "Test of StepRecorder..." << flush;
+
+	Element vec(new Array<cl_float>(1000));
+	Element c(new Constant<cl_float>(1.));
+	vector<cl_float> input(1000, 0.);
+	copy(input, vec);
+
+	Kernel k;
+	{
+		using namespace elementOperators;
+		k.addExpression(operatorAssignment(vec, vec + c));
+	}
+	k.setup();
+
+	unsigned int nActions(0);
+	StepRecorder step;
+	step.begin();
+	k.computeAsync();
+	StepRecorder::hostAction([&nActions](){++nActions;});
+	k.computeAsync();
+	step.end();
+	step.replay(10);
+
+	vector<cl_float> output;
+	copy(vec, output);
+
+	bool status(nActions == 11 && step.getNLaunches() == 2 && step.getNHostActions() == 1);
+	for (unsigned int i(0); i < output.size(); ++i)
+		status &= fabs(output[i] - 22.) < 1e-5;
+	errorMessage(status);
+
+	return status;
+}
+
+
+bool testHalfStorage()
+{
+	cout << "Test of half precision storage..." << flush;
+
+	Element vecH(new ArrayHalf(1024));
+	Element vecF(new Array<cl_float>(1024));
+	Element c(new Constant<cl_float>(0.5));
+	Element k(new Constant<cl_float>(0.99));
+	vector<cl_float> input(1024);
+	for (unsigned int i(0); i < 1024; ++i)
+		input[i] = 0.01 * i;
+	copy(input, vecH);
+	copy(input, vecF);
+
+	Kernel kernel(KERNEL_SIMDUA);
+	{
+		using namespace elementOperators;
+		kernel.addExpression(operatorAssignment(vecH, vecH * k + c));
+		kernel.addExpression(operatorAssignment(vecF, vecF * k + c));
+	}
+	kernel.setup();
+	for (unsigned int i(0); i < 10; ++i)
+		kernel.compute();
+
+	// writing through an excerpt
+	Kernel kernelExcerpt;
+	{
+		using namespace elementOperators;
+		Element ind(new Index(512));
+		Element shift(new Constant<cl_int>(512));
+		kernelExcerpt.addExpression(operatorAssignment(excerpt(vecH, ind + shift), c));
+	}
+	kernelExcerpt.setup();
+	kernelExcerpt.compute();
+
+	vector<cl_float> outputH;
+	vector<cl_float> outputF;
+	copy(vecH, outputH);
+	copy(vecF, outputF);
+
+	bool status(true);
+	for (unsigned int i(0); i < 512; ++i)
+		status &= fabs(outputH[i] - outputF[i]) < 2e-3 * fabs(outputF[i]);
+	status &= outputH[600] == 0.5 && outputH[1023] == 0.5;
+	errorMessage(status);
+
+	return status;
+}
+
+
+bool testIndexList()
+{
+	cout << "Test of index lists..." << flush;
+
+	Element vec(new Array<cl_float>(1000));
+	Element c(new Constant<cl_float>(1.));
+	vector<cl_float> input(1000, 0.);
+	copy(input, vec);
+	vector<cl_uint> indices({3, 17, 500, 999});
+	Element list(new Array<cl_uint>(indices.size()));
+	copy(indices, list);
+
+	Kernel k(KERNEL_SIMD);
+	{
+		using namespace elementOperators;
+		k.addExpression(operatorAssignment(vec, vec + c));
+	}
+	k.setIndexList(list, 3);
+	k.setup();
+	string source(k.getKernelSource());
+	k.compute();
+	k.compute();
+	// an empty list launches nothing
+	k.setIndexList(list, 0);
+	k.compute();
+	// the length of the list is an argument, the source stays the same
+	k.setIndexList(list, 4);
+	k.compute();
+
+	vector<cl_float> output;
+	copy(vec, output);
+
+	bool status(k.getKernelSource() == source);
+	for (unsigned int i(0); i < output.size(); ++i)
+		status &= output[i] == (i == 3 || i == 17 || i == 500 ? 3. : (i == 999 ? 1. : 0.));
+	errorMessage(status);
+
+	return status;
+}
+
+
+bool testKernelTuner()
+{
+	cout << "Test of KernelTuner..." << flush;
+
+	// results are kept in memory only
+	kernelTuner.setDatabase("");
+	unsigned int nTunings(kernelTuner.getNTunings());
+	unsigned int nHits(kernelTuner.getNHits());
+
+	Element vec0(new Array<cl_float>(1024));
+	Element c(new Constant<cl_float>(2.));
+	vector<cl_float> input(1024, 3.);
+	copy(input, vec0);
+
+	// the group size tuned for 1024 elements does not divide 1000
+	Element vec2(new Array<cl_float>(1000));
+	vector<cl_float> input2(1000, 3.);
+	copy(input2, vec2);
+
+	Kernel k0(KERNEL_SIMD);
+	Kernel k1(KERNEL_SIMD);
+	Kernel k2(KERNEL_SIMD);
+	{
+		using namespace elementOperators;
+		k0.addExpression(operatorAssignment(vec0, vec0 + c));
+		k1.addExpression(operatorAssignment(vec0, vec0 + c));
+		k2.addExpression(operatorAssignment(vec2, vec2 + c));
+	}
+	k0.setup();
+	// the benchmark launches do not affect the data
+	k0.compute();
+	k1.setup();
+	k1.compute();
+	k2.setup();
+	k2.compute();
+
+	vector<cl_float> output(1024);
+	copy(vec0, output);
+	vector<cl_float> output2(1000);
+	copy(vec2, output2);
+	kernelTuner.setEnabled(false);
+
+	bool status(output[0] == 7 && output[1023] == 7 &&
+	            output2[0] == 5 && output2[999] == 5 &&
+	            kernelTuner.getNTunings() == nTunings + 2 &&
+	            kernelTuner.getNHits() == nHits + 1 &&
+	            k0.getConfiguration() == k1.getConfiguration());
+	errorMessage(status);
+
+	return status;
+}
+
+
 int main()
 {
 	bool allTestsPassed(true);
@@ -428,11 +1081,28 @@ int main()
 	allTestsPassed &= testPrivateVariable();
 	allTestsPassed &= testPrivateArray();
 	allTestsPassed &= testVariable();
+	allTestsPassed &= testStableVariable();
 	allTestsPassed &= testVariableReference();
 	allTestsPassed &= testSelect();
 	allTestsPassed &= testSwapBuffers();
 	allTestsPassed &= testLocalArray();
 	allTestsPassed &= testSubvector();
+	allTestsPassed &= testComputeAsync();
+	allTestsPassed &= testProgramCache();
+	allTestsPassed &= testParallelBuild();
+	allTestsPassed &= testArgumentsSettings();
+	allTestsPassed &= testKernelProfiler();
+	allTestsPassed &= testMultiQueue();
+	allTestsPassed &= testExpressionOptimizer();
+	allTestsPassed &= testMemoryPool();
+	allTestsPassed &= testZeroCopy();
+	allTestsPassed &= testPartialMap();
+	allTestsPassed &= testKernelTuner();
+	allTestsPassed &= testStencilTiling();
+	allTestsPassed &= testMarching();
+	allTestsPassed &= testStepRecorder();
+	allTestsPassed &= testHalfStorage();
+	allTestsPassed &= testIndexList();
 	
 	return allTestsPassed ? EXIT_SUCCESS : EXIT_FAILURE;
 }
\ No newline at end of file
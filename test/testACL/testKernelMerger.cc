@@ -31,6 +31,9 @@
 #include "acl/DataTypes/aclArray.h"
 #include "acl/Kernels/aclKernel.h"
 #include "acl/Kernels/aclKernelMerger.h"
+#include "acl/Kernels/aclKernelFusion.h"
+#include "acl/DataTypes/aclIndex.h"
+#include "acl/Operators/aclElementExcerpt.h"
 #include "aslUtilities.h"
 #include <math.h>
 #include <initializer_list>
@@ -81,11 +84,116 @@ bool testKernelMerger()
 	return status;		
 }
 
+bool testKernelFusion()
+{
+	cout << "Test of \"KernelFusion\" functionality..." << flush;
+	ElementData a(new Array<cl_float> (10));
+	ElementData b(new Array<cl_float> (10));
+	ElementData c(new Array<cl_float> (10));
+
+	Element ind(new Index(10));
+	Element c1(new Constant<cl_int>(1));
+	Element c2(new Constant<cl_float>(2));
+	Element c10(new Constant<cl_int>(10));
+	
+	SPKernel k0(new Kernel());
+	SPKernel k1(new Kernel());
+	SPKernel k2(new Kernel());
+	SPKernel k3(new Kernel());
+	{ 
+		using namespace elementOperators;
+		k0->addExpression(operatorAssignment(a, c2));
+		// a is read at the own index: fused with k0
+		k1->addExpression(operatorAssignment(b, a + c1));
+		// b is read at a neighbour index: starts a new kernel
+		k2->addExpression(operatorAssignment(c, excerpt(b, (ind + c1) % c10)));
+		// c is accessed at the own index only: fused with k2
+		k3->addExpression(operatorAssignment(a, c * c2));
+	}
+
+	KernelFusion kf;
+	kf.addKernel(k0);
+	kf.addKernel(k1);
+	kf.addKernel(k2);
+	kf.addKernel(k3);
+
+	kf.setup();
+	kf.compute();
+
+	bool status((kf.getNKernels() == 2) &&
+	            (acl::map<float>(a).get()[9] == 6) && 
+	            (acl::map<float>(b).get()[3] == 3) &&
+	            (acl::map<float>(c).get()[9] == 3) &&
+	            (kf.getKernelSource().find("_fused") != string::npos));
+	errorMessage(status);
+	cout << kf.getKernelSource() << endl;
+	return status;		
+}
+
+/// kernel writing \p value into \p a except where \p map <= 0, 
+/// the kernel terminates there like the map based methods
+SPKernel generateMapKernel(ElementData a, ElementData map, float value)
+{
+	using namespace elementOperators;
+	SPKernel k(new Kernel());
+	Element c0(new Constant<cl_float>(0));
+	Element cV(new Constant<cl_float>(value));
+	k->addExpression(ifElse(any(Element(map) <= c0), {returnStatement()}, {}));
+	k->addExpression(operatorAssignment(a, a + cV));
+	return k;
+}
+
+bool testKernelFusionReturn()
+{
+	cout << "Test of \"KernelFusion\" with return statements..." << flush;
+	vector<float> mapAH({1, 1, -1, 1, -1, 1, 1, 1, -1, 1});
+	vector<float> mapBH({-1, 1, 1, 1, 1, -1, -1, 1, 1, 1});
+	vector<float> zeros(10, 0);
+	ElementData mapA(new Array<cl_float> (10));
+	ElementData mapB(new Array<cl_float> (10));
+	copy(mapAH, mapA);
+	copy(mapBH, mapB);
+	vector<ElementData> a(2);
+	vector<ElementData> b(2);
+	for (unsigned int i(0); i < 2; ++i)
+	{
+		a[i].reset(new Array<cl_float> (10));
+		b[i].reset(new Array<cl_float> (10));
+		copy(zeros, a[i]);
+		copy(zeros, b[i]);
+	}
+
+	// sequential execution
+	SPKernel kA(generateMapKernel(a[0], mapA, 1));
+	SPKernel kB(generateMapKernel(b[0], mapB, 2));
+	kA->setup();
+	kB->setup();
+	kA->compute();
+	kB->compute();
+
+	KernelFusion kf;
+	kf.addKernel(generateMapKernel(a[1], mapA, 1));
+	kf.addKernel(generateMapKernel(b[1], mapB, 2));
+	kf.setup();
+	kf.compute();
+
+	vector<float> aS, bS, aF, bF;
+	copy(a[0], aS);
+	copy(b[0], bS);
+	copy(a[1], aF);
+	copy(b[1], bF);
+	bool status(kf.getNKernels() == 2 && aS == aF && bS == bF);
+	errorMessage(status);
+	return status;		
+}
+
 int main()
 {
 	bool allTestsPassed(true);
 
 	allTestsPassed &= testKernelMerger();
+	allTestsPassed &= testKernelFusion();
+	allTestsPassed &= testKernelFusionReturn();
 	
 	return allTestsPassed ? EXIT_SUCCESS : EXIT_FAILURE;
 }
\ No newline at end of file
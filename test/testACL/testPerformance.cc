@@ -21,46 +21,174 @@
  */
 
 
+
 /**
  	\example testPerformance.cc
 
-	\todo repare
- 
-	Results:
- 	processor: Intel(R) Core(TM)2 Duo CPU     T8100  @ 2.10GHz
+	Micro-benchmark suite of ASL, built as `asl-bench`.
+
+	Covers element operators for each KernelConfiguration, reductions,
+	LBGK steps for d2q9, d3q15, d3q19, d3q27 (also replayed by StepRecorder,
+	d3q19 also with the in-place streaming), sparse LBGK steps for a packed
+	bed of spheres (MLUPS are based on the fluid nodes)
+	and FDAdvectionDiffusion steps,
+	the 3D FDAdvectionDiffusion is measured also in the marching mode 
+	(KernelConfiguration::marching) against the flat indexing.
+	The d3q19 LBGK and the d3q7 FDAdvectionDiffusion are measured with 
+	TemporalBlocking for 1, 2 and 4 steps per pass.
+	Each case is repeated for at least `interval` seconds, the results 
+	(launches/s, MLUPS, GB/s) are written in JSON format to `output`.
+	GB/s is based on the bytes estimated by Kernel::getBytesRead() and
+	Kernel::getBytesWritten().
+
 	\code
-	Test of Sum Operator...
-	GPU: 9
-	CPU: 12
+	asl-bench --interval 1 --sizes 3 --output bench.json
 	\endcode
 */
 
 #include "acl/acl.h"
 #include "acl/aclHardware.h"
+#include "acl/aclGenerators.h"
 #include "acl/DataTypes/aclIndex.h"
+#include "acl/DataTypes/aclGroupID.h"
 #include "acl/DataTypes/aclConstant.h"
-#include "acl/DataTypes/aclVariable.h"
-#include "acl/DataTypes/aclPrivateVariable.h"
 #include "acl/DataTypes/aclArray.h"
-#include "acl/DataTypes/aclSubvector.h"
 #include "acl/Kernels/aclKernel.h" 
+#include "acl/Kernels/aclKernelProfiler.h" 
+#include "acl/Kernels/aclStepRecorder.h"
+#include "acl/aclMath/aclVectorOfElements.h"
+#include "acl/aclMath/aclReductionAlgGenerator.h"
 #include "aslUtilities.h"
+#include "aslGenerators.h"
+#include "aslDataInc.h"
+#include "aslGeomInc.h"
+#include "math/aslTemplates.h"
+#include "num/aslLBGK.h"
+#include "num/aslLBGKSparse.h"
+#include "num/aslFDAdvectionDiffusion.h"
+#include "num/aslTemporalBlocking.h"
 #include "utilities/aslTimer.h"
+#include "utilities/aslParametersManager.h"
 #include <math.h>
 #include <fstream>
+#include <sstream>
 
 #include <acl/Kernels/aclKernelConfigurationTemplates.h>
 
-#define ARRAY_SIZE 10000000
-//#define ITERATIONS_NUM 20
-#define TIME_INTERVAL 5 // in seconds
+#define ARRAY_SIZE 1000000
 
 using namespace acl;
 using namespace std;
 
 
+/// Result of one benchmark case
+class Result
+{
+	public:
+		string name;
+		string configuration;
+		string type;
+		unsigned int size;
+		unsigned int launches;
+		double time;
+		cl_ulong bytes;
+
+		double launchesPerSecond() const {return launches / time;}
+		double mlups() const {return (double)size * launches / time * 1e-6;}
+		double gbps() const {return bytes / time * 1e-9;}
+};
+
+
+vector<Result> results;
+double interval(1.);
+
+
+/// Repeats \p f for at least ::interval seconds and stores the result
+template <class F> void measure(F f,
+                                const string & name,
+                                const string & configuration,
+                                const string & type,
+                                unsigned int size)
+{
+	// warm up, includes lazy initializations
+	f();
+	hardware.defaultQueue->finish();
+	kernelProfiler.reset();
+
+	asl::Timer timer;
+	Result r;
+	r.launches = 0;
+	do
+	{
+		timer.start();
+		f();
+		hardware.defaultQueue->finish();
+		timer.stop();
+		++r.launches;
+	}
+	while (timer.realTime() < interval);
+
+	vector<KernelProfiler::Record> records(kernelProfiler.getRecords());
+	r.bytes = 0;
+	for (unsigned int i = 0; i < records.size(); ++i)
+		r.bytes += records[i].launches * (records[i].bytesRead + records[i].bytesWritten);
+
+	r.name = name;
+	r.configuration = configuration;
+	r.type = type;
+	r.size = size;
+	r.time = timer.realTime();
+	results.push_back(r);
+
+	cout << name << " " << configuration << " " << type << " " << size << ": "
+	     << r.launchesPerSecond() << " launches/s, "
+	     << r.mlups() << " MLUPS, "
+	     << r.gbps() << " GB/s" << endl;
+}
+
+
+/// Launches kernel, used by measure()
+class KernelLauncher
+{
+	public:
+		Kernel & k;
+		KernelLauncher(Kernel & k_): k(k_) {}
+		void operator()() {k.computeAsync();}
+};
+
+
+/// Executes numerical method, used by measure()
+class NMLauncher
+{
+	public:
+		asl::SPNumMethod nm;
+		NMLauncher(asl::SPNumMethod nm_): nm(nm_) {}
+		void operator()() {nm->execute();}
+};
+
+
+/// Replays recorded step, used by measure()
+class ReplayLauncher
+{
+	public:
+		StepRecorder & step;
+		ReplayLauncher(StepRecorder & step_): step(step_) {}
+		void operator()() {step.replay();}
+};
+
+
+/// Computes reduction, used by measure()
+template <typename T> class ReductionLauncher
+{
+	public:
+		shared_ptr<ReductionAlgGenerator<T, ROT_SUM> > alg;
+		ReductionLauncher(shared_ptr<ReductionAlgGenerator<T, ROT_SUM> > alg_): alg(alg_) {}
+		void operator()() {alg->compute();}
+};
+
+
 // Operators: +
-template <typename T> inline T testSum(T x1, T x2)
+inline Element testSum(Element x1, Element x2)
 { 
 	using namespace elementOperators;
 	return x1 + x2;
@@ -68,7 +196,7 @@ template <typename T> inline T testSum(T x1, T x2)
 
 
 // Operators: + (non sequential)
-template <typename T> inline T testSumNonSequential(T x1, T x2)
+inline Element testSumNonSequential(Element x1, Element x2)
 {
 	Element index(new Index(ARRAY_SIZE));
 	Element c(new Constant<cl_uint>(17));
@@ -79,7 +207,7 @@ template <typename T> inline T testSumNonSequential(T x1, T x2)
 
 
 // Operators: +, -, *, /
-template <typename T> inline T testBasicOperators(T x1, T x2)
+inline Element testBasicOperators(Element x1, Element x2)
 {
 	using namespace elementOperators;
 	return x1 * (x2 + x2) * x1 + (x2 + x1 * x1) * x2 * x1 * x2 * x1 - x1 / x2 + 
@@ -91,96 +219,40 @@ template <typename T> inline T testBasicOperators(T x1, T x2)
 
 
 // Operators: +, -, *, /, sin, cos, sqrt
-template <typename T> inline T testSpecialOperators(T x1, T x2)
+inline Element testSpecialOperators(Element x1, Element x2)
 {
 	using namespace elementOperators;
 	return cos(x1*sin(x2+x2)*x1+sqrt(x2+x1*x1)*x2*sin(x1)*x1*sqrt(x2)*x2*x1*sqrt(x1*x2)-x1/x2);
 }
 
 
-/*
-void print(Glib::KeyFile * keyFile,
-           string deviceName,
-           string key,
-           string value,
-           bool writeToKeyFile)
-{
-	cout << key + ": " + value << endl;
-	
-	// Save the output for this device to the performance report file if needed
-	if (writeToKeyFile)
-	{
-		keyFile->set_string((deviceName),
-		                    key,
-		                    value);
-	}
-}
-*/
-
-/*
-template <typename T> inline void testKernelPerformance(const KernelConfiguration kernelConfig,
-                                                        const CommandQueue & queue,
-                                                        Glib::KeyFile * keyFile,
-                                                        bool writeToKeyFile)
+template <typename T> void benchmarkOperators(const KernelConfiguration & kernelConfig,
+                                              const string & configurationName)
 {
-	Element arr1(new Array<T>(ARRAY_SIZE, queue));
-	Element arr2(new Array<T>(ARRAY_SIZE, queue));
-	Element arrResult(new Array<T>(ARRAY_SIZE, queue));
+	Element arr1(new Array<T>(ARRAY_SIZE));
+	Element arr2(new Array<T>(ARRAY_SIZE));
+	Element arrResult(new Array<T>(ARRAY_SIZE));
 	Element c(new Constant<T>(5));
+	string type(typeToStr<T>());
 
-	string typeStr = typeToStr<T>();
-	
-	string kernelConfigStr;
-	if (kernelConfig == KERNEL_BASIC)
-		kernelConfigStr = "KERNEL_BASIC";
-	else
-		if (kernelConfig == KERNEL_SIMD)
-			kernelConfigStr = "KERNEL_SIMD";
-		else
-			if (kernelConfig == KERNEL_SIMDUA)
-				kernelConfigStr = "KERNEL_SIMDUA";
-
-	
 	Kernel k(kernelConfig);
-	
-	// Initialization of the arrays
 	{
 		using namespace elementOperators;
 		k.addExpression(operatorAssignmentSafe(arr1, c));
 		k.addExpression(operatorAssignmentSafe(arr2, c));
 	}
+	k.setup();
 	k.compute();
 
-	// Test of sum
 	k.clear();
 	{ 
 		using namespace elementOperators;
 		k.addExpression(operatorAssignmentSafe(arrResult, testSum(arr1, arr2)));
 	}
 	k.setup();
-	
-	asl::Timer timer;
-	unsigned int iterationsNum;
-
-	timer.start();
-	timer.stop();
-	iterationsNum = 0;
-	do
-	{
-		timer.resume();
-		k.compute();
-		++iterationsNum;
-		timer.stop();
-	}
-	while (timer.getTime() < TIME_INTERVAL);
-
-	print(keyFile,
-	      getDeviceName(queue),
-	      kernelConfigStr + "---" + typeStr + "---" + "Sum",
-	      numToStr((float) iterationsNum / timer.getTime()),
-	      writeToKeyFile);
+	measure(KernelLauncher(k), "Sum", configurationName, type, ARRAY_SIZE);
 
-	// Test of non sequential sum (only for non SIMD kernels)
+	// only for non SIMD kernels
 	if (kernelConfig.vectorWidth == 1)
 	{
 		k.clear();
@@ -190,28 +262,9 @@ template <typename T> inline void testKernelPerformance(const KernelConfiguratio
 			                                       testSumNonSequential(arr1, arr2)));
 		}
 		k.setup();
-		
-		timer.start();
-		timer.stop();
-		iterationsNum = 0;
-		do
-		{
-			timer.resume();
-			k.compute();
-			++iterationsNum;
-			timer.stop();
-		}
-		while (timer.getTime() < TIME_INTERVAL);
-
-		print(keyFile,
-		      getDeviceName(queue),
-		      kernelConfigStr + "---" + typeStr + "---" + "NonSequentialSum",
-		      numToStr((float) iterationsNum / timer.getTime()),
-		      writeToKeyFile);
-
+		measure(KernelLauncher(k), "NonSequentialSum", configurationName, type, ARRAY_SIZE);
 	}
 
-	// Test of basic operators
 	k.clear();
 	{ 
 		using namespace elementOperators;
@@ -219,154 +272,274 @@ template <typename T> inline void testKernelPerformance(const KernelConfiguratio
 		                                       testBasicOperators(arr1, arr2)));
 	}
 	k.setup();
-	
-	timer.start();
-	timer.stop();
-	iterationsNum = 0;
-	do
-	{
-		timer.resume();
-		k.compute();
-		++iterationsNum;
-		timer.stop();
+	measure(KernelLauncher(k), "BasicOperators", configurationName, type, ARRAY_SIZE);
+
+	k.clear();
+	{ 
+		using namespace elementOperators;
+		k.addExpression(operatorAssignmentSafe(arrResult,
+		                                       testSpecialOperators(arr1, arr2)));
 	}
-	while (timer.getTime() < TIME_INTERVAL);
+	k.setup();
+	measure(KernelLauncher(k), "SpecialOperators", configurationName, type, ARRAY_SIZE);
+}
 
-	print(keyFile,
-	      getDeviceName(queue),
-	      kernelConfigStr + "---" + typeStr + "---" + "BasicOperators",
-	      numToStr((float) iterationsNum / timer.getTime()),
-	      writeToKeyFile);
+
+/// Sum within work-groups, the global index is composed of the group and local ids
+template <typename T> void benchmarkLocal()
+{
+	unsigned int groupSize(min((unsigned int)getMaxItemSize(hardware.defaultQueue), 256u));
+	unsigned int groupsNumber(ARRAY_SIZE / groupSize);
+	unsigned int size(groupSize * groupsNumber);
+
+	Element arr1(new Array<T>(size));
+	Element arr2(new Array<T>(size));
+	Element arrResult(new Array<T>(size));
+	Element ind(new Index(groupSize));
+	Element groupID(new GroupID());
+	Element cGroupSize(new Constant<cl_uint>(groupSize));
+
+	KernelConfiguration kConf(KERNEL_BASIC);
+	kConf.local = true;
+	Kernel k(kConf);
+	k.setGroupsNumber(groupsNumber);
+	{ 
+		using namespace elementOperators;
+		Element globalInd(cGroupSize * groupID + ind);
+		k.addExpression(operatorAssignmentSafe(excerpt(arrResult, globalInd),
+		                                       testSum(excerpt(arr1, globalInd),
+		                                               excerpt(arr2, globalInd))));
+	}
+	k.setup();
+	measure(KernelLauncher(k), "Sum", "KERNEL_BASIC local", typeToStr<T>(), size);
+}
 
 
-	// Test of special operators
-	k.clear();
-	if (arr1->getTypeID() != TYPE_INT)
+template <typename T> void benchmarkReduction()
+{
+	VectorOfElements v(generateVEData<T>(ARRAY_SIZE, 1u));
+	initData(v, generateVEConstant(T(2)));
+	auto summator(generateSumAlg<T>(v));
+	summator->generateAlg();
+	measure(ReductionLauncher<T>(summator), "ReductionSum", "", typeToStr<T>(), ARRAY_SIZE);
+}
+
+
+void benchmarkLBGK(const asl::VectorTemplate & vt,
+                   const string & vtName,
+                   const vector<asl::AVec<int> > & sizes,
+                   bool inPlace = false)
+{
+	string configuration(vtName + (inPlace ? " in-place" : ""));
+	for (unsigned int i = 0; i < sizes.size(); ++i)
 	{
-		{ 
-			using namespace elementOperators;
-			k.addExpression(operatorAssignmentSafe(arrResult,
-			                                       testSpecialOperators(arr1, arr2)));
-		}
-		k.setup();
-	
-		timer.start();
-		timer.stop();
-		iterationsNum = 0;
-		do
-		{
-			timer.resume();
-			k.compute();
-			++iterationsNum;
-			timer.stop();
-		}
-		while (timer.getTime() < TIME_INTERVAL);
+		asl::Block block(sizes[i], 1.);
+		asl::SPLBGK lbgk(new asl::LBGK(block, generateVEConstant(0.01f), &vt));
+		lbgk->setInPlaceStreaming(inPlace);
+		lbgk->init();
+		asl::SPLBGKUtilities lbgkUtil(new asl::LBGKUtilities(lbgk));
+		if (nD(block) == 2)
+			lbgkUtil->initF(generateVEConstant(.0, .0));
+		else
+			lbgkUtil->initF(generateVEConstant(.0, .0, .0));
+
+		measure(NMLauncher(lbgk), "LBGK", configuration, "float", productOfElements(sizes[i]));
 
-		print(keyFile,
-		      getDeviceName(queue),
-		      kernelConfigStr + "---" + typeStr + "---" + "SpecialOperators",
-		      numToStr((float) iterationsNum / timer.getTime()),
-		      writeToKeyFile);
+		StepRecorder step;
+		step.begin();
+		lbgk->execute();
+		step.end();
+		measure(ReplayLauncher(step), "LBGK", configuration + " replay", "float", productOfElements(sizes[i]));
 	}
 }
-*/
 
-int main()
+
+/// Packed bed of 4x4x4 overlapping spheres, about 30% of the nodes are fluid
+void benchmarkLBGKSparse(const asl::VectorTemplate & vt,
+                         const string & vtName,
+                         const vector<asl::AVec<int> > & sizes)
 {
-	/*
-	const string FILE_NAME("./PerformanceReport.txt");
-	bool writeToKeyFile = false;
-	bool dumpKeyFile = false;
-	
-	Glib::KeyFile *keyFile = new Glib::KeyFile;
-
-	ifstream fileCheck(FILE_NAME);
-	if (fileCheck.good())
+	for (unsigned int i = 0; i < sizes.size(); ++i)
 	{
- 		keyFile->load_from_file(FILE_NAME);
+		asl::Block block(sizes[i], 1.);
+		asl::SPDistanceFunction bed;
+		double spacing(sizes[i][0] / 4.);
+		for (unsigned int x = 0; x < 4; ++x)
+			for (unsigned int y = 0; y < 4; ++y)
+				for (unsigned int z = 0; z < 4; ++z)
+					bed = bed | asl::generateDFSphere(.55 * spacing, 
+					                                  spacing * asl::makeAVec(x + .5, y + .5, z + .5));
+
+		asl::SPLBGKSparse lbgk(new asl::LBGKSparse(block, bed, generateVEConstant(0.01f), &vt));
+		lbgk->init();
+		asl::SPLBGKUtilities lbgkUtil(new asl::LBGKUtilities(lbgk));
+		lbgkUtil->initF(generateVEConstant(.0, .0, .0));
+
+		measure(NMLauncher(lbgk), "LBGKSparse", vtName + " packed bed", "float", lbgk->getNNodes());
 	}
-	else
+}
+
+
+void benchmarkFDAdvectionDiffusion(const asl::VectorTemplate & vt,
+                                   const string & vtName,
+                                   const vector<asl::AVec<int> > & sizes,
+                                   bool marching = false)
+{
+	for (unsigned int i = 0; i < sizes.size(); ++i)
 	{
-		warningMessage("Failed to open " + FILE_NAME + " . Creating new file");
-		keyFile->set_comment("\n Performance test report\n\n");
+		asl::Block block(sizes[i], 1.);
+		auto cField(asl::generateDataContainerACL_SP<float>(block, 1, 1u));
+		asl::initData(cField, 0.5);
+		auto nm(asl::generateFDAdvectionDiffusion(cField, 0.1, &vt));
+		if (marching)
+			nm->setMarching(cField);
+		nm->init();
+
+		measure(NMLauncher(nm), "FDAdvectionDiffusion", vtName + (marching ? " marching" : ""),
+		        "float", productOfElements(sizes[i]));
 	}
+}
 
-	
-	for (unsigned int i = 0; i < hardware.queues.size(); ++i)
+
+/// Temporal blocking with tiles of 16^3 nodes, \p k steps per pass; 
+/// MLUPS are based on the steps, not on the passes. The plain methods
+/// over the same blocks are measured as the reference
+void benchmarkTemporalBlocking(const asl::VectorTemplate & vtLBGK,
+                               const asl::VectorTemplate & vtFD,
+                               const vector<asl::AVec<int> > & sizes)
+{
+	asl::AVec<int> tileSize(asl::makeAVec(16, 16, 16));
+	unsigned int steps[] = {1, 2, 4};
+	for (unsigned int i = 0; i < sizes.size(); ++i)
 	{
-		if (!keyFile->has_group(getDeviceName(hardware.queues[i])))
+		asl::Block block(sizes[i], 1.);
+
+		asl::SPLBGK lbgkPlain(new asl::LBGK(block, generateVEConstant(0.01f), &vtLBGK));
+		lbgkPlain->init();
+		asl::LBGKUtilities(lbgkPlain).initF(generateVEConstant(.0, .0, .0));
+		measure(NMLauncher(lbgkPlain), "LBGK temporal blocking", "plain", "float", 
+		        productOfElements(sizes[i]));
+
+		auto cPlain(asl::generateDataContainerACL_SP<float>(block, 1, 1u));
+		asl::initData(cPlain, 0.5);
+		auto fdPlain(asl::generateFDAdvectionDiffusion(cPlain, 0.1, &vtFD));
+		fdPlain->init();
+		measure(NMLauncher(fdPlain), "FDAdvectionDiffusion temporal blocking", "plain", "float", 
+		        productOfElements(sizes[i]));
+
+		for (unsigned int k : steps)
 		{
-			writeToKeyFile = true;
-			dumpKeyFile = true;
+			string configuration("k=" + asl::numToStr(k));
+
+			asl::SPLBGK lbgk(new asl::LBGK(block, generateVEConstant(0.01f), &vtLBGK));
+			asl::SPLBGKUtilities lbgkUtil(new asl::LBGKUtilities(lbgk));
+			lbgkUtil->initF(generateVEConstant(.0, .0, .0));
+			auto tbLBGK(asl::generateTemporalBlocking(lbgk, k, tileSize, nullptr));
+			tbLBGK->init();
+			measure(NMLauncher(tbLBGK), "LBGK temporal blocking", configuration, "float", 
+			        k * productOfElements(sizes[i]));
+
+			auto cField(asl::generateDataContainerACL_SP<float>(block, 1, 1u));
+			asl::initData(cField, 0.5);
+			auto fd(asl::generateFDAdvectionDiffusion(cField, 0.1, &vtFD));
+			auto tbFD(asl::generateTemporalBlocking(fd, k, tileSize, nullptr));
+			tbFD->init();
+			measure(NMLauncher(tbFD), "FDAdvectionDiffusion temporal blocking", configuration, "float", 
+			        k * productOfElements(sizes[i]));
 		}
-		
-		cout << "\nDevice: " + getDeviceName(hardware.queues[i]) + "\n" << endl;
-		
-		testKernelPerformance<cl_int>(KERNEL_BASIC,
-		                              hardware.queues[i],
-		                              keyFile,
-		                              writeToKeyFile);
-		testKernelPerformance<cl_float>(KERNEL_BASIC,
-		                                hardware.queues[i],
-		                                keyFile,
-		                                writeToKeyFile);
-		if (doublePrecisionSupport(hardware.queues[i]))
-			testKernelPerformance<cl_double>(KERNEL_BASIC,
-			                                 hardware.queues[i],
-			                                 keyFile,
-			                                 writeToKeyFile);
-
-
-		testKernelPerformance<cl_int>(KERNEL_SIMD,
-		                              hardware.queues[i],
-		                              keyFile,
-		                              writeToKeyFile);
-		testKernelPerformance<cl_float>(KERNEL_SIMD,
-		                                hardware.queues[i],
-		                                keyFile,
-		                                writeToKeyFile);
-		if (doublePrecisionSupport(hardware.queues[i]))
-			testKernelPerformance<cl_double>(KERNEL_SIMD,
-			                                 hardware.queues[i],
-			                                 keyFile,
-			                                 writeToKeyFile);
-
-
-		testKernelPerformance<cl_int>(KERNEL_SIMDUA,
-		                              hardware.queues[i],
-		                              keyFile,
-		                              writeToKeyFile);
-		testKernelPerformance<cl_float>(KERNEL_SIMDUA,
-		                                hardware.queues[i],
-		                                keyFile,
-		                                writeToKeyFile);
-		if (doublePrecisionSupport(hardware.queues[i]))
-			testKernelPerformance<cl_double>(KERNEL_SIMDUA,
-			                                 hardware.queues[i],
-			                                 keyFile,
-			                                 writeToKeyFile);
-
-		writeToKeyFile = false;
 	}
+}
+
+
+/// Returns first \p n sizes of \p sizes 
+vector<asl::AVec<int> > firstSizes(const vector<asl::AVec<int> > & sizes, unsigned int n)
+{
+	return vector<asl::AVec<int> >(sizes.begin(), sizes.begin() + min(n, (unsigned int)sizes.size()));
+}
 
-	if (dumpKeyFile)
+
+void writeJSON(const string & fileName)
+{
+	std::ofstream fo(fileName);
+	if (!fo.good())
+		asl::errorMessage("writeJSON() - can not open file: " + fileName);
+
+	fo << "{\n"
+	   << "\t\"platform\": \"" << getPlatformVendor(hardware.defaultQueue) << "\",\n"
+	   << "\t\"device\": \"" << getDeviceName(hardware.defaultQueue) << "\",\n"
+	   << "\t\"driver\": \"" << getDriverVersion(hardware.defaultQueue) << "\",\n"
+	   << "\t\"results\": [\n";
+	for (unsigned int i = 0; i < results.size(); ++i)
 	{
-		ofstream file;
-		file.open(FILE_NAME, ios::app);
-		if (!file.good())
-		{
-			errorMessage("Opening file " + FILE_NAME + " failed");
-		}
-		else
-		{
-			file << keyFile->to_data();
-			if (!file.good())
-				errorMessage("Writing to file " + FILE_NAME + " failed");
-		}
-		file.close();
+		const Result & r(results[i]);
+		fo << "\t\t{\"name\": \"" << r.name << "\""
+		   << ", \"configuration\": \"" << r.configuration << "\""
+		   << ", \"type\": \"" << r.type << "\""
+		   << ", \"size\": " << r.size
+		   << ", \"launches\": " << r.launches
+		   << ", \"time_s\": " << r.time
+		   << ", \"launches_per_s\": " << r.launchesPerSecond()
+		   << ", \"MLUPS\": " << r.mlups()
+		   << ", \"GBps\": " << r.gbps()
+		   << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	fo << "\t]\n}\n";
+}
+
+
+int main(int argc, char* argv[])
+{
+	asl::ApplicationParametersManager appParamsManager("asl-bench", "1.0");
+	asl::Parameter<double> intervalParameter(1., "interval", "minimal measurement time of a case", "s");
+	asl::Parameter<cl_uint> nSizes(1u, "sizes", "number of grid sizes for LBGK and FD cases (1-3)");
+	asl::Parameter<string> output("asl-bench.json", "output", "file for the results in JSON format");
+	appParamsManager.load(argc, argv);
+
+	interval = intervalParameter.v();
+	kernelProfiler.enable();
+
+	cout << "Device: " << getDeviceName(hardware.defaultQueue) << endl;
+	bool doubleSupport(doublePrecisionSupport(hardware.defaultQueue));
+
+	benchmarkOperators<cl_float>(KERNEL_BASIC, "KERNEL_BASIC");
+	benchmarkOperators<cl_float>(KERNEL_SIMD, "KERNEL_SIMD");
+	benchmarkOperators<cl_float>(KERNEL_SIMDUA, "KERNEL_SIMDUA");
+	benchmarkLocal<cl_float>();
+	if (doubleSupport)
+	{
+		benchmarkOperators<cl_double>(KERNEL_BASIC, "KERNEL_BASIC");
+		benchmarkOperators<cl_double>(KERNEL_SIMD, "KERNEL_SIMD");
+		benchmarkOperators<cl_double>(KERNEL_SIMDUA, "KERNEL_SIMDUA");
+		benchmarkLocal<cl_double>();
 	}
 
-	delete keyFile;
-	*/
-	return 0;
+	benchmarkReduction<cl_float>();
+	if (doubleSupport)
+		benchmarkReduction<cl_double>();
+
+	vector<asl::AVec<int> > sizes2D({asl::makeAVec(128, 128),
+	                                 asl::makeAVec(512, 512),
+	                                 asl::makeAVec(1024, 1024)});
+	vector<asl::AVec<int> > sizes3D({asl::makeAVec(32, 32, 32),
+	                                 asl::makeAVec(64, 64, 64),
+	                                 asl::makeAVec(128, 128, 128)});
+	sizes2D = firstSizes(sizes2D, nSizes.v());
+	sizes3D = firstSizes(sizes3D, nSizes.v());
+
+	benchmarkLBGK(asl::d2q9(), "d2q9", sizes2D);
+	benchmarkLBGK(asl::d3q15(), "d3q15", sizes3D);
+	benchmarkLBGK(asl::d3q19(), "d3q19", sizes3D);
+	benchmarkLBGK(asl::d3q19(), "d3q19", sizes3D, true);
+	benchmarkLBGKSparse(asl::d3q19(), "d3q19", sizes3D);
+	benchmarkLBGK(asl::d3q27(), "d3q27", sizes3D);
+
+	benchmarkFDAdvectionDiffusion(asl::d2q5(), "d2q5", sizes2D);
+	benchmarkFDAdvectionDiffusion(asl::d3q7(), "d3q7", sizes3D);
+	benchmarkFDAdvectionDiffusion(asl::d3q7(), "d3q7", sizes3D, true);
+	benchmarkTemporalBlocking(asl::d3q19(), asl::d3q7(), sizes3D);
+
+	writeJSON(output.v());
+	cout << "Results are written to " << output.v() << endl;
+
+	return EXIT_SUCCESS;
 }
@@ -35,6 +35,7 @@
 #include "data/aslDataUtilities.h"
 #include <acl/aclMath/aclVectorOfElements.h>
 #include <data/aslDataWithGhostNodes.h>
+#include <data/aslSlabDecomposition.h>
 
 using namespace acl;
 using namespace asl;
@@ -142,6 +143,55 @@ bool testUploadToLocalMem()
 	return status;
 }
 
+bool testSlabDecomposition()
+{
+	cout << "Test of SlabDecomposition..." << flush;
+
+	Block bl(makeAVec(9, 4, 3), 0.1);
+	vector<CommandQueue> queues({hardware.defaultQueue,
+	                             hardware.createQueue(hardware.defaultQueue),
+	                             hardware.createQueue(hardware.defaultQueue)});
+	auto decomposition(make_shared<SlabDecomposition>(bl, queues));
+	SlabData slabData(decomposition, TYPE_FLOAT, 1, 1);
+	unsigned int layerSize(offset(bl, 1).c2iTransformVector[0]);
+
+	// internal layers of every slab contain the global container index, ghost layers -1
+	for (unsigned int i(0); i < slabData.getNSlabs(); ++i)
+	{
+		unsigned int thickness(decomposition->getSlab(i).getSize()[0]);
+		vector<cl_float> values((thickness + 2) * layerSize, -1);
+		for (unsigned int j(layerSize); j < (thickness + 1) * layerSize; ++j)
+			values[j] = decomposition->getSlabOffset(i) * layerSize + j;
+		copy(values, slabData.getSlab(i)->getEContainer()[0]);
+	}
+
+	slabData.exchangeHalos();
+
+	bool status(true);
+	for (unsigned int i(0); i < slabData.getNSlabs(); ++i)
+	{
+		unsigned int thickness(decomposition->getSlab(i).getSize()[0]);
+		vector<cl_float> values;
+		copy(slabData.getSlab(i)->getEContainer()[0], values);
+		unsigned int first(i == 0 ? layerSize : 0);
+		unsigned int last(i + 1 == slabData.getNSlabs() ? (thickness + 1) * layerSize : 
+		                                                  (thickness + 2) * layerSize);
+		for (unsigned int j(first); j < last; ++j)
+			status &= (values[j] == decomposition->getSlabOffset(i) * layerSize + j);
+	}
+
+	auto global(generateDataContainerACL_SP<float>(bl, 1, 1));
+	slabData.gather(global);
+	vector<cl_float> values;
+	copy(global->getEContainer()[0], values);
+	for (unsigned int j(layerSize); j < values.size() - layerSize; ++j)
+		status &= (values[j] == j);
+
+	errorMessage(status);
+
+	return status;
+}
+
 int main()
 {
 	bool allTestsPassed(true);
@@ -149,6 +199,7 @@ int main()
 	allTestsPassed &= testSimpleKernel();
 	allTestsPassed &= testInitData();
 	allTestsPassed &= testUploadToLocalMem();
+	allTestsPassed &= testSlabDecomposition();
 		
 	return allTestsPassed ? EXIT_SUCCESS : EXIT_FAILURE;
 }
\ No newline at end of file
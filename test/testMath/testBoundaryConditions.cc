@@ -0,0 +1,163 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+/**
+	\example testBoundaryConditions.cc
+ */
+
+#include "aslGenerators.h"
+#include "aslGeomInc.h"
+#include "data/aslDataWithGhostNodes.h"
+#include "num/aslBasicBC.h"
+#include "acl/acl.h"
+#include "acl/aclGenerators.h"
+#include "acl/DataTypes/aclMemBlock.h"
+#include "acl/aclMath/aclVectorOfElements.h"
+#include "acl/Kernels/aclKernelFusion.h"
+#include "aslUtilities.h"
+
+using asl::AVec;
+using asl::makeAVec;
+
+
+/// number of the points where the map of BCConstantValueMap selects the kernel
+unsigned int countMapPoints(asl::SPDataWithGhostNodesACLData map)
+{
+	vector<float> m;
+	acl::copy(map->getEContainer()[0], m);
+	unsigned int n(0);
+	for (unsigned int i(0); i < m.size(); ++i)
+		if (m[i] <= 0 && m[i] > -.9999)
+			++n;
+	return n;
+}
+
+
+bool testBCConstantValueMapPointsList()
+{
+	cout << "Test of BCConstantValueMap over the points list..." << flush;
+
+	asl::Block block(makeAVec(20, 20), 1.);
+	auto map(asl::generateDataContainerACL_SP<float>(block, 1, 1u));
+	auto dFull(asl::generateDataContainerACL_SP<float>(block, 1, 1u));
+	auto dList(asl::generateDataContainerACL_SP<float>(block, 1, 1u));
+	asl::initData(map, asl::generateDFSphere(5., makeAVec(10., 10.)));
+	acl::initData(dFull->getEContainer(), acl::generateVEConstant(0.f));
+	acl::initData(dList->getEContainer(), acl::generateVEConstant(0.f));
+
+	auto bcFull(make_shared<asl::BCConstantValueMap>(dFull, acl::generateVEConstant(1.f), map));
+	auto bcList(make_shared<asl::BCConstantValueMap>(dList, acl::generateVEConstant(1.f), map));
+	bcList->setPointsList();
+	bcFull->init();
+	bcList->init();
+	bcFull->execute();
+	bcList->execute();
+
+	vector<float> hFull, hList;
+	acl::copy(dFull->getEContainer()[0], hFull);
+	acl::copy(dList->getEContainer()[0], hList);
+	bool status(hFull == hList && 
+	            bcList->getNPoints() > 0 &&
+	            bcList->getNPoints() == countMapPoints(map));
+
+	// the list follows the rewritten map
+	unsigned int nPointsOld(bcList->getNPoints());
+	asl::initData(map, asl::generateDFSphere(7., makeAVec(9., 11.)));
+	acl::initData(dFull->getEContainer(), acl::generateVEConstant(0.f));
+	acl::initData(dList->getEContainer(), acl::generateVEConstant(0.f));
+	bcFull->execute();
+	bcList->execute();
+
+	acl::copy(dFull->getEContainer()[0], hFull);
+	acl::copy(dList->getEContainer()[0], hList);
+	status &= hFull == hList &&
+	          bcList->getNPoints() != nPointsOld &&
+	          bcList->getNPoints() == countMapPoints(map);
+
+	// the host writes through a mapping are detected as well
+	{
+		shared_ptr<float> m(acl::map<float>(map->getDContainer()[0]));
+		unsigned int n(map->getDContainer()[0]->getSize());
+		for (unsigned int i(0); i < n; ++i)
+			m.get()[i] = 1.;
+	}
+	bcList->execute();
+	status &= bcList->getNPoints() == 0 && countMapPoints(map) == 0;
+
+	asl::errorMessage(status);
+
+	return status;
+}
+
+
+bool testBCConstantValueMapFusion()
+{
+	cout << "Test of the fusion of BCConstantValueMap with different maps..." << flush;
+
+	asl::Block block(makeAVec(20, 20), 1.);
+	auto mapA(asl::generateDataContainerACL_SP<float>(block, 1, 1u));
+	auto mapB(asl::generateDataContainerACL_SP<float>(block, 1, 1u));
+	asl::initData(mapA, asl::generateDFSphere(5., makeAVec(8., 10.)));
+	asl::initData(mapB, asl::generateDFSphere(6., makeAVec(12., 9.)));
+
+	// the first pair is executed sequentially, the second one is fused
+	vector<asl::SPDataWithGhostNodesACLData> d(4);
+	vector<shared_ptr<asl::BCConstantValueMap> > bc(4);
+	for (unsigned int i(0); i < 4; ++i)
+	{
+		d[i] = asl::generateDataContainerACL_SP<float>(block, 1, 1u);
+		acl::initData(d[i]->getEContainer(), acl::generateVEConstant(0.f));
+		bc[i] = make_shared<asl::BCConstantValueMap>(d[i], 
+		                                             acl::generateVEConstant(1.f + i % 2), 
+		                                             i % 2 ? mapB : mapA);
+		bc[i]->init();
+	}
+	bc[0]->execute();
+	bc[1]->execute();
+
+	acl::KernelFusion kf;
+	kf.addKernel(bc[2]->kernel);
+	kf.addKernel(bc[3]->kernel);
+	kf.setup();
+	kf.compute();
+
+	vector<vector<float> > h(4);
+	for (unsigned int i(0); i < 4; ++i)
+		acl::copy(d[i]->getEContainer()[0], h[i]);
+	bool status(h[0] == h[2] && h[1] == h[3]);
+
+	asl::errorMessage(status);
+
+	return status;
+}
+
+
+int main()
+{
+	bool allTestsPassed(true);
+
+	allTestsPassed &= testBCConstantValueMapPointsList();
+	allTestsPassed &= testBCConstantValueMapFusion();
+
+	return allTestsPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
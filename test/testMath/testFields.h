@@ -0,0 +1,93 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+/// \file testFields.h
+/// Comparison of fields shared by the tests of the numerical methods
+
+#ifndef TESTFIELDS_H
+#define TESTFIELDS_H
+
+#include "data/aslDataWithGhostNodes.h"
+#include "acl/acl.h"
+#include "acl/DataTypes/aclMemBlock.h"
+#include "acl/aclGenerators.h"
+#include "acl/aclMath/aclVectorOfElements.h"
+#include "aslUtilities.h"
+#include "math/aslVectors.h"
+#include <cmath>
+
+typedef float FlT;
+
+
+/// downloads the components of \p d 
+inline vector<vector<FlT> > download(asl::SPAbstractDataWithGhostNodes d)
+{
+	acl::VectorOfElements e(d->getEContainer());
+	// the elements can be views of a larger buffer, they are copied first
+	acl::VectorOfElementsData buffer(acl::generateVEData<FlT>(e[0]->getSize(), e.size()));
+	acl::initData(buffer, e);
+	vector<vector<FlT> > res(e.size());
+	for (unsigned int i(0); i < e.size(); ++i)
+		acl::copy(*buffer[i], res[i]);
+	return res;
+}
+
+
+/// positions of the internal nodes of \p d in its containers
+inline vector<unsigned int> internalNodes(asl::SPAbstractDataWithGhostNodes d)
+{
+	const asl::Block & block(d->getBlock());
+	asl::AVec<int> size(d->getInternalBlock().getSize());
+	asl::AVec<int> ghosts((block.getSize() - size) / 2);
+	unsigned int n(productOfElements(size));
+	vector<unsigned int> res(n);
+	for (unsigned int k(0); k < n; ++k)
+	{
+		asl::AVec<int> p(ghosts);
+		unsigned int r(k);
+		for (unsigned int i(0); i < size.getSize(); ++i)
+		{
+			p[i] += r % size[i];
+			r /= size[i];
+		}
+		res[k] = block.c2i(p);
+	}
+	return res;
+}
+
+
+/// maximal difference of \p a and \p b over the \p nodes
+inline double maxDifference(asl::SPAbstractDataWithGhostNodes a, 
+                     asl::SPAbstractDataWithGhostNodes b,
+                     const vector<unsigned int> & nodes)
+{
+	vector<vector<FlT> > hA(download(a));
+	vector<vector<FlT> > hB(download(b));
+	double res(0);
+	for (unsigned int i(0); i < hA.size(); ++i)
+		for (unsigned int k(0); k < nodes.size(); ++k)
+			res = max(res, (double)fabs(hA[i][nodes[k]] - hB[i][nodes[k]]));
+	return res;
+}
+
+#endif // TESTFIELDS_H
@@ -0,0 +1,393 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+/**
+	\example testLBGK.cc
+ */
+
+#include "aslGenerators.h"
+#include "aslGeomInc.h"
+#include "data/aslDataWithGhostNodes.h"
+#include "math/aslTemplates.h"
+#include "num/aslLBGK.h"
+#include "num/aslLBGKBC.h"
+#include "num/aslLBGKSparse.h"
+#include "num/aslLBGKMultiBlock.h"
+#include "acl/acl.h"
+#include "acl/aclGenerators.h"
+#include "acl/aclMath/aclVectorOfElements.h"
+#include "aslUtilities.h"
+#include "testFields.h"
+
+using asl::AVec;
+using asl::makeAVec;
+
+
+/// maximal deviation of \p d from \p value over the \p nodes
+double maxDeviation(asl::SPAbstractDataWithGhostNodes d, 
+                    const vector<FlT> & value,
+                    const vector<unsigned int> & nodes)
+{
+	vector<vector<FlT> > h(download(d));
+	double res(0);
+	for (unsigned int i(0); i < h.size(); ++i)
+		for (unsigned int k(0); k < nodes.size(); ++k)
+			res = max(res, (double)fabs(h[i][nodes[k]] - value[i]));
+	return res;
+}
+
+
+bool testInPlaceStreaming()
+{
+	cout << "Test of LBGK with the in-place streaming..." << flush;
+
+	asl::Block block(makeAVec(16, 12), 1.);
+	vector<asl::SPLBGK> lbgk(2);
+	vector<asl::SPNumMethod> bc(2);
+	for (unsigned int i(0); i < 2; ++i)
+	{
+		lbgk[i].reset(new asl::LBGK(block, 
+		                            acl::generateVEConstant(FlT(.05)), 
+		                            &asl::d2q9()));
+		lbgk[i]->setInPlaceStreaming(i == 1);
+		lbgk[i]->init();
+		asl::LBGKUtilities(lbgk[i]).initF(acl::generateVEConstant(FlT(1.)),
+		                                  acl::generateVEConstant(FlT(.05), FlT(.02)));
+		bc[i] = asl::generateBCNoSlip(lbgk[i], {asl::X0, asl::XE, asl::Y0, asl::YE});
+		bc[i]->init();
+	}
+
+	vector<unsigned int> nodes(internalNodes(lbgk[0]->getRho()));
+	bool status(true);
+	// the in-place scheme alternates between two layouts, both are compared
+	for (unsigned int n(1); n <= 8; ++n)
+	{
+		for (unsigned int i(0); i < 2; ++i)
+		{
+			lbgk[i]->execute();
+			bc[i]->execute();
+		}
+		if (n == 7 || n == 8)
+			status &= maxDifference(lbgk[0]->getF(), lbgk[1]->getF(), nodes) < 1e-6 &&
+			          maxDifference(lbgk[0]->getRho(), lbgk[1]->getRho(), nodes) < 1e-6 &&
+			          maxDifference(lbgk[0]->getVelocity(), lbgk[1]->getVelocity(), nodes) < 1e-6;
+	}
+
+	asl::errorMessage(status);
+
+	return status;
+}
+
+
+bool testHalfPrecisionStorage()
+{
+	cout << "Test of LBGK with the half precision storage against the single precision..." << flush;
+
+	asl::Block block(makeAVec(16, 12), 1.);
+	vector<asl::SPLBGK> lbgk(2);
+	vector<asl::SPNumMethod> bc(2);
+	for (unsigned int i(0); i < 2; ++i)
+	{
+		lbgk[i].reset(new asl::LBGK(block, 
+		                            acl::generateVEConstant(FlT(.05)), 
+		                            &asl::d2q9()));
+		lbgk[i]->setHalfPrecisionStorage(i == 1);
+		lbgk[i]->init();
+		asl::LBGKUtilities(lbgk[i]).initF(acl::generateVEConstant(FlT(1.)),
+		                                  acl::generateVEConstant(FlT(.05), FlT(.02)));
+		bc[i] = asl::generateBCNoSlip(lbgk[i], {asl::X0, asl::XE, asl::Y0, asl::YE});
+		bc[i]->init();
+	}
+
+	for (unsigned int n(0); n < 50; ++n)
+		for (unsigned int i(0); i < 2; ++i)
+		{
+			lbgk[i]->execute();
+			bc[i]->execute();
+		}
+
+	// the rounding of the stored values does not accumulate: 
+	// the deviations stay at a few units of the half precision
+	vector<unsigned int> nodes(internalNodes(lbgk[0]->getRho()));
+	bool status(maxDifference(lbgk[0]->getRho(), lbgk[1]->getRho(), nodes) < 1e-3 &&
+	            maxDifference(lbgk[0]->getVelocity(), lbgk[1]->getVelocity(), nodes) < 5e-4);
+
+	asl::errorMessage(status);
+
+	return status;
+}
+
+
+bool testSparse()
+{
+	cout << "Test of LBGKSparse against LBGK with BCNoSlipMap..." << flush;
+
+	asl::Block block(makeAVec(24, 12), 1.);
+	auto map(asl::generateDataContainerACL_SP<FlT>(block, 1, 1u));
+	// closed channel with a circular obstacle, the ghost nodes are solid
+	const asl::Block & full(map->getBlock());
+	vector<FlT> mapH(productOfElements(full.getSize()), -.5);
+	vector<unsigned int> fluid;
+	for (int x(1); x <= 24; ++x)
+		for (int y(1); y <= 12; ++y)
+			if ((x - 8) * (x - 8) + (y - 6) * (y - 6) > 6)
+			{
+				unsigned int k(full.c2i(makeAVec(x, y)));
+				mapH[k] = 1.;
+				fluid.push_back(k);
+			}
+	acl::copy(mapH, map->getEContainer()[0]);
+
+	auto nu(acl::generateVEConstant(FlT(.05)));
+	auto rho0(acl::generateVEConstant(FlT(1.)));
+	auto v0(acl::generateVEConstant(FlT(.05), FlT(.02)));
+
+	asl::SPLBGK dense(new asl::LBGK(block, nu, &asl::d2q9()));
+	dense->init();
+	asl::LBGKUtilities(dense).initF(rho0, v0);
+	auto bc(asl::generateBCNoSlip(dense, map));
+	bc->init();
+	// the solid nodes take the bounce-back values before the first step
+	bc->execute();
+
+	asl::SPLBGKSparse sparse(new asl::LBGKSparse(map, nu, &asl::d2q9()));
+	sparse->init();
+	asl::LBGKUtilities(sparse).initF(rho0, v0);
+
+	for (unsigned int n(0); n < 10; ++n)
+	{
+		dense->execute();
+		bc->execute();
+		sparse->execute();
+	}
+
+	bool status(sparse->getNNodes() == fluid.size() &&
+	            maxDifference(dense->getRho(), sparse->getRho(), fluid) < 1e-5 &&
+	            maxDifference(dense->getVelocity(), sparse->getVelocity(), fluid) < 1e-5);
+
+	asl::errorMessage(status);
+
+	return status;
+}
+
+
+bool testSparsePoiseuille()
+{
+	cout << "Test of LBGKSparse with a force driven periodic channel..." << flush;
+
+	asl::Block block(makeAVec(4, 16), 1.);
+	auto map(asl::generateDataContainerACL_SP<FlT>(block, 1, 1u));
+	acl::initData(map->getEContainer(), acl::generateVEConstant(FlT(1.)));
+
+	double nu(.1);
+	double force(1e-4);
+	asl::SPLBGKSparse sparse(new asl::LBGKSparse(map, 
+	                                             acl::generateVEConstant(FlT(nu)), 
+	                                             &asl::d2q9()));
+	sparse->setPeriodic(0);
+	sparse->setForce(acl::generateVEConstant(FlT(force), FlT(0.)));
+	sparse->init();
+	asl::LBGKUtilities(sparse).initF(acl::generateVEConstant(FlT(1.)),
+	                                 acl::generateVEConstant(FlT(0.), FlT(0.)));
+
+	for (unsigned int n(0); n < 3000; ++n)
+		sparse->execute();
+
+	// the walls of the halfway bounce-back lie half a cell behind the border nodes
+	vector<vector<FlT> > v(download(sparse->getVelocity()));
+	const asl::Block & full(sparse->getVelocity()->getBlock());
+	double vMax(force / (8. * nu) * 16. * 16.);
+	double deviation(0);
+	for (int x(1); x <= 4; ++x)
+		for (int y(1); y <= 16; ++y)
+		{
+			unsigned int k(full.c2i(makeAVec(x, y)));
+			double vExact(force / (2. * nu) * (y - .5) * (16.5 - y));
+			deviation = max(deviation, max(fabs(v[0][k] - vExact), (double)fabs(v[1][k])));
+		}
+
+	bool status(deviation < .01 * vMax);
+
+	asl::errorMessage(status);
+
+	return status;
+}
+
+
+bool testMultiBlockUniformFlow()
+{
+	cout << "Test of LBGKMultiBlock with a uniform flow..." << flush;
+
+	asl::Block block(makeAVec(32, 32), 1.);
+	asl::SPLBGKMultiBlock lbgk(new asl::LBGKMultiBlock(block,
+	                                                   acl::generateVEConstant(FlT(.05)),
+	                                                   &asl::d2q9()));
+	unsigned int iFine(lbgk->addRefinementBox(makeAVec(12, 12), makeAVec(19, 19)));
+	lbgk->init();
+
+	vector<FlT> rho0(1, 1.);
+	vector<FlT> v0({.05, .02});
+	asl::SPLBGK coarse(lbgk->getCoarse());
+	asl::SPLBGK fine(lbgk->getFine(iFine));
+	asl::LBGKUtilities(coarse).initF(acl::generateVEConstant(rho0), acl::generateVEConstant(v0));
+	asl::LBGKUtilities(fine).initF(acl::generateVEConstant(rho0), acl::generateVEConstant(v0));
+
+	unsigned int nSteps(4);
+	for (unsigned int n(0); n < nSteps; ++n)
+		lbgk->execute();
+
+	// the borders of the coarse block have no boundary conditions, 
+	// their perturbation travels one coarse cell per step
+	const asl::Block & full(coarse->getRho()->getBlock());
+	vector<unsigned int> coarseNodes;
+	for (int x(nSteps + 2); x < 32 - (int)nSteps; ++x)
+		for (int y(nSteps + 2); y < 32 - (int)nSteps; ++y)
+			coarseNodes.push_back(full.c2i(makeAVec(x, y)));
+	vector<unsigned int> fineNodes(internalNodes(fine->getRho()));
+
+	bool status(maxDeviation(coarse->getRho(), rho0, coarseNodes) < 1e-5 &&
+	            maxDeviation(coarse->getVelocity(), v0, coarseNodes) < 1e-5 &&
+	            maxDeviation(fine->getRho(), rho0, fineNodes) < 1e-5 &&
+	            maxDeviation(fine->getVelocity(), v0, fineNodes) < 1e-5);
+
+	asl::errorMessage(status);
+
+	return status;
+}
+
+
+/// initializes \p lbgk with the shear wave \f$ u = (0.1, 0.05 \sin(2\pi (x + 0.5) / 32)) \f$
+void initShearWave(asl::SPLBGK lbgk)
+{
+	const asl::Block & block(lbgk->getVelocity()->getBlock());
+	unsigned int length(productOfElements(block.getSize()));
+	vector<FlT> vx(length, .1);
+	vector<FlT> vy(length);
+	for (int x(0); x < block.getSize()[0]; ++x)
+		for (int y(0); y < block.getSize()[1]; ++y)
+			vy[block.c2i(makeAVec(x, y))] = 
+				.05 * sin(2. * asl::pi * (block.position[0] + block.dx * x + .5) / 32.);
+	acl::copy(vx, lbgk->getVelocity()->getEContainer()[0]);
+	acl::copy(vy, lbgk->getVelocity()->getEContainer()[1]);
+	asl::LBGKUtilities(lbgk).initF(acl::generateVEConstant(FlT(1.)), 
+	                               lbgk->getVelocity()->getEContainer());
+}
+
+
+bool testMultiBlockShearWave()
+{
+	cout << "Test of LBGKMultiBlock with a shear wave against a uniform fine block..." << flush;
+
+	asl::Block block(makeAVec(32, 32), 1.);
+	asl::SPLBGKMultiBlock lbgk(new asl::LBGKMultiBlock(block,
+	                                                   acl::generateVEConstant(FlT(.05)),
+	                                                   &asl::d2q9()));
+	AVec<int> a0(makeAVec(12, 12));
+	AVec<int> aE(makeAVec(19, 19));
+	unsigned int iFine(lbgk->addRefinementBox(a0, aE));
+	lbgk->init();
+	asl::SPLBGK coarse(lbgk->getCoarse());
+	asl::SPLBGK fine(lbgk->getFine(iFine));
+	initShearWave(coarse);
+	initShearWave(fine);
+
+	// the nodes of the refined block coincide with the ones of the uniform fine block
+	asl::SPLBGK reference(new asl::LBGK(asl::Block(makeAVec(64, 64), .5, makeAVec(-.25, -.25)),
+	                                    acl::generateVEConstant(FlT(.1)),
+	                                    &asl::d2q9()));
+	reference->init();
+	initShearWave(reference);
+
+	// the wave is carried through the refined block: the non-equilibrium parts 
+	// are rescaled at the interface, the ghost values vary in time
+	unsigned int nSteps(6);
+	for (unsigned int n(0); n < nSteps; ++n)
+	{
+		lbgk->execute();
+		reference->execute();
+		reference->execute();
+	}
+
+	vector<vector<FlT> > vC(download(coarse->getVelocity()));
+	vector<vector<FlT> > vF(download(fine->getVelocity()));
+	vector<vector<FlT> > rhoF(download(fine->getRho()));
+	vector<vector<FlT> > vR(download(reference->getVelocity()));
+	vector<vector<FlT> > rhoR(download(reference->getRho()));
+	const asl::Block & blockC(coarse->getVelocity()->getBlock());
+	const asl::Block & blockF(fine->getVelocity()->getBlock());
+	const asl::Block & blockR(reference->getVelocity()->getBlock());
+
+	// the internal node e - 1 of the refined block is the node 2 a0 + e - 1 of the uniform one
+	double dvFine(0);
+	double drhoFine(0);
+	for (int x(1); x < blockF.getSize()[0] - 1; ++x)
+		for (int y(1); y < blockF.getSize()[1] - 1; ++y)
+		{
+			unsigned int k(blockF.c2i(makeAVec(x, y)));
+			unsigned int kR(blockR.c2i(2 * a0 + makeAVec(x, y)));
+			for (unsigned int i(0); i < 2; ++i)
+				dvFine = max(dvFine, (double)fabs(vF[i][k] - vR[i][kR]));
+			drhoFine = max(drhoFine, (double)fabs(rhoF[0][k] - rhoR[0][kR]));
+		}
+
+	// the coarse nodes around the refined block against the average of their fine children
+	double dvCoarse(0);
+	for (int x(a0[0] - 3); x <= aE[0] + 3; ++x)
+		for (int y(a0[1] - 3); y <= aE[1] + 3; ++y)
+		{
+			if (x >= a0[0] && x <= aE[0] && y >= a0[1] && y <= aE[1])
+				continue;
+			unsigned int k(blockC.c2i(makeAVec(x + 1, y + 1)));
+			for (unsigned int i(0); i < 2; ++i)
+			{
+				double average(0);
+				for (int dx(1); dx <= 2; ++dx)
+					for (int dy(1); dy <= 2; ++dy)
+						average += .25 * vR[i][blockR.c2i(makeAVec(2 * x + dx, 2 * y + dy))];
+				dvCoarse = max(dvCoarse, fabs(vC[i][k] - average));
+			}
+		}
+
+	// the bounds lie between the error of the linear interpolation in space and 
+	// the deviations caused by a missing rescaling or time interpolation
+	bool status(dvFine < 5e-4 && drhoFine < 2.5e-4 && dvCoarse < 5e-4);
+
+	asl::errorMessage(status);
+
+	return status;
+}
+
+
+int main()
+{
+	bool allTestsPassed(true);
+
+	allTestsPassed &= testInPlaceStreaming();
+	allTestsPassed &= testHalfPrecisionStorage();
+	allTestsPassed &= testSparse();
+	allTestsPassed &= testSparsePoiseuille();
+	allTestsPassed &= testMultiBlockUniformFlow();
+	allTestsPassed &= testMultiBlockShearWave();
+
+	return allTestsPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
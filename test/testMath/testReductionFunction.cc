@@ -25,6 +25,7 @@
 	\example testReductionFunction.cc
  */
 
+#include "acl/acl.h"
 #include "acl/Kernels/aclKernel.h"
 #include "acl/aclUtilities.h"
 #include "acl/aclMath/aclReductionAlgGenerator.h"
@@ -119,6 +120,34 @@ bool testProduct()
 }
 
 
+bool testSumMinMax()
+{
+	cout << "testSumMinMax..." << flush;
+	VectorOfElements vI(generateVEIndex());
+	VectorOfElements v1(generateVEData<float>(1001u,1u));
+	initData(v1, generateVEConstant(2));
+	auto alg(generateSumMinMaxAlg<float>(v1*vI));
+	alg->generateAlg();
+	alg->computeAsync();
+	alg->requestResult();
+
+	// the maximum feeds another kernel without a host round-trip
+	VectorOfElementsData v2(generateVEData<float>(10u,1u));
+	initData(v2, subVE(excerpt(alg->getResultACL(), generateVEConstant(0)), 2) + 1);
+	vector<float> output;
+	copy(*v2[0], output);
+
+	const asl::AVec<float> & res(alg->getResult());
+	bool status(asl::approxEqual(res[0], 1001000.f) && 
+	            res[1] == 0 && 
+	            res[2] == 2000 &&
+	            output[9] == 2001);
+	asl::errorMessage(status);
+
+	return status;
+}
+
+
 int main()
 {
 	bool allTestsPassed(true);
@@ -128,6 +157,7 @@ int main()
 	allTestsPassed &= testMin();
 	allTestsPassed &= testMax();
 	allTestsPassed &= testProduct();
+	allTestsPassed &= testSumMinMax();
 
 	return allTestsPassed ? EXIT_SUCCESS : EXIT_FAILURE;
 }
\ No newline at end of file
@@ -0,0 +1,171 @@
+/*
+ * Advanced Simulation Library <http://asl.org.il>
+ * 
+ * Copyright 2015 Avtech Scientific <http://avtechscientific.com>
+ *
+ *
+ * This file is part of Advanced Simulation Library (ASL).
+ *
+ * ASL is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, version 3 of the License.
+ *
+ * ASL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ASL. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+/**
+	\example testTemporalBlocking.cc
+ */
+
+#include "aslGenerators.h"
+#include "data/aslDataWithGhostNodes.h"
+#include "math/aslTemplates.h"
+#include "num/aslLBGK.h"
+#include "num/aslLBGKBC.h"
+#include "num/aslFDAdvectionDiffusion.h"
+#include "num/aslBasicBC.h"
+#include "num/aslTemporalBlocking.h"
+#include "acl/acl.h"
+#include "acl/aclGenerators.h"
+#include "acl/aclMath/aclVectorOfElements.h"
+#include "aslUtilities.h"
+#include "testFields.h"
+
+using asl::AVec;
+using asl::makeAVec;
+
+
+/// fills \p d with a smooth nonuniform field
+void initField(asl::SPDataWithGhostNodesACLData d)
+{
+	const asl::Block & block(d->getBlock());
+	vector<FlT> h(productOfElements(block.getSize()));
+	for (int x(0); x < block.getSize()[0]; ++x)
+		for (int y(0); y < block.getSize()[1]; ++y)
+			h[block.c2i(makeAVec(x, y))] = .5 + .4 * sin(.7 * x) * cos(.5 * y);
+	acl::copy(h, d->getEContainer()[0]);
+}
+
+
+bool testFDAdvectionDiffusion()
+{
+	cout << "Test of TemporalBlocking of FDAdvectionDiffusion..." << flush;
+
+	// the block is not a multiple of the tile size
+	asl::Block block(makeAVec(20, 14), 1.);
+	vector<asl::SlicesNames> sides({asl::X0, asl::XE, asl::Y0, asl::YE});
+	asl::TileBCGenerator<asl::FDAdvectionDiffusion> 
+		bcGenerator([](asl::SPFDAdvectionDiffusion nm, 
+		               const vector<asl::SlicesNames> & sl)
+		{
+			return vector<asl::SPNumMethod>({asl::generateBCConstantValue(nm->getData()[0], .5, sl)});
+		});
+
+	bool status(true);
+	unsigned int steps[] = {2, 4};
+	for (unsigned int k : steps)
+	{
+		auto cRef(asl::generateDataContainerACL_SP<FlT>(block, 1, 1u));
+		initField(cRef);
+		auto fdRef(asl::generateFDAdvectionDiffusion(cRef, .1, &asl::d2q5()));
+		fdRef->init();
+		auto bcRef(asl::generateBCConstantValue(cRef, .5, sides));
+		bcRef->init();
+
+		auto c(asl::generateDataContainerACL_SP<FlT>(block, 1, 1u));
+		initField(c);
+		auto fd(asl::generateFDAdvectionDiffusion(c, .1, &asl::d2q5()));
+		auto tb(asl::generateTemporalBlocking(fd, k, makeAVec(8, 8), bcGenerator));
+		tb->init();
+
+		unsigned int nPasses(2);
+		for (unsigned int n(0); n < nPasses; ++n)
+		{
+			tb->execute();
+			for (unsigned int j(0); j < k; ++j)
+			{
+				fdRef->execute();
+				bcRef->execute();
+			}
+		}
+
+		status &= maxDifference(cRef, c, internalNodes(c)) < 1e-5;
+	}
+
+	asl::errorMessage(status);
+
+	return status;
+}
+
+
+bool testLBGK()
+{
+	cout << "Test of TemporalBlocking of LBGK..." << flush;
+
+	asl::Block block(makeAVec(20, 14), 1.);
+	vector<asl::SlicesNames> sides({asl::X0, asl::XE, asl::Y0, asl::YE});
+	auto nu(acl::generateVEConstant(FlT(.05)));
+	auto rho0(acl::generateVEConstant(FlT(1.)));
+	auto v0(acl::generateVEConstant(FlT(.05), FlT(.02)));
+	asl::TileBCGenerator<asl::LBGK> 
+		bcGenerator([](asl::SPLBGK nm, const vector<asl::SlicesNames> & sl)
+		{
+			return vector<asl::SPNumMethod>({asl::generateBCNoSlip(nm, sl)});
+		});
+
+	bool status(true);
+	unsigned int steps[] = {2, 4};
+	for (unsigned int k : steps)
+	{
+		asl::SPLBGK lbgkRef(new asl::LBGK(block, nu, &asl::d2q9()));
+		lbgkRef->init();
+		asl::LBGKUtilities(lbgkRef).initF(rho0, v0);
+		auto bcRef(asl::generateBCNoSlip(lbgkRef, sides));
+		bcRef->init();
+
+		asl::SPLBGK lbgk(new asl::LBGK(block, nu, &asl::d2q9()));
+		lbgk->init();
+		asl::LBGKUtilities(lbgk).initF(rho0, v0);
+		auto tb(asl::generateTemporalBlocking(lbgk, k, makeAVec(8, 8), bcGenerator));
+		tb->init();
+
+		unsigned int nPasses(2);
+		for (unsigned int n(0); n < nPasses; ++n)
+		{
+			tb->execute();
+			for (unsigned int j(0); j < k; ++j)
+			{
+				lbgkRef->execute();
+				bcRef->execute();
+			}
+		}
+
+		vector<unsigned int> nodes(internalNodes(lbgk->getRho()));
+		status &= maxDifference(lbgkRef->getF(), lbgk->getF(), nodes) < 1e-5 &&
+		          maxDifference(lbgkRef->getRho(), lbgk->getRho(), nodes) < 1e-5 &&
+		          maxDifference(lbgkRef->getVelocity(), lbgk->getVelocity(), nodes) < 1e-5;
+	}
+
+	asl::errorMessage(status);
+
+	return status;
+}
+
+
+int main()
+{
+	bool allTestsPassed(true);
+
+	allTestsPassed &= testFDAdvectionDiffusion();
+	allTestsPassed &= testLBGK();
+
+	return allTestsPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}